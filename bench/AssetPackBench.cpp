@@ -0,0 +1,181 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+#include <UBytes/AppPlatform/WebView/AssetServer.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t LOOKUPS = 1024;
+
+using AssetMap = std::unordered_map<std::string, Asset>;
+
+/// The build output of a single-page application: code-split chunks and their source maps,
+/// styles, images and fonts, about 2000 files of a few hundred bytes to a few hundred KiB.
+struct Pack
+{
+  std::vector<std::string> paths;
+  std::vector<std::byte>   bytes;
+  AssetPack                pack;
+
+  Pack()
+  {
+    paths.emplace_back("index.html");
+    paths.emplace_back("favicon.ico");
+    paths.emplace_back("manifest.json");
+    for (std::size_t i = 0; i < 600; ++i) {
+      auto const hash = std::to_string(1000003 * i % 0xFFFFFF);
+      paths.push_back("assets/js/chunk-" + hash + ".js");
+      paths.push_back("assets/js/chunk-" + hash + ".js.map");
+    }
+    for (std::size_t i = 0; i < 200; ++i) {
+      paths.push_back("assets/css/view-" + std::to_string(i) + ".css");
+    }
+    for (std::size_t i = 0; i < 500; ++i) {
+      paths.push_back("assets/images/icons/file-type-" + std::to_string(i) + ".svg");
+    }
+    for (std::size_t i = 0; i < 50; ++i) {
+      paths.push_back("assets/fonts/inter-" + std::to_string(i) + ".woff2");
+    }
+
+    auto builder = AssetPackBuilder();
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      builder.add(paths[i], std::string(256 + 7919 * i % (256 * 1024), 'x'));
+    }
+    bytes = builder.build();
+    pack  = AssetPack::from_memory(bytes);
+  }
+};
+
+/// The paths of a page load, in a shuffled order, with a leading slash like the request URLs.
+auto request_paths(Pack const& pack, bool hit) -> std::vector<std::string>
+{
+  auto paths = std::vector<std::string>();
+  for (std::size_t i = 0; i < LOOKUPS; ++i) {
+    auto path = "/" + pack.paths[2654435761u * i % pack.paths.size()];
+    if (!hit) {
+      path += ".gz";
+    }
+    paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
+auto find(Context& context, bool hit) -> void
+{
+  auto const pack  = Pack();
+  auto const paths = request_paths(pack, hit);
+  auto       sum   = std::size_t(0);
+  context.measure(
+    LOOKUPS,
+    [&]
+    {
+      for (auto const& path : paths) {
+        if (auto const asset = pack.pack.find(path)) {
+          sum += asset->data.size();
+        }
+      }
+    }
+  );
+  do_not_optimize(sum);
+  context.add_metric("assets", static_cast<double>(pack.pack.size()));
+}
+
+/// The baseline: the assets indexed by path in a map, the leading slash stripped by a copy.
+auto find_in_map(Context& context, bool hit) -> void
+{
+  auto const pack  = Pack();
+  auto const paths = request_paths(pack, hit);
+  auto       map   = AssetMap();
+  for (std::size_t i = 0; i < pack.pack.size(); ++i) {
+    auto const asset = pack.pack.at(i);
+    map.emplace(std::string(asset.path), asset);
+  }
+  auto sum = std::size_t(0);
+  context.measure(
+    LOOKUPS,
+    [&]
+    {
+      for (auto const& path : paths) {
+        auto const it = map.find(path.substr(1));
+        if (it != map.end()) {
+          sum += it->second.data.size();
+        }
+      }
+    }
+  );
+  do_not_optimize(sum);
+}
+
+/// `AssetPack::find`: the binary search on the path hashes of the directory.
+UBYTES_BENCH(
+  "asset_pack/find/hit",
+  [](Context& context)
+  {
+    find(context, true);
+  }
+);
+
+UBYTES_BENCH(
+  "asset_pack/find/miss",
+  [](Context& context)
+  {
+    find(context, false);
+  }
+);
+
+UBYTES_BENCH(
+  "asset_pack/find/unordered_map",
+  [](Context& context)
+  {
+    find_in_map(context, true);
+  }
+);
+
+/// `AssetServer::resolve` over the pack, revalidations answered with a `304`.
+UBYTES_BENCH(
+  "asset_server/resolve/not_modified",
+  [](Context& context)
+  {
+    auto const pack   = Pack();
+    auto const paths  = request_paths(pack, true);
+    auto       server = AssetServer();
+    server.add_pack(pack.pack);
+
+    auto urls  = std::vector<std::string>();
+    auto etags = std::vector<std::string>();
+    for (auto const& path : paths) {
+      urls.push_back("https://app.local" + path);
+      etags.emplace_back(pack.pack.find(path)->etag);
+    }
+
+    auto sum = std::size_t(0);
+    context.measure(
+      LOOKUPS,
+      [&]
+      {
+        for (std::size_t i = 0; i < urls.size(); ++i) {
+          sum += static_cast<std::size_t>(server.resolve(ResourceRequest{"GET", urls[i], etags[i]}).status);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,92 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Base64.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t SIZE = 64 * 1024;
+
+auto make_bytes() -> std::vector<std::byte>
+{
+  auto bytes = std::vector<std::byte>(SIZE);
+  auto state = std::uint32_t(1);
+  for (auto& byte : bytes) {
+    state = state * 1664525u + 1013904223u;
+    byte  = static_cast<std::byte>(state >> 24);
+  }
+  return bytes;
+}
+
+auto encode(Context& context, SimdLevel level) -> void
+{
+  if (!context.require(level)) {
+    return;
+  }
+  auto const bytes = make_bytes();
+  auto       out   = std::vector<char>(base64_encoded_size(bytes.size()));
+  context.measure(
+    1,
+    [&]
+    {
+      do_not_optimize(base64_encode(bytes, out, level));
+    }
+  );
+  context.set_bytes_per_op(SIZE);
+}
+
+auto decode(Context& context, SimdLevel level) -> void
+{
+  if (!context.require(level)) {
+    return;
+  }
+  auto const bytes = make_bytes();
+  auto       text  = std::string(base64_encoded_size(bytes.size()), '\0');
+  text.resize(base64_encode(bytes, std::span<char>(text)));
+  auto out = std::vector<std::byte>(base64_decoded_capacity(text.size()) + BASE64_DECODE_SLACK);
+  context.measure(
+    1,
+    [&]
+    {
+      do_not_optimize(base64_decode(text, out, level));
+    }
+  );
+  context.set_bytes_per_op(SIZE);
+}
+
+[[maybe_unused]] auto const registered = []
+{
+  for (auto const level : SIMD_LEVELS) {
+    auto const name = std::string(simd_level_name(level));
+    register_benchmark(
+      "base64/encode/" + name,
+      [level](Context& context)
+      {
+        encode(context, level);
+      }
+    );
+    register_benchmark(
+      "base64/decode/" + name,
+      [level](Context& context)
+      {
+        decode(context, level);
+      }
+    );
+  }
+  return true;
+}();
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+
+/// Heap allocations made by the process (all threads), counted by the replaced `operator new`.
+auto allocation_count() noexcept -> std::uint64_t;
+
+/// The measurements of one benchmark.
+struct Result
+{
+  std::string   name;
+  std::uint64_t operations = 0;
+  double        seconds    = 0;
+
+  double ns_per_op          = 0;
+  double ops_per_second     = 0;
+  double allocations_per_op = 0;
+  /// 0 unless the benchmark reports the bytes processed per operation.
+  double bytes_per_second = 0;
+
+  /// Additional values, e.g. latency percentiles.
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+/// Passed to the benchmark functions to time their code.
+class Context
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit Context(std::chrono::nanoseconds min_time)
+    : _min_time(min_time)
+  {
+  }
+
+  /// Calls `fn` repeatedly until the minimum time has elapsed. Every call counts as
+  /// `ops_per_call` operations. The first call is a warm-up and is not measured.
+  template <typename Fn>
+  auto measure(std::uint64_t ops_per_call, Fn&& fn) -> void
+  {
+    fn();
+
+    std::uint64_t calls       = 0;
+    std::uint64_t batch       = 1;
+    auto const    allocations = allocation_count();
+    auto const    start       = Clock::now();
+    auto          elapsed     = Clock::duration();
+    while (elapsed < _min_time) {
+      for (std::uint64_t i = 0; i < batch; ++i) {
+        fn();
+      }
+      calls += batch;
+      batch *= 2;
+      elapsed = Clock::now() - start;
+    }
+
+    _result.operations = calls * ops_per_call;
+    _result.seconds    = std::chrono::duration<double>(elapsed).count();
+    _result.allocations_per_op =
+      static_cast<double>(allocation_count() - allocations) / static_cast<double>(_result.operations);
+  }
+
+  /// Reports how many bytes one operation processes, for the throughput.
+  auto set_bytes_per_op(double bytes) noexcept -> void
+  {
+    _bytes_per_op = bytes;
+  }
+
+  auto add_metric(std::string name, double value) -> void
+  {
+    _result.metrics.emplace_back(std::move(name), value);
+  }
+
+  /// Adds the p50, p90 and p99 of the given samples (in nanoseconds) as metrics.
+  auto add_percentiles(std::string_view prefix, std::vector<std::int64_t> samples) -> void;
+
+  /// Skips the benchmark, e.g. when the CPU lacks the instruction set it measures.
+  auto skip() noexcept -> void
+  {
+    _skipped = true;
+  }
+
+  /// Skips the benchmark unless the CPU supports `level`.
+  auto require(SimdLevel level) noexcept -> bool
+  {
+    if (level > simd_level()) {
+      skip();
+    }
+    return !_skipped;
+  }
+
+  auto skipped() const noexcept -> bool
+  {
+    return _skipped;
+  }
+
+  auto result(std::string name) -> Result;
+
+private:
+  std::chrono::nanoseconds _min_time;
+  double                   _bytes_per_op = 0;
+  bool                     _skipped      = false;
+  Result                   _result;
+};
+
+using Function = std::function<void(Context&)>;
+
+inline auto simd_level_name(SimdLevel level) -> std::string_view
+{
+  switch (level) {
+  case SimdLevel::AVX2: return "avx2";
+  case SimdLevel::SSE41: return "sse41";
+  default: return "scalar";
+  }
+}
+
+/// Every instruction set level, the benchmarks of the unsupported ones are skipped.
+inline constexpr SimdLevel SIMD_LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2};
+
+/// Adds a benchmark to the suite, see `UBYTES_BENCH`.
+auto register_benchmark(std::string name, Function function) -> bool;
+
+/// Keeps a value alive so the optimizer cannot remove the code computing it.
+template <typename T>
+inline auto do_not_optimize(T const& value) -> void
+{
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static std::atomic<T const*> sink;
+  sink.store(&value, std::memory_order_relaxed);
+#endif
+}
+
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
+
+#define UBYTES_BENCH_CONCAT_IMPL(a, b) a##b
+#define UBYTES_BENCH_CONCAT(a, b) UBYTES_BENCH_CONCAT_IMPL(a, b)
+
+/// Registers a `void(Context&)` function under a name (`group/case`).
+#define UBYTES_BENCH(name, function) \
+  static bool const UBYTES_BENCH_CONCAT(ubytes_bench_, __LINE__) = \
+    ::ubytes::app_platform::bench::register_benchmark(name, function)
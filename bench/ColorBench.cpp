@@ -0,0 +1,84 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Color.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t PIXELS = 4096;
+
+auto make_hex_colors() -> std::vector<std::uint32_t>
+{
+  auto colors = std::vector<std::uint32_t>(PIXELS);
+  auto state  = std::uint32_t(0x12345678);
+  for (auto& color : colors) {
+    state = state * 1664525u + 1013904223u;
+    color = state;
+  }
+  return colors;
+}
+
+// `from_hex()` returns the RGB/RGBA base of the color type.
+template <typename Color>
+using ColorValue = decltype(Color::from_hex(0));
+
+template <typename Color>
+auto from_hex(Context& context) -> void
+{
+  auto const hex    = make_hex_colors();
+  auto       colors = std::vector<ColorValue<Color>>(PIXELS);
+  context.measure(
+    PIXELS,
+    [&]
+    {
+      for (std::size_t i = 0; i < PIXELS; ++i) {
+        colors[i] = Color::from_hex(hex[i]);
+      }
+      do_not_optimize(colors.data());
+    }
+  );
+  context.set_bytes_per_op(sizeof(std::uint32_t));
+}
+
+template <typename Color>
+auto to_hex(Context& context) -> void
+{
+  auto const hex    = make_hex_colors();
+  auto       colors = std::vector<ColorValue<Color>>(PIXELS);
+  auto       out    = std::vector<std::uint32_t>(PIXELS);
+  for (std::size_t i = 0; i < PIXELS; ++i) {
+    colors[i] = Color::from_hex(hex[i]);
+  }
+  context.measure(
+    PIXELS,
+    [&]
+    {
+      for (std::size_t i = 0; i < PIXELS; ++i) {
+        out[i] = colors[i].to_hex();
+      }
+      do_not_optimize(out.data());
+    }
+  );
+  context.set_bytes_per_op(sizeof(std::uint32_t));
+}
+
+UBYTES_BENCH("color/from_hex/Color4f", from_hex<Color4f>);
+UBYTES_BENCH("color/from_hex/Color4u", from_hex<Color4u>);
+UBYTES_BENCH("color/from_hex/Color3f", from_hex<Color3f>);
+UBYTES_BENCH("color/to_hex/Color4f", to_hex<Color4f>);
+UBYTES_BENCH("color/to_hex/Color4u", to_hex<Color4u>);
+UBYTES_BENCH("color/to_hex/Color3f", to_hex<Color3f>);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
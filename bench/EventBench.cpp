@@ -0,0 +1,240 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Event.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t CALLS = 4096;
+
+/// A typical handler capture: an object, a shared state and an id. Too large for the
+/// inline storage of `std::function` in the common standard libraries.
+struct Handler
+{
+  std::uint64_t*                 sum;
+  std::shared_ptr<std::uint64_t> state;
+  std::uint32_t                  id;
+
+  auto operator()(std::uint32_t value) const -> void
+  {
+    *sum += value + id + *state;
+  }
+};
+
+auto make_handler(std::uint64_t& sum, std::uint32_t id) -> Handler
+{
+  return Handler{&sum, std::make_shared<std::uint64_t>(id), id};
+}
+
+/// The baseline: the `std::function` slots of `Window` and `WebView`.
+UBYTES_BENCH(
+  "event/dispatch/std_function",
+  [](Context& context)
+  {
+    auto sum      = std::uint64_t(0);
+    auto function = std::function<void(std::uint32_t)>(make_handler(sum, 1));
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (std::uint32_t i = 0; i < CALLS; ++i) {
+          function(i);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+UBYTES_BENCH(
+  "event/dispatch/delegate",
+  [](Context& context)
+  {
+    auto sum      = std::uint64_t(0);
+    auto delegate = Delegate<void(std::uint32_t)>(make_handler(sum, 1));
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (std::uint32_t i = 0; i < CALLS; ++i) {
+          delegate(i);
+        }
+      }
+    );
+    context.add_metric("inline", delegate.is_inline());
+    do_not_optimize(sum);
+  }
+);
+
+/// Assigning the handler, where `std::function` allocates and `Delegate` does not.
+UBYTES_BENCH(
+  "event/assign/std_function",
+  [](Context& context)
+  {
+    auto       sum      = std::uint64_t(0);
+    auto const handler  = make_handler(sum, 1);
+    auto       function = std::function<void(std::uint32_t)>();
+    context.measure(
+      1,
+      [&]
+      {
+        function = handler;
+        do_not_optimize(function);
+      }
+    );
+  }
+);
+
+UBYTES_BENCH(
+  "event/assign/delegate",
+  [](Context& context)
+  {
+    auto       sum      = std::uint64_t(0);
+    auto const handler  = make_handler(sum, 1);
+    auto       delegate = Delegate<void(std::uint32_t)>();
+    context.measure(
+      1,
+      [&]
+      {
+        delegate = handler;
+        do_not_optimize(delegate);
+      }
+    );
+  }
+);
+
+/// Several subscribers on one slot, the way it's done with `std::function`: a vector of them.
+auto dispatch_functions(Context& context, std::uint32_t subscribers) -> void
+{
+  auto sum       = std::uint64_t(0);
+  auto functions = std::vector<std::function<void(std::uint32_t)>>();
+  for (std::uint32_t id = 0; id < subscribers; ++id) {
+    functions.emplace_back(make_handler(sum, id));
+  }
+  context.measure(
+    CALLS,
+    [&]
+    {
+      for (std::uint32_t i = 0; i < CALLS; ++i) {
+        for (auto const& function : functions) {
+          function(i);
+        }
+      }
+    }
+  );
+  do_not_optimize(sum);
+}
+
+auto dispatch_event(Context& context, std::uint32_t subscribers) -> void
+{
+  auto sum           = std::uint64_t(0);
+  auto event         = Event<std::uint32_t>();
+  auto subscriptions = std::vector<EventSubscription>();
+  for (std::uint32_t id = 0; id < subscribers; ++id) {
+    subscriptions.push_back(event.subscribe(make_handler(sum, id)));
+  }
+  context.measure(
+    CALLS,
+    [&]
+    {
+      for (std::uint32_t i = 0; i < CALLS; ++i) {
+        event(i);
+      }
+    }
+  );
+  do_not_optimize(sum);
+}
+
+UBYTES_BENCH(
+  "event/dispatch/event_1",
+  [](Context& context)
+  {
+    dispatch_event(context, 1);
+  }
+);
+
+UBYTES_BENCH(
+  "event/dispatch/std_function_x4",
+  [](Context& context)
+  {
+    dispatch_functions(context, 4);
+  }
+);
+
+UBYTES_BENCH(
+  "event/dispatch/event_4",
+  [](Context& context)
+  {
+    dispatch_event(context, 4);
+  }
+);
+
+/// An event assigned to a `std::function` slot, as `WebView::on_message` would call it.
+UBYTES_BENCH(
+  "event/dispatch/dispatcher_4",
+  [](Context& context)
+  {
+    auto sum           = std::uint64_t(0);
+    auto event         = Event<std::uint32_t>();
+    auto subscriptions = std::vector<EventSubscription>();
+    for (std::uint32_t id = 0; id < 4; ++id) {
+      subscriptions.push_back(event.subscribe(make_handler(sum, id)));
+    }
+    auto const slot = std::function<void(std::uint32_t)>(event.dispatcher());
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (std::uint32_t i = 0; i < CALLS; ++i) {
+          slot(i);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+/// Subscribing and unsubscribing a handler on an event with a few others.
+UBYTES_BENCH(
+  "event/subscribe",
+  [](Context& context)
+  {
+    auto sum           = std::uint64_t(0);
+    auto event         = Event<std::uint32_t>();
+    auto subscriptions = std::vector<EventSubscription>();
+    for (std::uint32_t id = 0; id < 4; ++id) {
+      subscriptions.push_back(event.subscribe(make_handler(sum, id)));
+    }
+    auto* const counter = &sum;
+    context.measure(
+      1,
+      [&]
+      {
+        auto subscription = event.subscribe(
+          [counter](std::uint32_t value)
+          {
+            *counter += value;
+          },
+          1
+        );
+        subscription.reset();
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
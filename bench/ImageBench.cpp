@@ -0,0 +1,292 @@
+#include "Bench.hpp"
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/Core/Base64.hpp>
+#include <UBytes/AppPlatform/Core/ImageCodec.hpp>
+#include <UBytes/AppPlatform/WebView/ImageTransfer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if UBYTES_BENCH_PNG
+#include <png.h>
+#endif
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::uint32_t WIDTH  = 1024;
+constexpr std::uint32_t HEIGHT = 1024;
+constexpr std::size_t   PIXELS = std::size_t(WIDTH) * HEIGHT;
+constexpr std::size_t   BYTES  = PIXELS * sizeof(Color4u);
+
+/// A 1024x1024 texture-like image: smooth shapes, a tiled pattern, flat areas with text-like
+/// detail and some grain, so neither codec gets a best or worst case.
+auto make_image() -> std::vector<Color4u> const&
+{
+  static auto const image = []
+  {
+    auto pixels = std::vector<Color4u>(PIXELS);
+    auto state  = std::uint32_t(1);
+    for (std::uint32_t y = 0; y < HEIGHT; ++y) {
+      for (std::uint32_t x = 0; x < WIDTH; ++x) {
+        state            = state * 1664525u + 1013904223u;
+        auto const grain = int(state >> 29) - 4;
+        auto const fx    = float(x) / WIDTH;
+        auto const fy    = float(y) / HEIGHT;
+        auto const wave  = 0.5f + 0.5f * std::sin(fx * 18.0f + std::cos(fy * 7.0f) * 3.0f);
+        auto&      pixel = pixels[std::size_t(y) * WIDTH + x];
+        if (y < HEIGHT / 4) {
+          // A flat panel with glyph-like marks.
+          auto const mark = ((x / 3) * 7 + (y / 5) * 13) % 11 == 0 && (y % 24) < 16;
+          pixel           = mark ? Color4u(30, 30, 40, 255) : Color4u(236, 236, 240, 255);
+        }
+        else if (((x / 64) + (y / 64)) % 2 == 0) {
+          pixel = Color4u(
+            std::uint8_t(std::clamp(int(wave * 200.0f) + grain, 0, 255)),
+            std::uint8_t(std::clamp(int(fy * 180.0f) + grain, 0, 255)),
+            std::uint8_t(std::clamp(int((1.0f - fx) * 220.0f) + grain, 0, 255)),
+            255
+          );
+        }
+        else {
+          pixel = Color4u(std::uint8_t(90 + (x % 16) * 4), std::uint8_t(60 + (y % 32) * 2), 120, 255);
+        }
+      }
+    }
+    return pixels;
+  }();
+  return image;
+}
+
+/// Encodes the image as tiles on the calling thread, like the task pool does on every worker.
+auto encode_tiles(std::uint32_t tile_size, std::vector<std::byte>& tile) -> std::size_t
+{
+  auto const& image  = make_image();
+  auto        total  = std::size_t(0);
+  auto        header = ImageTileHeader();
+
+  header.image_width  = WIDTH;
+  header.image_height = HEIGHT;
+  for (header.y = 0; header.y < HEIGHT; header.y += tile_size) {
+    for (header.x = 0; header.x < WIDTH; header.x += tile_size) {
+      header.width  = std::min(tile_size, WIDTH - header.x);
+      header.height = std::min(tile_size, HEIGHT - header.y);
+      encode_image_tile(image, WIDTH, header, tile);
+      total += tile.size();
+    }
+  }
+  return total;
+}
+
+UBYTES_BENCH(
+  "image/qoi/encode_tiles",
+  [](Context& context)
+  {
+    auto tile = std::vector<std::byte>();
+    auto size = std::size_t(0);
+    context.measure(
+      1,
+      [&]
+      {
+        size = encode_tiles(256, tile);
+      }
+    );
+    context.set_bytes_per_op(BYTES);
+    context.add_metric("encoded_bytes", static_cast<double>(size));
+    context.add_metric("ratio", static_cast<double>(size) / BYTES);
+  }
+);
+
+UBYTES_BENCH(
+  "image/qoi/decode",
+  [](Context& context)
+  {
+    auto const& image  = make_image();
+    auto        header = ImageTileHeader();
+    auto        tile   = std::vector<std::byte>();
+
+    header.image_width  = WIDTH;
+    header.image_height = HEIGHT;
+    header.width        = WIDTH;
+    header.height       = HEIGHT;
+    encode_image_tile(image, WIDTH, header, tile);
+
+    auto pixels = std::vector<Color4u>();
+    context.measure(
+      1,
+      [&]
+      {
+        do_not_optimize(decode_image_tile(tile, header, pixels));
+      }
+    );
+    context.set_bytes_per_op(BYTES);
+  }
+);
+
+UBYTES_BENCH(
+  "image/downscale/8",
+  [](Context& context)
+  {
+    auto const& image   = make_image();
+    auto        preview = std::vector<Color4u>();
+    context.measure(
+      1,
+      [&]
+      {
+        downscale_image(image, WIDTH, HEIGHT, 8, preview);
+      }
+    );
+    context.set_bytes_per_op(BYTES);
+  }
+);
+
+/// `ImageSender::send()` to the loopback page: the copy, the preview, the tiles encoded on
+/// `task_pool()`, the base64 messages and their delivery, until the last tile arrives.
+auto send(Context& context, ImageSettings settings) -> void
+{
+  auto webview  = WebView();
+  auto received = std::size_t(0);
+  loopback::configure(webview, {});
+  webview.on_message = [&received](std::string message)
+  {
+    received += message.size();
+  };
+
+  auto images        = ImageSender(webview, task_pool());
+  auto complete      = false;
+  images.on_progress = [&complete](std::string_view, std::uint32_t, std::uint32_t sent, std::uint32_t tiles)
+  {
+    complete = sent == tiles;
+  };
+
+  auto const& image = make_image();
+  auto const  once  = [&]
+  {
+    complete = false;
+    images.send("texture", image, WIDTH, HEIGHT, settings);
+    while (!complete || loopback::pending(webview) != 0) {
+      if (ui_queue().drain() == 0 && loopback::pump(webview) == 0) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  context.measure(1, once);
+  context.set_bytes_per_op(BYTES);
+
+  received = 0;
+  once();
+  context.add_metric("message_bytes", static_cast<double>(received));
+  context.add_metric("ratio", static_cast<double>(received) / BYTES);
+}
+
+UBYTES_BENCH(
+  "image/send/tiles_256",
+  [](Context& context)
+  {
+    send(context, ImageSettings{.tile_size = 256, .preview_scale = 0});
+  }
+);
+
+UBYTES_BENCH(
+  "image/send/tiles_256_preview",
+  [](Context& context)
+  {
+    send(context, ImageSettings{.tile_size = 256, .preview_scale = 8});
+  }
+);
+
+UBYTES_BENCH(
+  "image/send/single_tile",
+  [](Context& context)
+  {
+    send(context, ImageSettings{.tile_size = WIDTH, .preview_scale = 0});
+  }
+);
+
+#if UBYTES_BENCH_PNG
+
+/// The usual way to show a pixel buffer on the page: a PNG in a base64 data URL.
+auto encode_png(std::vector<Color4u> const& image, int level, std::vector<std::byte>& out) -> void
+{
+  out.clear();
+  auto* png  = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  auto* info = png_create_info_struct(png);
+  png_set_write_fn(
+    png,
+    &out,
+    [](png_structp png, png_bytep data, png_size_t size)
+    {
+      auto& out = *static_cast<std::vector<std::byte>*>(png_get_io_ptr(png));
+      out.insert(out.end(), reinterpret_cast<std::byte const*>(data), reinterpret_cast<std::byte const*>(data) + size);
+    },
+    nullptr
+  );
+  png_set_compression_level(png, level);
+  png_set_IHDR(
+    png, info, WIDTH, HEIGHT, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+    PNG_FILTER_TYPE_DEFAULT
+  );
+  png_write_info(png, info);
+  for (std::uint32_t y = 0; y < HEIGHT; ++y) {
+    png_write_row(png, reinterpret_cast<png_const_bytep>(image.data() + std::size_t(y) * WIDTH));
+  }
+  png_write_end(png, nullptr);
+  png_destroy_write_struct(&png, &info);
+}
+
+auto png_base64(Context& context, int level) -> void
+{
+  auto const& image   = make_image();
+  auto        png     = std::vector<std::byte>();
+  auto        message = std::string();
+  context.measure(
+    1,
+    [&]
+    {
+      encode_png(image, level, png);
+      message.assign("data:image/png;base64,");
+      auto const prefix = message.size();
+      message.resize(prefix + base64_encoded_size(png.size()));
+      base64_encode(png, std::span<char>(message).subspan(prefix));
+      do_not_optimize(message);
+    }
+  );
+  context.set_bytes_per_op(BYTES);
+  context.add_metric("encoded_bytes", static_cast<double>(png.size()));
+  context.add_metric("message_bytes", static_cast<double>(message.size()));
+  context.add_metric("ratio", static_cast<double>(message.size()) / BYTES);
+}
+
+UBYTES_BENCH(
+  "image/png_base64/default",
+  [](Context& context)
+  {
+    png_base64(context, 6);
+  }
+);
+
+UBYTES_BENCH(
+  "image/png_base64/fast",
+  [](Context& context)
+  {
+    png_base64(context, 1);
+  }
+);
+
+#endif
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
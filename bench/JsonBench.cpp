@@ -0,0 +1,98 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+
+#include <string>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t ROWS = 256;
+
+auto write_rows(JsonWriter& writer) -> void
+{
+  writer.reset();
+  writer.begin_object();
+  writer.key("rows").begin_array();
+  for (std::size_t i = 0; i < ROWS; ++i) {
+    writer.begin_object();
+    writer.field("id", i);
+    writer.field("name", "Row with a \"quoted\" name");
+    writer.field("value", static_cast<double>(i) * 0.25);
+    writer.field("selected", i % 3 == 0);
+    writer.end_object();
+  }
+  writer.end_array();
+  writer.end_object();
+}
+
+UBYTES_BENCH(
+  "json/write/rows",
+  [](Context& context)
+  {
+    auto writer = JsonWriter();
+    context.measure(
+      1,
+      [&]
+      {
+        write_rows(writer);
+        do_not_optimize(writer.view().data());
+      }
+    );
+    context.set_bytes_per_op(static_cast<double>(writer.view().size()));
+  }
+);
+
+auto read_rows(Context& context, SimdLevel level) -> void
+{
+  if (!context.require(level)) {
+    return;
+  }
+  auto writer = JsonWriter();
+  write_rows(writer);
+  auto const json   = std::string(writer.view());
+  auto       reader = JsonReader();
+
+  context.measure(
+    1,
+    [&]
+    {
+      auto sum = 0.0;
+      reader.parse(json, level)["rows"].for_each_element(
+        [&](JsonValue row)
+        {
+          sum += row["value"].get_double().value_or(0);
+          return true;
+        }
+      );
+      do_not_optimize(sum);
+    }
+  );
+  context.set_bytes_per_op(static_cast<double>(json.size()));
+}
+
+[[maybe_unused]] auto const registered = []
+{
+  for (auto const level : SIMD_LEVELS) {
+    register_benchmark(
+      "json/read/rows/" + std::string(simd_level_name(level)),
+      [level](Context& context)
+      {
+        read_rows(context, level);
+      }
+    );
+  }
+  return true;
+}();
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
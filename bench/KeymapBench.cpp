@@ -0,0 +1,321 @@
+#include "Bench.hpp"
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/Core/Keymap.hpp>
+#include <UBytes/AppPlatform/WebView/AcceleratorKeys.hpp>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t STROKES = 4096;
+
+struct Binding
+{
+  std::vector<KeyStroke> sequence;
+  std::uint32_t          command;
+};
+
+/// An editor keymap: Ctrl and Ctrl+Shift letters, function keys, navigation and Ctrl+K chords.
+auto make_bindings() -> std::vector<Binding> const&
+{
+  static auto const bindings = []
+  {
+    auto result  = std::vector<Binding>();
+    auto command = std::uint32_t(1);
+    for (auto key = int(Keyboard::A); key <= int(Keyboard::Z); ++key) {
+      result.push_back(Binding{{KeyStroke(Keyboard::Key(key), Keyboard::Ctrl)}, command++});
+      if (key % 2 == 0) {
+        result.push_back(Binding{{KeyStroke(Keyboard::Key(key), Keyboard::Ctrl | Keyboard::Shift)}, command++});
+      }
+    }
+    for (auto key = int(Keyboard::F1); key <= int(Keyboard::F12); ++key) {
+      result.push_back(Binding{{KeyStroke(Keyboard::Key(key))}, command++});
+      result.push_back(Binding{{KeyStroke(Keyboard::Key(key), Keyboard::Shift)}, command++});
+    }
+    for (auto key = int(Keyboard::PageUp); key <= int(Keyboard::Home); ++key) {
+      result.push_back(Binding{{KeyStroke(Keyboard::Key(key), Keyboard::Ctrl)}, command++});
+    }
+    // Ctrl+K is a chord prefix, not a command.
+    std::erase_if(
+      result,
+      [](Binding const& binding)
+      {
+        return binding.sequence.front() == KeyStroke(Keyboard::K, Keyboard::Ctrl);
+      }
+    );
+    auto const prefix = KeyStroke(Keyboard::K, Keyboard::Ctrl);
+    for (auto key = int(Keyboard::A); key <= int(Keyboard::Z); key += 3) {
+      result.push_back(Binding{{prefix, KeyStroke(Keyboard::Key(key), Keyboard::Ctrl)}, command++});
+      result.push_back(Binding{{prefix, KeyStroke(Keyboard::Key(key))}, command++});
+    }
+    return result;
+  }();
+  return bindings;
+}
+
+/// Mostly typing (plain and shifted letters, digits), with a shortcut every few keys.
+auto make_strokes() -> std::vector<KeyStroke>
+{
+  auto const& bindings = make_bindings();
+  auto        strokes  = std::vector<KeyStroke>();
+  auto        state    = std::uint32_t(1);
+  auto const  next     = [&state]
+  {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  };
+  while (strokes.size() < STROKES) {
+    if (next() % 4 == 0) {
+      auto const& binding = bindings[next() % bindings.size()];
+      strokes.insert(strokes.end(), binding.sequence.begin(), binding.sequence.end());
+    }
+    else {
+      strokes.push_back(KeyStroke(Keyboard::Key(next() % (Keyboard::Num9 + 1)), next() % 8 == 0 ? Keyboard::Shift : 0));
+    }
+  }
+  strokes.resize(STROKES);
+  return strokes;
+}
+
+auto make_keymap() -> Keymap
+{
+  auto keymap = Keymap();
+  for (auto const& binding : make_bindings()) {
+    keymap.bind(binding.sequence, binding.command);
+  }
+  return keymap;
+}
+
+auto single_stroke_bindings() -> std::vector<Binding>
+{
+  auto result = make_bindings();
+  std::erase_if(
+    result,
+    [](Binding const& binding)
+    {
+      return binding.sequence.size() != 1;
+    }
+  );
+  return result;
+}
+
+UBYTES_BENCH(
+  "keymap/lookup/flat_table",
+  [](Context& context)
+  {
+    auto const keymap  = make_keymap();
+    auto const strokes = make_strokes();
+    auto       sum     = std::uint64_t(0);
+    context.measure(
+      STROKES,
+      [&]
+      {
+        for (auto const stroke : strokes) {
+          sum += keymap.lookup(stroke);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+auto lookup_std_map(Context& context) -> void
+{
+  auto map = std::map<std::pair<int, int>, std::uint32_t>();
+  for (auto const& binding : single_stroke_bindings()) {
+    map.emplace(std::pair(int(binding.sequence[0].key), int(binding.sequence[0].modifiers)), binding.command);
+  }
+  auto const strokes = make_strokes();
+  auto       sum     = std::uint64_t(0);
+  context.measure(
+    STROKES,
+    [&]
+    {
+      for (auto const stroke : strokes) {
+        if (auto it = map.find(std::pair(int(stroke.key), int(stroke.modifiers))); it != map.end()) {
+          sum += it->second;
+        }
+      }
+    }
+  );
+  do_not_optimize(sum);
+}
+
+UBYTES_BENCH("keymap/lookup/std_map", lookup_std_map);
+
+auto lookup_unordered_map(Context& context) -> void
+{
+  auto map = std::unordered_map<std::size_t, std::uint32_t>();
+  for (auto const& binding : single_stroke_bindings()) {
+    map.emplace(binding.sequence[0].index(), binding.command);
+  }
+  auto const strokes = make_strokes();
+  auto       sum     = std::uint64_t(0);
+  context.measure(
+    STROKES,
+    [&]
+    {
+      for (auto const stroke : strokes) {
+        if (auto it = map.find(stroke.index()); it != map.end()) {
+          sum += it->second;
+        }
+      }
+    }
+  );
+  do_not_optimize(sum);
+}
+
+UBYTES_BENCH("keymap/lookup/unordered_map", lookup_unordered_map);
+
+/// The baseline: a list of bindings compared with the key and each modifier.
+UBYTES_BENCH(
+  "keymap/lookup/linear_list",
+  [](Context& context)
+  {
+    auto const bindings = single_stroke_bindings();
+    auto const strokes  = make_strokes();
+    auto       sum      = std::uint64_t(0);
+    context.measure(
+      STROKES,
+      [&]
+      {
+        for (auto const stroke : strokes) {
+          auto const it = std::find_if(
+            bindings.begin(),
+            bindings.end(),
+            [stroke](Binding const& binding)
+            {
+              return binding.sequence[0] == stroke;
+            }
+          );
+          if (it != bindings.end()) {
+            sum += it->command;
+          }
+        }
+      }
+    );
+    context.add_metric("bindings", static_cast<double>(bindings.size()));
+    do_not_optimize(sum);
+  }
+);
+
+/// `press()` with the chords, which go through the trie.
+UBYTES_BENCH(
+  "keymap/press/chords",
+  [](Context& context)
+  {
+    auto       keymap   = make_keymap();
+    auto const strokes  = make_strokes();
+    auto       commands = std::uint64_t(0);
+    keymap.on_command   = [&commands](std::uint32_t command)
+    {
+      commands += command;
+    };
+    context.measure(
+      STROKES,
+      [&]
+      {
+        for (auto const stroke : strokes) {
+          keymap.press(stroke);
+        }
+      }
+    );
+    do_not_optimize(commands);
+  }
+);
+
+/// Every key press through the loopback `WebView`: with `filter_accelerator_keys()` the unbound
+/// keys (most of the typing) don't reach the keymap, but the WebView still calls the wrapper.
+auto forward(Context& context, bool filtered) -> void
+{
+  auto keymap    = make_keymap();
+  auto webview   = WebView();
+  auto forwarded = std::size_t(0);
+  loopback::configure(webview, {});
+  auto handler = [&keymap, &forwarded](WebView::AcceleratorKey key)
+  {
+    ++forwarded;
+    keymap.press(key.stroke());
+  };
+  if (filtered) {
+    webview.on_accelerator_key = filter_accelerator_keys(keymap.strokes(), handler);
+  }
+  else {
+    webview.on_accelerator_key = handler;
+  }
+
+  auto keys = std::vector<WebView::AcceleratorKey>();
+  for (auto const stroke : make_strokes()) {
+    keys.push_back(WebView::AcceleratorKey{
+      stroke.key,
+      (stroke.modifiers & Keyboard::Ctrl) != 0,
+      (stroke.modifiers & Keyboard::Shift) != 0,
+      (stroke.modifiers & Keyboard::Alt) != 0,
+    });
+  }
+
+  context.measure(
+    STROKES,
+    [&]
+    {
+      for (auto const key : keys) {
+        loopback::press_key(webview, key);
+      }
+    }
+  );
+
+  forwarded = 0;
+  for (auto const key : keys) {
+    loopback::press_key(webview, key);
+  }
+  context.add_metric("forwarded", static_cast<double>(forwarded) / STROKES);
+}
+
+UBYTES_BENCH(
+  "keymap/forward/all",
+  [](Context& context)
+  {
+    forward(context, false);
+  }
+);
+
+UBYTES_BENCH(
+  "keymap/forward/filtered",
+  [](Context& context)
+  {
+    forward(context, true);
+  }
+);
+
+/// Rebinding at runtime: a chord bound and unbound, without rebuilding the keymap.
+auto rebind(Context& context) -> void
+{
+  auto       keymap = make_keymap();
+  auto const chord  = std::vector<KeyStroke>{KeyStroke(Keyboard::G, Keyboard::Alt), KeyStroke(Keyboard::B)};
+  context.measure(
+    2,
+    [&]
+    {
+      keymap.bind(chord, 1000);
+      keymap.unbind(chord);
+    }
+  );
+}
+
+UBYTES_BENCH("keymap/rebind", rebind);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
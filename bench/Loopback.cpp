@@ -0,0 +1,621 @@
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/App.hpp>
+#include <UBytes/AppPlatform/Core/Text.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace
+{
+
+/// Echoed messages waiting for `pump()`. The slots keep their capacity, so once
+/// warmed up, queueing a message copies it without allocating.
+struct EchoQueue
+{
+  std::vector<std::string>  slots;
+  std::vector<std::wstring> wide_slots;
+  std::size_t               count = 0;
+};
+
+struct LoopbackWebView
+{
+  loopback::Settings settings;
+
+  // Messages sent while `pump()` delivers go to the other queue, for the next pump.
+  EchoQueue queues[2];
+  int       back = 0;
+
+  std::string  url;
+  WindowHandle parent = WindowHandle{nullptr};
+
+  /// Expires with the WebView, so that a setup finishing after its destruction does nothing.
+  std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+
+  auto echo(std::string_view message) -> void
+  {
+    auto& queue = queues[back];
+    auto  index = queue.count++;
+    if (settings.wide_strings) {
+      if (queue.wide_slots.size() <= index) {
+        queue.wide_slots.resize(index + 1);
+      }
+      auto& slot = queue.wide_slots[index];
+      slot.resize(utf16_capacity_for_utf8(message.size()));
+      slot.resize(details::utf8_to_wstring(message, slot).written);
+    }
+    else {
+      if (queue.slots.size() <= index) {
+        queue.slots.resize(index + 1);
+      }
+      queue.slots[index].assign(message);
+    }
+  }
+
+  auto echo(std::wstring_view message) -> void
+  {
+    auto& queue = queues[back];
+    auto  index = queue.count++;
+    if (settings.wide_strings) {
+      if (queue.wide_slots.size() <= index) {
+        queue.wide_slots.resize(index + 1);
+      }
+      queue.wide_slots[index].assign(message);
+    }
+    else {
+      if (queue.slots.size() <= index) {
+        queue.slots.resize(index + 1);
+      }
+      auto& slot = queue.slots[index];
+      slot.resize(utf8_capacity_for_utf16(message.size()));
+      slot.resize(details::wstring_to_utf8(message, slot).written);
+    }
+  }
+};
+
+struct LoopbackWindow
+{
+  std::string title;
+  Rect2i      bounds    = Rect2i{0, 0, 800, 600};
+  bool        maximized = false;
+  bool        minimized = false;
+};
+
+auto state_of(WebView const& webview) -> LoopbackWebView*
+{
+  auto* state = static_cast<LoopbackWebView*>(nullptr);
+  std::memcpy(&state, webview._opaque._data.data(), sizeof(state));
+  return state;
+}
+
+auto set_state(WebView& webview, LoopbackWebView* state) -> void
+{
+  std::memcpy(webview._opaque._data.data(), &state, sizeof(state));
+}
+
+auto window_of(WindowHandle handle) -> LoopbackWindow&
+{
+  return *static_cast<LoopbackWindow*>(handle.handle);
+}
+
+struct Loop
+{
+  std::mutex              mutex;
+  std::condition_variable wake;
+  bool                    woken = false;
+  bool                    quit  = false;
+};
+
+auto loop() -> Loop&
+{
+  static auto instance = Loop();
+  return instance;
+}
+
+/// Posts the setups that take `set_setup_time()` to the UI queue when they are due.
+class SetupTimer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ~SetupTimer()
+  {
+    {
+      auto lock = std::lock_guard(_mutex);
+      _stopping = true;
+    }
+    _changed.notify_one();
+    if (_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+  auto post_at(Clock::time_point time, std::function<void()> task) -> void
+  {
+    {
+      auto lock = std::lock_guard(_mutex);
+      _due.emplace(time, std::move(task));
+      if (!_thread.joinable()) {
+        _thread = std::thread(
+          [this]
+          {
+            run();
+          }
+        );
+      }
+    }
+    _changed.notify_one();
+  }
+
+private:
+  auto run() -> void
+  {
+    auto lock = std::unique_lock(_mutex);
+    while (!_stopping) {
+      if (_due.empty()) {
+        _changed.wait(lock);
+        continue;
+      }
+      auto const first = _due.begin();
+      if (Clock::now() < first->first) {
+        _changed.wait_until(lock, first->first);
+        continue;
+      }
+      auto task = std::move(first->second);
+      _due.erase(first);
+      lock.unlock();
+      post_to_ui(std::move(task));
+      lock.lock();
+    }
+  }
+
+  std::mutex                                              _mutex;
+  std::condition_variable                                 _changed;
+  std::multimap<Clock::time_point, std::function<void()>> _due;
+  bool                                                    _stopping = false;
+  std::thread                                             _thread;
+};
+
+auto setup_timer() -> SetupTimer&
+{
+  // Constructed after the loop, so that its thread is joined before the loop is destroyed.
+  loop();
+  static auto instance = SetupTimer();
+  return instance;
+}
+
+std::atomic<std::int64_t> setup_time_ns = 0;
+
+} // namespace
+
+// Text
+
+auto details::to_wstring(std::u8string_view str) -> std::wstring
+{
+  return utf8_to_wstring(to_regular_sv(str));
+}
+
+auto details::to_wstring(std::string_view utf8str) -> std::wstring
+{
+  return utf8_to_wstring(utf8str);
+}
+
+auto details::to_utf8_string(std::wstring_view wstr) -> std::string
+{
+  return wstring_to_utf8(wstr);
+}
+
+auto details::to_regular_sv(std::u8string_view str) -> std::string_view
+{
+  return std::string_view(reinterpret_cast<char const*>(str.data()), str.size());
+}
+
+// WebView
+
+WebView::WebView()
+  : _opaque{}
+{
+  set_state(*this, new LoopbackWebView());
+}
+
+WebView::~WebView()
+{
+  delete state_of(*this);
+}
+
+WebView::WebView(WebView&& other) noexcept
+  : on_ready(std::move(other.on_ready))
+  , on_message(std::move(other.on_message))
+  , on_accelerator_key(std::move(other.on_accelerator_key))
+  , on_permission_request(std::move(other.on_permission_request))
+  , _opaque(other._opaque)
+  , _setup_finished(other._setup_finished)
+{
+  set_state(other, nullptr);
+}
+
+auto WebView::operator=(WebView&& other) noexcept -> WebView&
+{
+  if (this != &other) {
+    delete state_of(*this);
+    on_ready              = std::move(other.on_ready);
+    on_message            = std::move(other.on_message);
+    on_accelerator_key    = std::move(other.on_accelerator_key);
+    on_permission_request = std::move(other.on_permission_request);
+    _opaque               = other._opaque;
+    _setup_finished       = other._setup_finished;
+    set_state(other, nullptr);
+  }
+  return *this;
+}
+
+auto WebView::begin_setup(Window const& window, WebViewSettings settings) -> void
+{
+  begin_setup(window.handle(), settings);
+}
+
+auto WebView::begin_setup(WindowHandle window_handle, WebViewSettings) -> void
+{
+  auto* state   = state_of(*this);
+  state->parent = window_handle;
+
+  auto ready = [this, alive = std::weak_ptr<bool>(state->alive)]
+  {
+    if (alive.expired()) {
+      return;
+    }
+    _setup_finished = true;
+    if (on_ready) {
+      on_ready();
+    }
+  };
+  auto const setup_time = std::chrono::nanoseconds(setup_time_ns.load(std::memory_order_relaxed));
+  if (setup_time.count() == 0) {
+    post_to_ui(std::move(ready));
+  }
+  else {
+    setup_timer().post_at(SetupTimer::Clock::now() + setup_time, std::move(ready));
+  }
+}
+
+auto WebView::set_bounds(Rect2i) -> void {}
+
+auto WebView::set_background_color(Color4f) -> void {}
+
+auto WebView::set_transparent_background(bool) -> void {}
+
+auto WebView::focus(FocusReason) -> void {}
+
+auto WebView::set_parent_window(WindowHandle window) -> void
+{
+  state_of(*this)->parent = window;
+}
+
+auto WebView::navigate(std::string_view url) -> void
+{
+  state_of(*this)->url = url;
+}
+
+auto WebView::navigate(std::u8string_view url) -> void
+{
+  navigate(details::to_regular_sv(url));
+}
+
+auto WebView::navigate(std::wstring_view url) -> void
+{
+  navigate(details::to_utf8_string(url));
+}
+
+auto WebView::send_message(std::string_view message) -> void
+{
+  UBYTES_TRACE_RECORD(TraceMetric::SendSize, message.size());
+  state_of(*this)->echo(message);
+}
+
+auto WebView::send_message(std::u8string_view message) -> void
+{
+  send_message(details::to_regular_sv(message));
+}
+
+auto WebView::send_message(std::wstring_view message) -> void
+{
+  UBYTES_TRACE_RECORD(TraceMetric::SendSize, message.size() * sizeof(wchar_t));
+  state_of(*this)->echo(message);
+}
+
+auto WebView::send_message_str(std::string_view message) -> void
+{
+  send_message(message);
+}
+
+auto WebView::send_message_str(std::u8string_view message) -> void
+{
+  send_message(message);
+}
+
+auto WebView::send_message_str(std::wstring_view message) -> void
+{
+  send_message(message);
+}
+
+// WebView::Permission::Request
+
+WebView::Permission::Request::Request()
+  : _opaque{}
+{
+}
+
+WebView::Permission::Request::~Request() = default;
+
+auto WebView::Permission::Request::get_kind() const -> Kind
+{
+  return Unknown;
+}
+
+auto WebView::Permission::Request::get_response() const -> Response
+{
+  return Default;
+}
+
+auto WebView::Permission::Request::get_saves_in_profile() const -> bool
+{
+  return false;
+}
+
+auto WebView::Permission::Request::is_user_initiated() const -> bool
+{
+  return false;
+}
+
+auto WebView::Permission::Request::get_url() const -> std::string
+{
+  return {};
+}
+
+auto WebView::Permission::Request::set_response(Response) const -> void {}
+
+auto WebView::Permission::Request::set_saves_in_profile(bool) const -> void {}
+
+auto WebView::Permission::Request::mark_completed() const -> void {}
+
+// Window
+
+auto Window::create(Window& window) -> void
+{
+  // Never freed: the windows live as long as the benchmark process.
+  window._handle.handle = new LoopbackWindow();
+}
+
+auto Window::set_borderless() -> void
+{
+  _borderless = true;
+}
+
+auto Window::set_title(std::string_view title) -> void
+{
+  window_of(_handle).title = title;
+}
+
+auto Window::get_title() const -> std::string
+{
+  return window_of(_handle).title;
+}
+
+auto Window::set_size(Vec2u size) -> void
+{
+  auto bounds = get_bounds();
+  bounds.w    = static_cast<std::int32_t>(size.x);
+  bounds.h    = static_cast<std::int32_t>(size.y);
+  set_bounds(bounds);
+}
+
+auto Window::get_size() const -> Vec2u
+{
+  return get_inner_size();
+}
+
+auto Window::set_position(Vec2i position) -> void
+{
+  auto bounds = get_bounds();
+  bounds.x    = position.x;
+  bounds.y    = position.y;
+  set_bounds(bounds);
+}
+
+auto Window::get_position() const -> Vec2i
+{
+  auto const bounds = get_bounds();
+  return Vec2i(bounds.x, bounds.y);
+}
+
+auto Window::set_bounds(Rect2i bounds) -> void
+{
+  window_of(_handle).bounds = bounds;
+  on_resize(bounds);
+}
+
+auto Window::get_bounds() const -> Rect2i
+{
+  return window_of(_handle).bounds;
+}
+
+auto Window::is_maximized() const -> bool
+{
+  return window_of(_handle).maximized;
+}
+
+auto Window::is_minimized() const -> bool
+{
+  return window_of(_handle).minimized;
+}
+
+auto Window::get_inner_size() const -> Vec2u
+{
+  auto const bounds = get_bounds();
+  return Vec2u(static_cast<std::uint32_t>(bounds.w), static_cast<std::uint32_t>(bounds.h));
+}
+
+auto Window::request_close() -> void
+{
+  loopback::quit();
+}
+
+auto Window::request_toggle_maximize() -> void
+{
+  auto& window     = window_of(_handle);
+  window.maximized = !window.maximized;
+  window.minimized = false;
+}
+
+auto Window::request_minimize() -> void
+{
+  window_of(_handle).minimized = true;
+}
+
+// The application loop
+
+auto run_default(AppInterface& app) -> int
+{
+  auto& state = loop();
+  {
+    auto lock  = std::lock_guard(state.mutex);
+    state.quit = false;
+  }
+
+  // Stands for `attach_ui_queue_to_message_loop()`, which the Windows applications call.
+  ui_queue().set_waker(
+    [&state]
+    {
+      {
+        auto lock   = std::lock_guard(state.mutex);
+        state.woken = true;
+      }
+      state.wake.notify_one();
+    }
+  );
+  app.on_start();
+  while (true) {
+    {
+      auto lock = std::unique_lock(state.mutex);
+      state.wake.wait(
+        lock,
+        [&]
+        {
+          return state.woken || state.quit;
+        }
+      );
+      if (state.quit) {
+        break;
+      }
+      state.woken = false;
+    }
+    ui_queue().drain();
+  }
+  return 0;
+}
+
+// Loopback controls
+
+namespace loopback
+{
+
+auto configure(WebView& webview, Settings settings) -> void
+{
+  state_of(webview)->settings = settings;
+}
+
+auto set_setup_time(std::chrono::nanoseconds time) -> void
+{
+  setup_time_ns.store(time.count(), std::memory_order_relaxed);
+}
+
+auto parent_window(WebView const& webview) -> WindowHandle
+{
+  return state_of(webview)->parent;
+}
+
+auto pump(WebView& webview) -> std::size_t
+{
+  auto* state = state_of(webview);
+  auto& queue = state->queues[state->back];
+  state->back ^= 1;
+
+  auto const count = queue.count;
+  queue.count      = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!webview.on_message) {
+      continue;
+    }
+    if (state->settings.wide_strings) {
+      webview.on_message(details::wstring_to_utf8(queue.wide_slots[i]));
+    }
+    else {
+      webview.on_message(queue.slots[i]);
+    }
+  }
+  return count;
+}
+
+auto pump(WebView& webview, MessageReceiver& receiver) -> std::size_t
+{
+  auto* state = state_of(webview);
+  auto& queue = state->queues[state->back];
+  state->back ^= 1;
+
+  auto const count = queue.count;
+  queue.count      = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (state->settings.wide_strings) {
+      receiver.receive(std::wstring_view(queue.wide_slots[i]));
+    }
+    else {
+      receiver.receive(std::string_view(queue.slots[i]));
+    }
+  }
+  return count;
+}
+
+auto pending(WebView const& webview) -> std::size_t
+{
+  auto* state = state_of(webview);
+  return state->queues[state->back].count;
+}
+
+auto press_key(WebView& webview, WebView::AcceleratorKey key) -> bool
+{
+  if (!webview.on_accelerator_key) {
+    return false;
+  }
+  webview.on_accelerator_key(key);
+  return true;
+}
+
+auto quit() -> void
+{
+  auto& state = loop();
+  {
+    auto lock  = std::lock_guard(state.mutex);
+    state.quit = true;
+  }
+  state.wake.notify_one();
+}
+
+} // namespace loopback
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Window.hpp>
+#include <UBytes/AppPlatform/WebView/MessageReceiver.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A headless, in-process implementation of the platform interface (`WebView`,
+/// `Window`, `run_default()`), for benchmarks. `run_default()` drains `ui_queue()`.
+///
+/// The loopback page echoes every message back: `send_message()` copies the
+/// message (like a real backend hands it to the browser) and `pump()` delivers
+/// the copies to `WebView::on_message` on the calling thread.
+namespace loopback
+{
+
+struct Settings
+{
+  /// Passes the messages as wide strings, like WebView2 does, so the conversions are measured too.
+  bool wide_strings = false;
+};
+
+/// Configures a WebView. Call before `begin_setup()`.
+auto configure(WebView& webview, Settings settings) -> void;
+
+/// Sets the time from `WebView::begin_setup()` to `on_ready`, the time a real backend takes
+/// to create the browser environment and the page. 0 (the default) calls `on_ready` from
+/// the next `UiQueue` drain. The setups run concurrently, like they do in a real backend.
+auto set_setup_time(std::chrono::nanoseconds time) -> void;
+
+/// Returns the window a WebView was set up in or moved to with `set_parent_window()`.
+auto parent_window(WebView const& webview) -> WindowHandle;
+
+/// Delivers the echoed messages of a WebView to `on_message`, one `std::string` each like
+/// the library does.
+/// @return The number of messages delivered.
+auto pump(WebView& webview) -> std::size_t;
+
+/// Delivers the echoed messages of a WebView to `receiver.receive()` as views, like a backend
+/// that doesn't construct a `std::string` per message.
+/// @return The number of messages delivered.
+auto pump(WebView& webview, MessageReceiver& receiver) -> std::size_t;
+
+/// Returns the number of echoed messages waiting for `pump()`.
+auto pending(WebView const& webview) -> std::size_t;
+
+/// Delivers a key press like the browser would, to `WebView::on_accelerator_key`.
+/// @return true if a handler was set.
+auto press_key(WebView& webview, WebView::AcceleratorKey key) -> bool;
+
+/// Asks `run_default()` to return.
+auto quit() -> void;
+
+} // namespace loopback
+
+} // namespace app_platform
+} // namespace ubytes
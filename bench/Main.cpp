@@ -0,0 +1,314 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+std::atomic<std::uint64_t> allocations = 0;
+
+auto aligned_free(void* memory) noexcept -> void
+{
+#if defined(_WIN32)
+  _aligned_free(memory);
+#else
+  std::free(memory);
+#endif
+}
+
+} // namespace
+
+// Every allocation is counted, for the allocations per operation.
+
+auto operator new(std::size_t size) -> void*
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void*
+{
+  return ::operator new(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  auto const align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+  auto* memory = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+  auto* memory = std::aligned_alloc(align, (size + align) / align * align);
+#endif
+  if (memory) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void*
+{
+  return ::operator new(size, alignment);
+}
+
+auto operator delete(void* memory) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete[](void* memory) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete(void* memory, std::size_t) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete[](void* memory, std::size_t) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete(void* memory, std::align_val_t) noexcept -> void
+{
+  aligned_free(memory);
+}
+
+auto operator delete[](void* memory, std::align_val_t) noexcept -> void
+{
+  aligned_free(memory);
+}
+
+auto operator delete(void* memory, std::size_t, std::align_val_t) noexcept -> void
+{
+  aligned_free(memory);
+}
+
+auto operator delete[](void* memory, std::size_t, std::align_val_t) noexcept -> void
+{
+  aligned_free(memory);
+}
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+
+namespace
+{
+
+struct Entry
+{
+  std::string name;
+  Function    function;
+};
+
+auto registry() -> std::vector<Entry>&
+{
+  static auto entries = std::vector<Entry>();
+  return entries;
+}
+
+auto write_json(std::vector<Result> const& results, std::FILE* file) -> void
+{
+  auto writer = JsonWriter();
+  writer.begin_object();
+  writer.field("suite", "AppPlatform_bench");
+  writer.field("simd", simd_level_name(simd_level()));
+#if defined(__clang__)
+  writer.field("compiler", "clang " __clang_version__);
+#elif defined(__GNUC__)
+  writer.field("compiler", "gcc " __VERSION__);
+#elif defined(_MSC_VER)
+  writer.field("compiler", "msvc");
+#endif
+  writer.key("benchmarks").begin_array();
+  for (auto const& result : results) {
+    writer.begin_object();
+    writer.field("name", std::string_view(result.name));
+    writer.field("operations", result.operations);
+    writer.field("seconds", result.seconds);
+    writer.field("ns_per_op", result.ns_per_op);
+    writer.field("ops_per_second", result.ops_per_second);
+    writer.field("allocations_per_op", result.allocations_per_op);
+    if (result.bytes_per_second > 0) {
+      writer.field("bytes_per_second", result.bytes_per_second);
+    }
+    for (auto const& [name, value] : result.metrics) {
+      writer.field(name, value);
+    }
+    writer.end_object();
+  }
+  writer.end_array();
+  writer.end_object();
+
+  auto const json = writer.view();
+  std::fwrite(json.data(), 1, json.size(), file);
+  std::fputc('\n', file);
+}
+
+auto print_result(Result const& result) -> void
+{
+  std::printf(
+    "%-48s %12.1f ns/op %14.0f ops/s %8.2f allocs/op",
+    result.name.c_str(),
+    result.ns_per_op,
+    result.ops_per_second,
+    result.allocations_per_op
+  );
+  if (result.bytes_per_second > 0) {
+    std::printf(" %9.2f MB/s", result.bytes_per_second / 1e6);
+  }
+  for (auto const& [name, value] : result.metrics) {
+    std::printf(" %s=%.1f", name.c_str(), value);
+  }
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+auto print_usage() -> void
+{
+  std::printf(
+    "Usage: AppPlatform_bench [--filter <text>] [--min-time <ms>] [--json <file>|-] [--list]\n"
+    "  --filter    runs the benchmarks whose name contains the text\n"
+    "  --min-time  the minimum measured time of every benchmark (default: 200 ms)\n"
+    "  --json      writes the results as JSON to a file, or to stdout with '-'\n"
+    "  --list      lists the benchmarks\n"
+  );
+}
+
+} // namespace
+
+auto allocation_count() noexcept -> std::uint64_t
+{
+  return allocations.load(std::memory_order_relaxed);
+}
+
+auto register_benchmark(std::string name, Function function) -> bool
+{
+  registry().push_back(Entry{std::move(name), std::move(function)});
+  return true;
+}
+
+auto Context::add_percentiles(std::string_view prefix, std::vector<std::int64_t> samples) -> void
+{
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  for (auto const percentile : {50, 90, 99}) {
+    auto const index = std::min(samples.size() - 1, samples.size() * percentile / 100);
+    add_metric(std::string(prefix) + "_p" + std::to_string(percentile) + "_ns", static_cast<double>(samples[index]));
+  }
+}
+
+auto Context::result(std::string name) -> Result
+{
+  auto result = std::move(_result);
+  result.name = std::move(name);
+  if (result.operations > 0 && result.seconds > 0) {
+    result.ns_per_op        = result.seconds * 1e9 / static_cast<double>(result.operations);
+    result.ops_per_second   = static_cast<double>(result.operations) / result.seconds;
+    result.bytes_per_second = _bytes_per_op * result.ops_per_second;
+  }
+  return result;
+}
+
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
+
+auto main(int argc, char** argv) -> int
+{
+  using namespace ubytes::app_platform::bench;
+
+  auto filter   = std::string_view();
+  auto json     = std::string_view();
+  auto min_time = std::chrono::milliseconds(200);
+  auto list     = false;
+
+  for (int i = 1; i < argc; ++i) {
+    auto const arg = std::string_view(argv[i]);
+    if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    }
+    else if (arg == "--json" && i + 1 < argc) {
+      json = argv[++i];
+    }
+    else if (arg == "--min-time" && i + 1 < argc) {
+      auto const value = std::string_view(argv[++i]);
+      auto       ms    = std::int64_t(0);
+      std::from_chars(value.data(), value.data() + value.size(), ms);
+      min_time = std::chrono::milliseconds(std::max<std::int64_t>(ms, 1));
+    }
+    else if (arg == "--list") {
+      list = true;
+    }
+    else {
+      print_usage();
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  auto entries = registry();
+  std::stable_sort(
+    entries.begin(),
+    entries.end(),
+    [](auto const& a, auto const& b)
+    {
+      return a.name < b.name;
+    }
+  );
+
+  auto results = std::vector<Result>();
+  for (auto const& entry : entries) {
+    if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    if (list) {
+      std::printf("%s\n", entry.name.c_str());
+      continue;
+    }
+
+    auto context = Context(min_time);
+    entry.function(context);
+    if (context.skipped()) {
+      continue;
+    }
+    results.push_back(context.result(entry.name));
+    if (json != "-") {
+      print_result(results.back());
+    }
+  }
+
+  if (json == "-") {
+    write_json(results, stdout);
+  }
+  else if (!json.empty()) {
+    auto* file = std::fopen(std::string(json).c_str(), "wb");
+    if (!file) {
+      std::fprintf(stderr, "Cannot open %s\n", std::string(json).c_str());
+      return 1;
+    }
+    write_json(results, file);
+    std::fclose(file);
+  }
+  return 0;
+}
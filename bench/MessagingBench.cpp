@@ -0,0 +1,291 @@
+#include "Bench.hpp"
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/WebView/MessageBatcher.hpp>
+#include <UBytes/AppPlatform/WebView/MessageReceiver.hpp>
+
+#include <string>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+enum class Handler
+{
+  /// `WebView::on_message`, a `std::string` per message.
+  OnMessage,
+  /// A `MessageReceiver` attached to `on_message`: the same string, copied to a pooled buffer.
+  Receiver,
+  /// A `MessageReceiver` fed with views, as by a backend that has no `std::string` to construct.
+  ReceiverView,
+};
+
+/// A typical UI update (~100 bytes) and a large one (~4 KiB).
+auto make_message(std::size_t size) -> std::string
+{
+  auto message = std::string(R"({"type":"update","id":1234,"values":[1,2,3,4],"text":")");
+  while (message.size() + 2 < size) {
+    message += "row \xC5\xBC\xC3\xB3\xC5\x82w ";
+  }
+  message += "\"}";
+  return message;
+}
+
+/// A loopback WebView and the handler the echoed messages are delivered to.
+class Endpoint
+{
+public:
+  Endpoint(Handler handler, loopback::Settings settings, std::size_t& received)
+    : _handler(handler)
+    , _receiver(
+        [&received](MessageBuffer const& message)
+        {
+          received += message.size();
+        }
+      )
+  {
+    loopback::configure(webview, settings);
+    if (handler == Handler::OnMessage) {
+      webview.on_message = [&received](std::string message)
+      {
+        received += message.size();
+      };
+    }
+    else if (handler == Handler::Receiver) {
+      _receiver.attach(webview);
+    }
+  }
+
+  /// Delivers the echoed messages.
+  auto pump() -> void
+  {
+    if (_handler == Handler::ReceiverView) {
+      loopback::pump(webview, _receiver);
+    }
+    else {
+      loopback::pump(webview);
+    }
+  }
+
+  WebView webview;
+
+private:
+  Handler         _handler;
+  MessageReceiver _receiver;
+};
+
+/// One message to the page and back: `send_message()`, the echo and the handler.
+auto round_trip(Context& context, Handler handler, loopback::Settings settings, std::size_t size) -> void
+{
+  auto       received = std::size_t(0);
+  auto       endpoint = Endpoint(handler, settings, received);
+  auto const message  = make_message(size);
+
+  auto const once = [&]
+  {
+    endpoint.webview.send_message(message);
+    endpoint.pump();
+  };
+
+  context.measure(1, once);
+  context.set_bytes_per_op(static_cast<double>(message.size()));
+
+  auto samples = std::vector<std::int64_t>();
+  samples.reserve(10000);
+  for (std::size_t i = 0; i < 10000; ++i) {
+    auto const start = Context::Clock::now();
+    once();
+    samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Context::Clock::now() - start).count());
+  }
+  context.add_percentiles("latency", std::move(samples));
+  do_not_optimize(received);
+}
+
+/// Bursts of messages, delivered by one pump: the messages per second.
+auto throughput(Context& context, Handler handler, loopback::Settings settings) -> void
+{
+  constexpr std::size_t BURST = 256;
+
+  auto       received = std::size_t(0);
+  auto       endpoint = Endpoint(handler, settings, received);
+  auto const message  = make_message(100);
+
+  context.measure(
+    BURST,
+    [&]
+    {
+      for (std::size_t i = 0; i < BURST; ++i) {
+        endpoint.webview.send_message(message);
+      }
+      endpoint.pump();
+    }
+  );
+  context.set_bytes_per_op(static_cast<double>(message.size()));
+  do_not_optimize(received);
+}
+
+UBYTES_BENCH(
+  "messaging/round_trip/on_message/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::OnMessage, {}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/on_message/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::OnMessage, {}, 4096);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::Receiver, {}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::Receiver, {}, 4096);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver_view/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::ReceiverView, {}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver_view/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::ReceiverView, {}, 4096);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/on_message/wide/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::OnMessage, {.wide_strings = true}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/on_message/wide/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::OnMessage, {.wide_strings = true}, 4096);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver/wide/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::Receiver, {.wide_strings = true}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver/wide/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::Receiver, {.wide_strings = true}, 4096);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver_view/wide/100B",
+  [](Context& context)
+  {
+    round_trip(context, Handler::ReceiverView, {.wide_strings = true}, 100);
+  }
+);
+UBYTES_BENCH(
+  "messaging/round_trip/receiver_view/wide/4KiB",
+  [](Context& context)
+  {
+    round_trip(context, Handler::ReceiverView, {.wide_strings = true}, 4096);
+  }
+);
+
+UBYTES_BENCH(
+  "messaging/throughput/on_message",
+  [](Context& context)
+  {
+    throughput(context, Handler::OnMessage, {});
+  }
+);
+UBYTES_BENCH(
+  "messaging/throughput/receiver",
+  [](Context& context)
+  {
+    throughput(context, Handler::Receiver, {});
+  }
+);
+UBYTES_BENCH(
+  "messaging/throughput/receiver_view",
+  [](Context& context)
+  {
+    throughput(context, Handler::ReceiverView, {});
+  }
+);
+UBYTES_BENCH(
+  "messaging/throughput/on_message/wide",
+  [](Context& context)
+  {
+    throughput(context, Handler::OnMessage, {.wide_strings = true});
+  }
+);
+UBYTES_BENCH(
+  "messaging/throughput/receiver/wide",
+  [](Context& context)
+  {
+    throughput(context, Handler::Receiver, {.wide_strings = true});
+  }
+);
+UBYTES_BENCH(
+  "messaging/throughput/receiver_view/wide",
+  [](Context& context)
+  {
+    throughput(context, Handler::ReceiverView, {.wide_strings = true});
+  }
+);
+
+UBYTES_BENCH(
+  "messaging/batcher/send",
+  [](Context& context)
+  {
+    constexpr std::size_t BURST = 256;
+
+    auto       received = std::size_t(0);
+    auto       endpoint = Endpoint(Handler::ReceiverView, {}, received);
+    auto       batcher  = MessageBatcher(endpoint.webview);
+    auto const message  = make_message(100);
+
+    context.measure(
+      BURST,
+      [&]
+      {
+        for (std::size_t i = 0; i < BURST; ++i) {
+          batcher.send(message);
+        }
+        batcher.flush();
+        endpoint.pump();
+      }
+    );
+    context.set_bytes_per_op(static_cast<double>(message.size()));
+    do_not_optimize(received);
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,214 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Pixels.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+/// A 1024x1024 texture preview.
+constexpr std::size_t PIXELS = 1024 * 1024;
+
+auto make_floats() -> std::vector<Color4f>
+{
+  auto pixels = std::vector<Color4f>(PIXELS);
+  for (std::size_t i = 0; i < PIXELS; ++i) {
+    auto const x = float(i % 1024) / 1024.0f;
+    auto const y = float(i / 1024) / 1024.0f;
+    pixels[i]    = Color4f(x, y, 1.0f - x, 0.5f + 0.5f * y);
+  }
+  return pixels;
+}
+
+auto make_bytes() -> std::vector<Color4u>
+{
+  auto const floats = make_floats();
+  auto       pixels = std::vector<Color4u>(PIXELS);
+  convert_colors(floats, pixels);
+  return pixels;
+}
+
+/// Registers `fn(context, level)` for every instruction set level. The operations are pixels.
+template <typename Fn>
+auto register_levels(std::string const& name, Fn fn) -> void
+{
+  for (auto const level : SIMD_LEVELS) {
+    register_benchmark(
+      name + "/" + std::string(simd_level_name(level)),
+      [fn, level](Context& context)
+      {
+        if (context.require(level)) {
+          fn(context, level);
+        }
+      }
+    );
+  }
+}
+
+[[maybe_unused]] auto const registered = []
+{
+  register_levels(
+    "pixels/float_to_u8",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = make_floats();
+      auto       out = std::vector<Color4u>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          convert_colors(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4f));
+    }
+  );
+  register_levels(
+    "pixels/u8_to_float",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = make_bytes();
+      auto       out = std::vector<Color4f>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          convert_colors(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4u));
+    }
+  );
+  register_levels(
+    "pixels/premultiply_u8",
+    [](Context& context, SimdLevel level)
+    {
+      auto pixels = make_bytes();
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          premultiply_alpha(pixels, level);
+          do_not_optimize(pixels.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4u));
+    }
+  );
+  register_levels(
+    "pixels/unpremultiply_u8",
+    [](Context& context, SimdLevel level)
+    {
+      auto pixels = make_bytes();
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          unpremultiply_alpha(pixels, level);
+          do_not_optimize(pixels.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4u));
+    }
+  );
+  register_levels(
+    "pixels/premultiply_float",
+    [](Context& context, SimdLevel level)
+    {
+      auto pixels = make_floats();
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          premultiply_alpha(pixels, level);
+          do_not_optimize(pixels.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4f));
+    }
+  );
+  register_levels(
+    "pixels/srgb_to_linear",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = make_bytes();
+      auto       out = std::vector<Color4f>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          srgb_to_linear(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4u));
+    }
+  );
+  register_levels(
+    "pixels/linear_to_srgb",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = make_floats();
+      auto       out = std::vector<Color4u>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          linear_to_srgb(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4f));
+    }
+  );
+  register_levels(
+    "pixels/rgb_to_rgba",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = std::vector<Color3u>(PIXELS, Color3u(10, 20, 30));
+      auto       out = std::vector<Color4u>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          convert_colors(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color3u));
+    }
+  );
+  register_levels(
+    "pixels/rgba_to_rgb",
+    [](Context& context, SimdLevel level)
+    {
+      auto const in  = make_bytes();
+      auto       out = std::vector<Color3u>(PIXELS);
+      context.measure(
+        PIXELS,
+        [&]
+        {
+          convert_colors(in, out, level);
+          do_not_optimize(out.data());
+        }
+      );
+      context.set_bytes_per_op(sizeof(Color4u));
+    }
+  );
+  return true;
+}();
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
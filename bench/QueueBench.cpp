@@ -0,0 +1,213 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/App/TaskPool.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t TASKS = 1024;
+
+UBYTES_BENCH(
+  "ui_queue/post_drain",
+  [](Context& context)
+  {
+    auto queue = UiQueue();
+    auto count = std::size_t(0);
+    context.measure(
+      TASKS,
+      [&]
+      {
+        for (std::size_t i = 0; i < TASKS; ++i) {
+          queue.post(
+            [&count]
+            {
+              ++count;
+            }
+          );
+        }
+        queue.drain();
+      }
+    );
+    do_not_optimize(count);
+  }
+);
+
+/// Several threads post while the measuring thread drains, like workers handing results to the UI.
+auto producers(Context& context, std::size_t threads) -> void
+{
+  auto       queue = UiQueue();
+  auto       count = std::size_t(0);
+  auto const posts = TASKS / threads;
+  context.measure(
+    posts * threads,
+    [&]
+    {
+      auto const expected = count + posts * threads;
+      auto       workers  = std::vector<std::thread>();
+      for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(
+          [&queue, &count, posts]
+          {
+            for (std::size_t i = 0; i < posts; ++i) {
+              queue.post(
+                [&count]
+                {
+                  ++count;
+                }
+              );
+            }
+          }
+        );
+      }
+      while (count != expected) {
+        if (queue.drain() == 0) {
+          std::this_thread::yield();
+        }
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    }
+  );
+  do_not_optimize(count);
+}
+
+[[maybe_unused]] auto const registered_producers = []
+{
+  for (auto const threads : {1, 2, 4, 8, 16}) {
+    register_benchmark(
+      "ui_queue/producers/" + std::to_string(threads),
+      [threads](Context& context)
+      {
+        producers(context, static_cast<std::size_t>(threads));
+      }
+    );
+  }
+  return true;
+}();
+
+auto submit(Context& context, std::size_t threads) -> void
+{
+  auto ui   = UiQueue();
+  auto pool = TaskPool(TaskPoolSettings{.threads = threads, .ui = &ui});
+  auto done = std::atomic<std::size_t>(0);
+  context.measure(
+    TASKS,
+    [&]
+    {
+      done.store(0, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < TASKS; ++i) {
+        pool.submit(
+          [&done]
+          {
+            done.fetch_add(1, std::memory_order_release);
+          }
+        );
+      }
+      while (done.load(std::memory_order_acquire) != TASKS) {
+        std::this_thread::yield();
+      }
+    }
+  );
+}
+
+/// The submit overhead: the tasks are empty.
+UBYTES_BENCH(
+  "task_pool/submit/1",
+  [](Context& context)
+  {
+    submit(context, 1);
+  }
+);
+UBYTES_BENCH(
+  "task_pool/submit/4",
+  [](Context& context)
+  {
+    submit(context, 4);
+  }
+);
+
+/// A CPU-bound task: a chain of multiplications that stays in the registers.
+auto compute(std::uint64_t seed) -> std::uint64_t
+{
+  auto value = seed | 1;
+  for (std::size_t i = 0; i < 10'000; ++i) {
+    value ^= value >> 29;
+    value *= 0xBF58476D1CE4E5B9u;
+  }
+  return value;
+}
+
+/// The work spread over `threads` workers: the time per task drops with the workers while
+/// there are cores for them, the submit overhead stays out of the way.
+auto scaling(Context& context, std::size_t threads) -> void
+{
+  constexpr std::size_t SCALING_TASKS = 256;
+
+  auto ui   = UiQueue();
+  auto pool = TaskPool(TaskPoolSettings{.threads = threads, .ui = &ui});
+  auto done = std::atomic<std::size_t>(0);
+  auto sum  = std::atomic<std::uint64_t>(0);
+  context.measure(
+    SCALING_TASKS,
+    [&]
+    {
+      done.store(0, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < SCALING_TASKS; ++i) {
+        pool.submit(
+          [&done, &sum, i]
+          {
+            sum.fetch_add(compute(i), std::memory_order_relaxed);
+            done.fetch_add(1, std::memory_order_release);
+          }
+        );
+      }
+      while (done.load(std::memory_order_acquire) != SCALING_TASKS) {
+        std::this_thread::yield();
+      }
+    }
+  );
+  do_not_optimize(sum.load(std::memory_order_relaxed));
+  context.add_metric("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()));
+}
+
+[[maybe_unused]] auto const registered_scaling = []
+{
+  // Powers of two up to the hardware threads, and the hardware threads themselves.
+  auto const hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  auto       counts   = std::vector<std::size_t>();
+  for (std::size_t threads = 1; threads < hardware; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(hardware);
+
+  for (auto const threads : counts) {
+    register_benchmark(
+      "task_pool/scaling/" + std::to_string(threads),
+      [threads](Context& context)
+      {
+        scaling(context, threads);
+      }
+    );
+  }
+  return true;
+}();
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
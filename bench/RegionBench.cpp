@@ -0,0 +1,164 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Region.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::int32_t WIDTH  = 1600;
+constexpr std::int32_t HEIGHT = 900;
+constexpr std::size_t  POINTS = 4096;
+
+/// A tab opened next to the last one of the layout.
+constexpr auto NEW_TAB = Rect2i{330 + 14 * 72, 6, 68, 34};
+
+/// The draggable and non-draggable regions of a borderless editor window: a title bar with a
+/// tab strip, menus and caption buttons, and a toolbar with drag gaps between the button groups.
+struct Layout
+{
+  std::vector<Rect2i> drag;
+  std::vector<Rect2i> no_drag;
+};
+
+auto make_layout() -> Layout
+{
+  auto layout = Layout();
+  layout.drag.push_back(Rect2i{0, 0, WIDTH, 40});
+  layout.no_drag.push_back(Rect2i{WIDTH - 138, 0, 138, 32}); // Caption buttons.
+  for (std::int32_t i = 0; i < 6; ++i) {
+    layout.no_drag.push_back(Rect2i{8 + i * 52, 4, 48, 32}); // Menus.
+  }
+  for (std::int32_t i = 0; i < 14; ++i) {
+    layout.no_drag.push_back(Rect2i{330 + i * 72, 6, 68, 34}); // Tabs.
+  }
+  for (std::int32_t group = 0; group < 8; ++group) {
+    layout.drag.push_back(Rect2i{group * 200, 40, 200, 36});
+    for (std::int32_t i = 0; i < 5; ++i) {
+      layout.no_drag.push_back(Rect2i{group * 200 + 8 + i * 30, 44, 28, 28}); // Toolbar buttons.
+    }
+  }
+  layout.drag.push_back(Rect2i{0, HEIGHT - 24, WIDTH, 24}); // Status bar.
+  layout.no_drag.push_back(Rect2i{WIDTH - 200, HEIGHT - 22, 180, 20});
+  return layout;
+}
+
+/// Mouse positions, most of them near the top of the window like while dragging it.
+auto make_points() -> std::vector<Vec2i>
+{
+  auto points = std::vector<Vec2i>(POINTS);
+  auto state  = std::uint32_t(1);
+  for (auto& point : points) {
+    state        = state * 1664525u + 1013904223u;
+    auto const x = std::int32_t((state >> 8) % WIDTH);
+    state        = state * 1664525u + 1013904223u;
+    auto const y = std::int32_t((state >> 8) % (state & 1 ? 120 : HEIGHT));
+    point        = Vec2i(x, y);
+  }
+  return points;
+}
+
+auto make_region(Layout const& layout) -> Region2i
+{
+  auto region = Region2i(layout.drag);
+  for (auto const& rect : layout.no_drag) {
+    region.subtract(rect);
+  }
+  return region;
+}
+
+UBYTES_BENCH(
+  "region/hit_test/region",
+  [](Context& context)
+  {
+    auto const layout = make_layout();
+    auto const region = make_region(layout);
+    auto const points = make_points();
+    auto       hits   = std::size_t(0);
+    context.measure(
+      POINTS,
+      [&]
+      {
+        for (auto const point : points) {
+          hits += region.contains(point);
+        }
+      }
+    );
+    context.add_metric("rects", static_cast<double>(layout.drag.size() + layout.no_drag.size()));
+    context.add_metric("bands", static_cast<double>(region.band_count()));
+    do_not_optimize(hits);
+  }
+);
+
+/// The baseline: in a drag rectangle and in none of the no-drag ones.
+UBYTES_BENCH(
+  "region/hit_test/linear_scan",
+  [](Context& context)
+  {
+    auto const layout = make_layout();
+    auto const points = make_points();
+    auto       hits   = std::size_t(0);
+    context.measure(
+      POINTS,
+      [&]
+      {
+        for (auto const point : points) {
+          auto const in = [point](Rect2i const& rect)
+          {
+            return rect.contains(point);
+          };
+          hits += std::any_of(layout.drag.begin(), layout.drag.end(), in) &&
+                  std::none_of(layout.no_drag.begin(), layout.no_drag.end(), in);
+        }
+      }
+    );
+    do_not_optimize(hits);
+  }
+);
+
+/// A tab is added and closed: the incremental update versus rebuilding from the rectangles.
+UBYTES_BENCH(
+  "region/update/incremental",
+  [](Context& context)
+  {
+    auto const layout = make_layout();
+    auto       region = make_region(layout);
+    context.measure(
+      2,
+      [&]
+      {
+        region.subtract(NEW_TAB);
+        region.add(NEW_TAB);
+      }
+    );
+    do_not_optimize(region.band_count());
+  }
+);
+
+UBYTES_BENCH(
+  "region/update/rebuild",
+  [](Context& context)
+  {
+    auto const layout = make_layout();
+    context.measure(
+      1,
+      [&]
+      {
+        do_not_optimize(make_region(layout).band_count());
+      }
+    );
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,142 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/App/ResizeScheduler.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+using namespace std::chrono_literals;
+
+/// A 100 ms drag-resize with an event every 0.5 ms (a high polling rate mouse), where
+/// every applied size costs the page a 2 ms relayout.
+constexpr std::size_t EVENTS          = 200;
+constexpr auto        EVENT_INTERVAL  = 500us;
+constexpr auto        RELAYOUT        = 2ms;
+constexpr auto        DEFERRED_SETTLE = 30ms;
+
+auto relayout() -> void
+{
+  auto const end = Context::Clock::now() + RELAYOUT;
+  while (Context::Clock::now() < end) {
+  }
+}
+
+/// Plays the drag like the UI loop would: the events arrive on time unless the loop is
+/// busy, and the loop runs the UI queue in between. Waits until `pending()` is false.
+/// @return The lag: the time from when the last event was due (the mouse stopped) to the last relayout done.
+template <typename Resize>
+auto drag(Resize&& resize, std::function<bool()> const& pending) -> Context::Clock::duration
+{
+  auto const start = Context::Clock::now();
+  for (std::size_t i = 0; i < EVENTS; ++i) {
+    while (Context::Clock::now() < start + EVENT_INTERVAL * i) {
+      ui_queue().drain();
+    }
+    resize(Rect2i{0, 0, std::int32_t(800 + i), std::int32_t(600 + i / 2)});
+  }
+  while (pending()) {
+    ui_queue().drain();
+  }
+  return Context::Clock::now() - (start + EVENT_INTERVAL * (EVENTS - 1));
+}
+
+auto report(Context& context, std::uint64_t applied, std::uint64_t drags, Context::Clock::duration lag) -> void
+{
+  context.add_metric("events", EVENTS);
+  context.add_metric("relayouts", static_cast<double>(applied) / static_cast<double>(drags));
+  context.add_metric("lag_ms", std::chrono::duration<double, std::milli>(lag).count());
+}
+
+/// The baseline: `WebView::set_bounds` and a relayout on every `Window::on_resize`.
+UBYTES_BENCH(
+  "resize/drag/direct",
+  [](Context& context)
+  {
+    auto applied = std::uint64_t(0);
+    auto drags   = std::uint64_t(0);
+    auto lag     = Context::Clock::duration();
+    context.measure(
+      1,
+      [&]
+      {
+        ++drags;
+        lag = drag(
+          [&applied](Rect2i)
+          {
+            ++applied;
+            relayout();
+          },
+          []
+          {
+            return false;
+          }
+        );
+      }
+    );
+    report(context, applied, drags, lag);
+  }
+);
+
+auto scheduled(Context& context, ResizeSettings settings) -> void
+{
+  auto scheduler = ResizeScheduler(
+    [](Rect2i)
+    {
+      relayout();
+    },
+    settings
+  );
+  auto drags = std::uint64_t(0);
+  auto lag   = Context::Clock::duration();
+  context.measure(
+    1,
+    [&]
+    {
+      ++drags;
+      lag = drag(
+        [&scheduler](Rect2i bounds)
+        {
+          scheduler.resize(bounds);
+        },
+        [&scheduler]
+        {
+          return scheduler.pending();
+        }
+      );
+    }
+  );
+
+  auto const stats = scheduler.stats();
+  report(context, stats.applied, drags, lag);
+  context.add_metric("coalesced", static_cast<double>(stats.coalesced) / static_cast<double>(drags));
+}
+
+UBYTES_BENCH(
+  "resize/drag/live",
+  [](Context& context)
+  {
+    scheduled(context, ResizeSettings{.mode = ResizeMode::Live});
+  }
+);
+
+UBYTES_BENCH(
+  "resize/drag/deferred",
+  [](Context& context)
+  {
+    scheduled(context, ResizeSettings{.mode = ResizeMode::Deferred, .settle_time = DEFERRED_SETTLE});
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,231 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/WebView/Rpc.hpp>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+constexpr std::size_t CALLS = 1024;
+
+struct OpenArchive
+{
+  static constexpr std::string_view name = "openArchive";
+};
+
+struct CloseArchive
+{
+  static constexpr std::string_view name = "closeArchive";
+};
+
+struct ListFiles
+{
+  static constexpr std::string_view name = "listFiles";
+};
+
+struct ExtractFiles
+{
+  static constexpr std::string_view name = "extractFiles";
+};
+
+struct TestArchive
+{
+  static constexpr std::string_view name = "testArchive";
+};
+
+struct GetProperties
+{
+  static constexpr std::string_view name = "getProperties";
+};
+
+struct SetPassword
+{
+  static constexpr std::string_view name = "setPassword";
+};
+
+struct CancelTask
+{
+  static constexpr std::string_view name = "cancelTask";
+};
+
+using Endpoint = Rpc<OpenArchive, CloseArchive, ListFiles, ExtractFiles, TestArchive, GetProperties, SetPassword, CancelTask>;
+
+using HandlerMap = std::unordered_map<std::string, std::function<void(RpcRequest const&)>>;
+using IndexMap   = std::unordered_map<std::string, std::size_t>;
+
+constexpr auto METHOD_NAMES = std::array<std::string_view, 8>{
+  OpenArchive::name,
+  CloseArchive::name,
+  ListFiles::name,
+  ExtractFiles::name,
+  TestArchive::name,
+  GetProperties::name,
+  SetPassword::name,
+  CancelTask::name,
+};
+
+/// The calls `js/Rpc.js` sends, spread over the methods.
+auto make_calls() -> std::vector<std::string>
+{
+  auto calls  = std::vector<std::string>();
+  auto writer = JsonWriter();
+  for (std::size_t i = 0; i < CALLS; ++i) {
+    writer.reset();
+    writer.begin_object();
+    writer.field("__rpc", METHOD_NAMES[i % METHOD_NAMES.size()]);
+    writer.field("id", i + 1);
+    writer.key("params").begin_object();
+    writer.field("path", "C:/Users/user/Downloads/archive.7z");
+    writer.field("index", i);
+    writer.end_object();
+    writer.end_object();
+    calls.emplace_back(writer.view());
+  }
+  return calls;
+}
+
+/// Replies are written to the channel's sink, which drops them.
+auto null_sink() -> RpcChannel::Sink
+{
+  return [](std::string_view message)
+  {
+    do_not_optimize(message.size());
+  };
+}
+
+auto handler(std::size_t& sum) -> std::function<void(RpcRequest const&)>
+{
+  return [&sum](RpcRequest const& request)
+  {
+    sum += request.params.size();
+    request.reply("true");
+  };
+}
+
+/// `Rpc::receive`: parsing, the `PerfectHash` lookup and the handler call.
+UBYTES_BENCH(
+  "rpc/receive/perfect_hash",
+  [](Context& context)
+  {
+    auto const calls = make_calls();
+    auto       sum   = std::size_t(0);
+    auto       rpc   = Endpoint(null_sink());
+    rpc.on<OpenArchive>(handler(sum));
+    rpc.on<CloseArchive>(handler(sum));
+    rpc.on<ListFiles>(handler(sum));
+    rpc.on<ExtractFiles>(handler(sum));
+    rpc.on<TestArchive>(handler(sum));
+    rpc.on<GetProperties>(handler(sum));
+    rpc.on<SetPassword>(handler(sum));
+    rpc.on<CancelTask>(handler(sum));
+
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (auto const& call : calls) {
+          rpc.receive(call);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+/// The baseline: the same parsing and replies, dispatched through a map of the method names.
+UBYTES_BENCH(
+  "rpc/receive/unordered_map",
+  [](Context& context)
+  {
+    auto const calls    = make_calls();
+    auto       sum      = std::size_t(0);
+    auto       channel  = RpcChannel(null_sink());
+    auto       reader   = JsonReader();
+    auto       handlers = HandlerMap();
+    for (auto const name : METHOD_NAMES) {
+      handlers.emplace(name, handler(sum));
+    }
+
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (auto const& call : calls) {
+          auto const parsed = details::parse_rpc_message(reader, call);
+          if (!parsed) {
+            continue;
+          }
+          auto const it = handlers.find(std::string(parsed->method));
+          if (it == handlers.end()) {
+            channel.reply_error(parsed->id, "unknown method");
+            continue;
+          }
+          it->second(RpcRequest{&channel, parsed->id, parsed->method, parsed->payload});
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+/// The lookups alone, without the parsing and the handlers.
+UBYTES_BENCH(
+  "rpc/lookup/perfect_hash",
+  [](Context& context)
+  {
+    auto sum = std::size_t(0);
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (std::size_t i = 0; i < CALLS; ++i) {
+          auto const name = METHOD_NAMES[i % METHOD_NAMES.size()];
+          do_not_optimize(name.data());
+          sum += Endpoint::METHODS.find(name);
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+UBYTES_BENCH(
+  "rpc/lookup/unordered_map",
+  [](Context& context)
+  {
+    auto sum     = std::size_t(0);
+    auto indices = IndexMap();
+    for (std::size_t i = 0; i < METHOD_NAMES.size(); ++i) {
+      indices.emplace(METHOD_NAMES[i], i);
+    }
+    context.measure(
+      CALLS,
+      [&]
+      {
+        for (std::size_t i = 0; i < CALLS; ++i) {
+          auto const name = METHOD_NAMES[i % METHOD_NAMES.size()];
+          do_not_optimize(name.data());
+          sum += indices.find(std::string(name))->second;
+        }
+      }
+    );
+    do_not_optimize(sum);
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,182 @@
+#include "Bench.hpp"
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/App.hpp>
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+using namespace std::chrono_literals;
+
+/// A cold start: the WebView setup (the loopback stands for the browser environment) and
+/// two application tasks that wait on I/O, loading the settings and indexing the archives.
+constexpr auto SETUP_TIME    = 30ms;
+constexpr auto SETTINGS_TIME = 10ms;
+constexpr auto INDEX_TIME    = 25ms;
+
+/// The startup phases, run one after the other or as a graph.
+struct ColdStart
+{
+  std::unique_ptr<Window> window;
+  WebView                 webview;
+  AssetPack               pack;
+  std::vector<std::byte>  pack_bytes;
+  bool                    navigated = false;
+
+  auto create_window() -> void
+  {
+    window = Window::create();
+  }
+
+  auto begin_setup(Startup::Done done) -> void
+  {
+    webview.on_ready = std::move(done);
+    webview.begin_setup(*window);
+  }
+
+  auto open_assets() -> void
+  {
+    auto builder = AssetPackBuilder();
+    builder.add("index.html", std::string_view("<!doctype html><script src=app.js></script>"));
+    builder.add("app.js", std::string(64 * 1024, 'x'));
+    pack_bytes = builder.build();
+    pack       = AssetPack::from_memory(pack_bytes);
+  }
+
+  auto navigate() -> void
+  {
+    webview.navigate("https://app.local/index.html");
+    navigated = pack.find("index.html").has_value();
+  }
+};
+
+auto add_phases(Startup& startup, ColdStart& app, bool parallel) -> void
+{
+  // In parallel the independent phases start right away, otherwise each waits for the previous one.
+  auto const worker = parallel ? StartupThread::Worker : StartupThread::Ui;
+  auto const after  = [parallel](Startup::PhaseId previous)
+  {
+    return parallel ? std::vector<Startup::PhaseId>() : std::vector<Startup::PhaseId>{previous};
+  };
+
+  auto const window = startup.add(
+    "window",
+    StartupThread::Ui,
+    [&app]
+    {
+      app.create_window();
+    }
+  );
+  auto const webview = startup.add_async(
+    "webview",
+    StartupThread::Ui,
+    [&app](Startup::Done done)
+    {
+      app.begin_setup(std::move(done));
+    },
+    {window}
+  );
+  auto const assets = startup.add(
+    "assets",
+    worker,
+    [&app]
+    {
+      app.open_assets();
+    },
+    after(webview)
+  );
+  auto const settings = startup.add(
+    "settings",
+    worker,
+    []
+    {
+      std::this_thread::sleep_for(SETTINGS_TIME);
+    },
+    after(assets)
+  );
+  auto const index = startup.add(
+    "index_archives",
+    worker,
+    []
+    {
+      std::this_thread::sleep_for(INDEX_TIME);
+    },
+    after(settings)
+  );
+  startup.add(
+    "navigate",
+    StartupThread::Ui,
+    [&app]
+    {
+      app.navigate();
+    },
+    {webview, assets, settings, index}
+  );
+}
+
+/// Runs the startups until navigated, and reports the timeline of the last one.
+auto cold_start(Context& context, bool parallel) -> void
+{
+  loopback::set_setup_time(SETUP_TIME);
+  // Enough workers for the concurrent phases, whatever the machine.
+  auto pool     = TaskPool(TaskPoolSettings{.threads = 4, .ui = &ui_queue()});
+  auto timeline = std::vector<StartupTiming>();
+  context.measure(
+    1,
+    [&]
+    {
+      auto app     = ColdStart();
+      auto startup = Startup(Startup::Clock::now(), pool);
+      add_phases(startup, app, parallel);
+      startup.run();
+      while (!startup.finished()) {
+        if (ui_queue().drain() == 0) {
+          std::this_thread::sleep_for(50us);
+        }
+      }
+      startup.mark("done");
+      timeline = startup.timeline();
+    }
+  );
+  loopback::set_setup_time({});
+
+  for (auto const& timing : timeline) {
+    if (timing.name == "navigate" || timing.name == "webview") {
+      context.add_metric(timing.name + "_end_ms", std::chrono::duration<double, std::milli>(*timing.end).count());
+    }
+  }
+}
+
+/// The baseline: every phase on the UI thread, one after the other, like a plain `on_start`.
+UBYTES_BENCH(
+  "startup/cold/sequential",
+  [](Context& context)
+  {
+    cold_start(context, false);
+  }
+);
+
+UBYTES_BENCH(
+  "startup/cold/parallel",
+  [](Context& context)
+  {
+    cold_start(context, true);
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,157 @@
+#include "Bench.hpp"
+
+#include <UBytes/AppPlatform/Core/Text.hpp>
+#include <UBytes/AppPlatform/Core/Utf.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+/// 64 KiB of text made of `sample`.
+auto repeat(std::string_view sample) -> std::string
+{
+  auto result = std::string();
+  while (result.size() < 64 * 1024) {
+    result += sample;
+  }
+  return result;
+}
+
+/// Mostly ASCII JSON with some Latin Extended and CJK text, like UI data.
+auto make_text() -> std::string const&
+{
+  static auto const text = repeat(R"({"name":"Zażółć gęślą jaźń","id":42,"tags":["alpha","beta"],"note":"日本語のテキスト"},)");
+  return text;
+}
+
+/// Prose in 2-byte sequences and ASCII spaces and punctuation, and in 3-byte sequences.
+auto make_cyrillic_text() -> std::string const&
+{
+  static auto const text = repeat("Съешь же ещё этих мягких французских булок, да выпей чаю. ");
+  return text;
+}
+
+auto make_cjk_text() -> std::string const&
+{
+  static auto const text = repeat("日本語のテキストと中文的文本和한국어텍스트");
+  return text;
+}
+
+auto utf8_to_utf16(Context& context, std::string const& text, SimdLevel level) -> void
+{
+  if (!context.require(level)) {
+    return;
+  }
+  auto out = std::vector<char16_t>(utf16_capacity_for_utf8(text.size()));
+
+  context.measure(
+    1,
+    [&]
+    {
+      auto result = convert_utf8_to_wide(text, std::span<char16_t>(out), UtfErrors::Replace, level);
+      do_not_optimize(result);
+    }
+  );
+  context.set_bytes_per_op(static_cast<double>(text.size()));
+}
+
+auto utf16_to_utf8(Context& context, std::string const& text, SimdLevel level) -> void
+{
+  if (!context.require(level)) {
+    return;
+  }
+  auto       wide  = std::vector<char16_t>(utf16_capacity_for_utf8(text.size()));
+  auto const count = convert_utf8_to_wide(text, std::span<char16_t>(wide)).written;
+  auto       out   = std::vector<char>(utf8_capacity_for_utf16(count));
+
+  context.measure(
+    1,
+    [&]
+    {
+      auto result = convert_wide_to_utf8(std::u16string_view(wide.data(), count), std::span<char>(out), UtfErrors::Replace, level);
+      do_not_optimize(result);
+    }
+  );
+  context.set_bytes_per_op(static_cast<double>(text.size()));
+}
+
+[[maybe_unused]] auto const registered = []
+{
+  using Text = std::string const& (*)();
+  struct Sample
+  {
+    char const* name;
+    Text        text;
+  };
+  static constexpr Sample samples[] = {{"", make_text}, {"cyrillic/", make_cyrillic_text}, {"cjk/", make_cjk_text}};
+
+  for (auto const& sample : samples) {
+    for (auto const level : SIMD_LEVELS) {
+      auto const name = std::string(sample.name) + std::string(simd_level_name(level));
+      auto const text = sample.text;
+      register_benchmark(
+        "text/utf8_to_utf16/" + name,
+        [text, level](Context& context)
+        {
+          utf8_to_utf16(context, text(), level);
+        }
+      );
+      register_benchmark(
+        "text/utf16_to_utf8/" + name,
+        [text, level](Context& context)
+        {
+          utf16_to_utf8(context, text(), level);
+        }
+      );
+    }
+  }
+  return true;
+}();
+
+// The allocating conversions used by the `std::string`/`std::wstring` APIs.
+
+UBYTES_BENCH(
+  "text/utf8_to_wstring",
+  [](Context& context)
+  {
+    auto const& text = make_text();
+    context.measure(
+      1,
+      [&]
+      {
+        do_not_optimize(details::utf8_to_wstring(text));
+      }
+    );
+    context.set_bytes_per_op(static_cast<double>(text.size()));
+  }
+);
+
+UBYTES_BENCH(
+  "text/wstring_to_utf8",
+  [](Context& context)
+  {
+    auto const& text = make_text();
+    auto const  wide = details::utf8_to_wstring(text);
+    context.measure(
+      1,
+      [&]
+      {
+        do_not_optimize(details::wstring_to_utf8(wide));
+      }
+    );
+    context.set_bytes_per_op(static_cast<double>(text.size()));
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,188 @@
+#include "Bench.hpp"
+#include "Loopback.hpp"
+
+#include <UBytes/AppPlatform/App.hpp>
+#include <UBytes/AppPlatform/WebView/WebViewPool.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+namespace bench
+{
+namespace
+{
+
+using namespace std::chrono_literals;
+
+/// The loopback setup stands for the browser environment and renderer creation, and a tool
+/// window is opened every `OPEN_INTERVAL` (time enough for the pool to refill in between).
+/// The time per operation includes that interval: `time_to_ready_ms` is the figure to compare.
+constexpr auto        SETUP_TIME    = 20ms;
+constexpr auto        OPEN_INTERVAL = 40ms;
+constexpr std::size_t BURST         = 3;
+
+/// Runs the UI queue until `done()` returns true.
+template <typename Done>
+auto run_ui_until(Done&& done) -> void
+{
+  while (!done()) {
+    if (ui_queue().drain() == 0) {
+      std::this_thread::sleep_for(50us);
+    }
+  }
+}
+
+auto idle_for(Context::Clock::duration time) -> void
+{
+  auto const end = Context::Clock::now() + time;
+  run_ui_until(
+    [end]
+    {
+      return Context::Clock::now() >= end;
+    }
+  );
+}
+
+auto to_ms(Context::Clock::duration time) -> double
+{
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+/// The loopback setup time, restored when a benchmark ends.
+class SetupTime
+{
+public:
+  explicit SetupTime(std::chrono::nanoseconds time)
+  {
+    loopback::set_setup_time(time);
+  }
+
+  ~SetupTime()
+  {
+    loopback::set_setup_time({});
+  }
+};
+
+/// The baseline: a new WebView is set up in every window that opens.
+UBYTES_BENCH(
+  "webview_pool/open/no_pool",
+  [](Context& context)
+  {
+    auto const setup_time = SetupTime(SETUP_TIME);
+    auto const window     = Window::create();
+    auto       opened     = std::uint64_t(0);
+    auto       total_wait = Context::Clock::duration();
+    context.measure(
+      1,
+      [&]
+      {
+        idle_for(OPEN_INTERVAL);
+        auto const start   = Context::Clock::now();
+        auto       webview = std::make_unique<WebView>();
+        webview->begin_setup(*window);
+        run_ui_until(
+          [&webview]
+          {
+            return webview->setup_finished();
+          }
+        );
+        total_wait += Context::Clock::now() - start;
+        ++opened;
+      }
+    );
+    context.add_metric("time_to_ready_ms", to_ms(total_wait) / static_cast<double>(opened));
+  }
+);
+
+auto report(Context& context, WebViewPool const& pool) -> void
+{
+  auto const stats    = pool.stats();
+  auto const acquired = static_cast<double>(stats.acquired);
+  context.add_metric("time_to_ready_ms", to_ms(stats.total_wait) / acquired);
+  context.add_metric("max_wait_ms", to_ms(stats.max_wait));
+  context.add_metric("ready_hits", static_cast<double>(stats.ready_hits) / acquired);
+  context.add_metric("pooled", static_cast<double>(pool.capacity()));
+}
+
+/// Opens the windows `per_open` at a time, from a pool filled beforehand.
+auto open_from_pool(Context& context, WebViewPoolSettings settings, std::size_t per_open) -> void
+{
+  auto const setup_time = SetupTime(SETUP_TIME);
+  auto const parking    = Window::create();
+  auto const window     = Window::create();
+  auto       pool       = WebViewPool(*parking, std::move(settings));
+  pool.fill();
+  run_ui_until(
+    [&pool]
+    {
+      return pool.ready_count() == pool.capacity();
+    }
+  );
+
+  auto webviews = std::vector<std::unique_ptr<WebView>>();
+  context.measure(
+    per_open,
+    [&]
+    {
+      webviews.clear();
+      idle_for(OPEN_INTERVAL);
+      for (std::size_t i = 0; i < per_open; ++i) {
+        pool.acquire(
+          *window,
+          [&webviews](std::unique_ptr<WebView> webview)
+          {
+            webviews.push_back(std::move(webview));
+          }
+        );
+      }
+      run_ui_until(
+        [&]
+        {
+          return webviews.size() == per_open;
+        }
+      );
+    }
+  );
+  report(context, pool);
+}
+
+UBYTES_BENCH(
+  "webview_pool/open/pool_1",
+  [](Context& context)
+  {
+    open_from_pool(context, WebViewPoolSettings{.size = 1}, 1);
+  }
+);
+
+/// Three windows at once (e.g. restoring a layout) with two pooled WebViews: the third waits.
+UBYTES_BENCH(
+  "webview_pool/open/burst_pool_2",
+  [](Context& context)
+  {
+    open_from_pool(context, WebViewPoolSettings{.size = 2}, BURST);
+  }
+);
+
+/// The same burst with a memory limit that leaves room for a single pooled WebView.
+UBYTES_BENCH(
+  "webview_pool/open/burst_memory_limited",
+  [](Context& context)
+  {
+    open_from_pool(
+      context,
+      WebViewPoolSettings{.size = 4, .memory_limit = 100 * 1024 * 1024, .webview_memory = 64 * 1024 * 1024},
+      BURST
+    );
+  }
+);
+
+} // namespace
+} // namespace bench
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,165 @@
+# app_platform_embed_assets(<target>
+#   DIST <directory>
+#   [NAME <function>]
+#   [NAMESPACE <namespace>]
+#   [ENCODINGS <gzip|br>...]
+# )
+#
+# Creates a static library <target> with the files of DIST compiled in, along with
+# a generated <NAME>.hpp declaring:
+#
+#   auto <NAME>() -> ubytes::app_platform::EmbeddedAssets const&;
+#
+# Every file is compressed at build time with the enabled ENCODINGS (default: gzip
+# and, when the `brotli` tool is found, br) and stored in the smallest variant.
+# The index is keyed by the path relative to DIST: a constexpr perfect hash, or above
+# APP_PLATFORM_PERFECT_HASH_MAX files a sorted table searched by bisection, as the
+# compilers limit the work of a constant evaluation (MSVC to 1M steps by default).
+#
+# Each file is processed by its own build step depending on that file only, so
+# only the changed assets are recompressed. Adding or removing files re-runs the
+# configuration. NAME defaults to <target>.
+#
+# @note DIST must exist when configuring (build the web UI first).
+
+set(APP_PLATFORM_EMBED_ASSET_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/AppPlatformEmbedAsset.cmake")
+set(APP_PLATFORM_INCLUDE_DIR "${CMAKE_CURRENT_LIST_DIR}/../include")
+set(APP_PLATFORM_PERFECT_HASH_MAX 256 CACHE STRING "The most embedded assets indexed by a perfect hash.")
+
+function(app_platform_embed_assets TARGET)
+	cmake_parse_arguments(PARSE_ARGV 1 ARG "" "DIST;NAME;NAMESPACE" "ENCODINGS")
+
+	if(NOT ARG_DIST)
+		message(FATAL_ERROR "app_platform_embed_assets: DIST is required.")
+	endif()
+	if(NOT ARG_NAME)
+		string(MAKE_C_IDENTIFIER "${TARGET}" ARG_NAME)
+	endif()
+	if(NOT DEFINED ARG_ENCODINGS)
+		set(ARG_ENCODINGS gzip br)
+	endif()
+
+	get_filename_component(DIST "${ARG_DIST}" ABSOLUTE)
+	file(GLOB_RECURSE FILES CONFIGURE_DEPENDS LIST_DIRECTORIES false RELATIVE "${DIST}" "${DIST}/*")
+	list(SORT FILES)
+	list(LENGTH FILES COUNT)
+	if(COUNT EQUAL 0)
+		message(FATAL_ERROR "app_platform_embed_assets: no files found in ${DIST}.")
+	endif()
+
+	find_program(APP_PLATFORM_BROTLI brotli)
+	set(BROTLI "")
+	if("br" IN_LIST ARG_ENCODINGS AND APP_PLATFORM_BROTLI)
+		set(BROTLI "${APP_PLATFORM_BROTLI}")
+	endif()
+	string(REPLACE ";" "," ENCODINGS "${ARG_ENCODINGS}")
+
+	set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/${TARGET}")
+
+	# One build step per asset.
+	set(FRAGMENTS "")
+	set(INCLUDES  "")
+	set(KEYS      "")
+	set(ENTRIES   "")
+	set(INDEX     0)
+	foreach(FILE IN LISTS FILES)
+		string(MD5 ID "${FILE}")
+		set(FRAGMENT "${OUTPUT_DIR}/assets/${ID}.inc")
+
+		add_custom_command(
+			OUTPUT  "${FRAGMENT}"
+			COMMAND ${CMAKE_COMMAND}
+				"-DINPUT=${DIST}/${FILE}"
+				"-DOUTPUT=${FRAGMENT}"
+				"-DENCODINGS=${ENCODINGS}"
+				"-DBROTLI=${BROTLI}"
+				-P "${APP_PLATFORM_EMBED_ASSET_SCRIPT}"
+			DEPENDS "${DIST}/${FILE}" "${APP_PLATFORM_EMBED_ASSET_SCRIPT}"
+			COMMENT "Embedding asset ${FILE}"
+			VERBATIM
+		)
+		list(APPEND FRAGMENTS "${FRAGMENT}")
+
+		string(REPLACE "\\" "\\\\" LITERAL "${FILE}")
+		string(REPLACE "\"" "\\\"" LITERAL "${LITERAL}")
+
+		string(APPEND INCLUDES "namespace asset_${INDEX}\n{\n#include \"assets/${ID}.inc\"\n}\n")
+		string(APPEND KEYS "    \"${LITERAL}\",\n")
+		string(APPEND ENTRIES
+			"    Asset{\"${LITERAL}\", bytes_of(asset_${INDEX}::DATA, asset_${INDEX}::SIZE), "
+			"mime_type_for(\"${LITERAL}\"), asset_${INDEX}::ETAG, asset_${INDEX}::ENCODING, "
+			"asset_${INDEX}::ORIGINAL_SIZE},\n"
+		)
+		math(EXPR INDEX "${INDEX} + 1")
+	endforeach()
+
+	# The translation unit only depends on the list of files, it is regenerated when configuring.
+	if(ARG_NAMESPACE)
+		set(NAMESPACE_BEGIN "namespace ${ARG_NAMESPACE}\n{\n")
+		set(NAMESPACE_END   "} // namespace ${ARG_NAMESPACE}\n")
+	else()
+		set(NAMESPACE_BEGIN "")
+		set(NAMESPACE_END   "")
+	endif()
+
+	file(WRITE "${OUTPUT_DIR}/${ARG_NAME}.hpp.tmp"
+		"// Generated by app_platform_embed_assets(), do not edit.\n"
+		"#pragma once\n\n"
+		"#include <UBytes/AppPlatform/Core/EmbeddedAssets.hpp>\n\n"
+		"${NAMESPACE_BEGIN}"
+		"auto ${ARG_NAME}() -> ubytes::app_platform::EmbeddedAssets const&;\n"
+		"${NAMESPACE_END}"
+	)
+	# FILES is sorted by bytes, like `std::string_view` compares.
+	if(COUNT GREATER APP_PLATFORM_PERFECT_HASH_MAX)
+		string(CONCAT INDEX_CODE
+			"constexpr auto KEYS = std::array<std::string_view, ${COUNT}>{\n${KEYS}};\n"
+			"static_assert(std::is_sorted(KEYS.begin(), KEYS.end()));\n\n"
+		)
+		string(CONCAT LOOKUP_CODE
+			"  auto const it = std::lower_bound(KEYS.begin(), KEYS.end(), path);\n"
+			"  return it != KEYS.end() && *it == path ? std::size_t(it - KEYS.begin()) : EmbeddedAssets::npos;\n"
+		)
+	else()
+		set(INDEX_CODE  "constexpr auto INDEX = PerfectHash<${COUNT}>({\n${KEYS}});\n\n")
+		set(LOOKUP_CODE "  return INDEX.find(path);\n")
+	endif()
+
+	file(WRITE "${OUTPUT_DIR}/${ARG_NAME}.cpp.tmp"
+		"// Generated by app_platform_embed_assets(), do not edit.\n"
+		"#include \"${ARG_NAME}.hpp\"\n\n"
+		"#include <UBytes/AppPlatform/Core/PerfectHash.hpp>\n\n"
+		"#include <algorithm>\n#include <array>\n#include <cstddef>\n#include <cstdint>\n#include <span>\n"
+		"#include <string_view>\n\n"
+		"namespace\n{\n\n"
+		"using namespace ubytes::app_platform;\n\n"
+		"${INCLUDES}\n"
+		"${INDEX_CODE}"
+		"auto bytes_of(unsigned char const* data, std::size_t size) -> std::span<std::byte const>\n{\n"
+		"  return std::as_bytes(std::span(data, size));\n}\n\n"
+		"auto lookup(std::string_view path) noexcept -> std::size_t\n{\n"
+		"${LOOKUP_CODE}}\n\n"
+		"} // namespace\n\n"
+		"${NAMESPACE_BEGIN}"
+		"auto ${ARG_NAME}() -> ubytes::app_platform::EmbeddedAssets const&\n{\n"
+		"  static auto const assets = std::array<Asset, ${COUNT}>{\n${ENTRIES}  };\n"
+		"  static auto const embedded = EmbeddedAssets(assets, lookup);\n"
+		"  return embedded;\n}\n"
+		"${NAMESPACE_END}"
+	)
+	foreach(EXTENSION hpp cpp)
+		file(COPY_FILE
+			"${OUTPUT_DIR}/${ARG_NAME}.${EXTENSION}.tmp"
+			"${OUTPUT_DIR}/${ARG_NAME}.${EXTENSION}"
+			ONLY_IF_DIFFERENT
+		)
+		file(REMOVE "${OUTPUT_DIR}/${ARG_NAME}.${EXTENSION}.tmp")
+	endforeach()
+
+	# The fragments are included, not compiled on their own.
+	set_source_files_properties(${FRAGMENTS} PROPERTIES HEADER_FILE_ONLY TRUE)
+
+	add_library(${TARGET} STATIC "${OUTPUT_DIR}/${ARG_NAME}.cpp" ${FRAGMENTS})
+	target_include_directories(${TARGET} PUBLIC "${OUTPUT_DIR}" "${APP_PLATFORM_INCLUDE_DIR}")
+	target_compile_features(${TARGET} PUBLIC cxx_std_20)
+endfunction()
@@ -0,0 +1,76 @@
+# Compresses one asset and writes it as a C++ fragment, used by `app_platform_embed_assets()`.
+#
+# cmake -DINPUT=<file> -DOUTPUT=<file.inc> -DENCODINGS=gzip,br [-DBROTLI=<brotli executable>]
+#       -P AppPlatformEmbedAsset.cmake
+#
+# The fragment defines DATA, SIZE, ENCODING, ORIGINAL_SIZE and ETAG and is included
+# by the generated translation unit inside a namespace of its own.
+
+cmake_minimum_required(VERSION 3.25)
+
+string(REPLACE "," ";" ENCODINGS "${ENCODINGS}")
+
+get_filename_component(OUTPUT_DIR "${OUTPUT}" DIRECTORY)
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+
+file(SIZE "${INPUT}" ORIGINAL_SIZE)
+file(SHA256 "${INPUT}" HASH)
+string(SUBSTRING "${HASH}" 0 16 ETAG)
+
+set(BEST_FILE     "${INPUT}")
+set(BEST_SIZE     ${ORIGINAL_SIZE})
+set(BEST_ENCODING Identity)
+
+# A compressed variant is only kept when it saves at least 1/8 of the size,
+# already compressed formats (images, fonts) stay as they are.
+macro(consider_variant FILE ENCODING)
+	if(EXISTS "${FILE}")
+		file(SIZE "${FILE}" VARIANT_SIZE)
+		math(EXPR THRESHOLD "${BEST_SIZE} - ${ORIGINAL_SIZE} / 8")
+		if(VARIANT_SIZE LESS THRESHOLD)
+			set(BEST_FILE     "${FILE}")
+			set(BEST_SIZE     ${VARIANT_SIZE})
+			set(BEST_ENCODING ${ENCODING})
+		endif()
+	endif()
+endmacro()
+
+if("gzip" IN_LIST ENCODINGS)
+	file(ARCHIVE_CREATE
+		OUTPUT            "${OUTPUT}.gz"
+		PATHS             "${INPUT}"
+		FORMAT            raw
+		COMPRESSION       GZip
+		COMPRESSION_LEVEL 9
+	)
+	consider_variant("${OUTPUT}.gz" Gzip)
+endif()
+
+if("br" IN_LIST ENCODINGS AND BROTLI)
+	execute_process(
+		COMMAND ${BROTLI} --quality=11 --force --output=${OUTPUT}.br ${INPUT}
+		RESULT_VARIABLE BROTLI_RESULT
+	)
+	if(BROTLI_RESULT EQUAL 0)
+		consider_variant("${OUTPUT}.br" Brotli)
+	endif()
+endif()
+
+file(READ "${BEST_FILE}" HEX HEX)
+if(BEST_SIZE EQUAL 0)
+	# Zero-sized arrays are not allowed.
+	set(HEX "00")
+endif()
+string(REGEX REPLACE "([0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f])" "\\1\n" HEX "${HEX}")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX "${HEX}")
+
+file(WRITE "${OUTPUT}.tmp"
+	"// Generated from ${INPUT}, do not edit.\n"
+	"alignas(16) constexpr unsigned char DATA[] = {\n${HEX}\n};\n"
+	"constexpr std::size_t SIZE = ${BEST_SIZE};\n"
+	"constexpr auto ENCODING = ubytes::app_platform::AssetEncoding::${BEST_ENCODING};\n"
+	"constexpr std::uint64_t ORIGINAL_SIZE = ${ORIGINAL_SIZE};\n"
+	"constexpr std::string_view ETAG = \"\\\"${ETAG}\\\"\";\n"
+)
+file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT}.tmp" "${OUTPUT}.gz" "${OUTPUT}.br")
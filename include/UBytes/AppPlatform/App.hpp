@@ -1,5 +1,10 @@
 #pragma once
 
 #include <UBytes/AppPlatform/App/AppInterface.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/App/TaskPool.hpp>
+#include <UBytes/AppPlatform/App/UiScheduler.hpp>
+#include <UBytes/AppPlatform/App/ResizeScheduler.hpp>
+#include <UBytes/AppPlatform/App/Startup.hpp>
 
 // TODO: include every header file in `App/` folder
\ No newline at end of file
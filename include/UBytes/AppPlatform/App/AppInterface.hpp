@@ -15,6 +15,10 @@ public:
 
 
 /// Runs the application in a default way.
+/// The loop does not drain `ui_queue()` by itself: call `attach_ui_queue_to_message_loop()`
+/// (see `App/UiQueueMessageLoop.hpp`) at the start of `on_start`, or the tasks posted with
+/// `post_to_ui()` never run, nor do the UI parts of `TaskPool`, `Startup`, `ResizeScheduler`,
+/// `WebViewPool` and `ImageSender`.
 UBYTES_EXPORT auto run_default(AppInterface& app) -> int;
 
 } // namespace app_platform
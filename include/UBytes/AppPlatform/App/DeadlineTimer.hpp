@@ -0,0 +1,172 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// The thread shared by the `DeadlineTimer`s, which calls their functions at their deadlines.
+class DeadlineThread
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Fire  = std::function<void()>;
+
+  DeadlineThread() = default;
+
+  DeadlineThread(DeadlineThread const&)                    = delete;
+  auto operator=(DeadlineThread const&) -> DeadlineThread& = delete;
+
+  ~DeadlineThread()
+  {
+    {
+      auto lock = std::lock_guard(_mutex);
+      _stopping = true;
+    }
+    _changed.notify_one();
+    if (_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+  /// Calls `fire` at `deadline`, instead of at its previous deadline if any.
+  /// `fire` is identified by its address, it must stay valid until `disarm()`.
+  auto arm(Fire const& fire, Clock::time_point deadline) -> void
+  {
+    {
+      auto lock = std::lock_guard(_mutex);
+      remove(fire);
+      _deadlines.emplace(deadline, &fire);
+      if (!_thread.joinable()) {
+        // Started on first use, many applications never arm a timer.
+        _thread = std::thread(
+          [this]
+          {
+            UBYTES_TRACE_THREAD_NAME("DeadlineThread");
+            run();
+          }
+        );
+      }
+    }
+    _changed.notify_one();
+  }
+
+  /// Cancels the call of `fire`, waiting for it to return if it is running.
+  auto disarm(Fire const& fire) -> void
+  {
+    auto lock = std::unique_lock(_mutex);
+    remove(fire);
+    _idle.wait(
+      lock,
+      [this, &fire]
+      {
+        return _firing != &fire;
+      }
+    );
+  }
+
+private:
+  auto remove(Fire const& fire) -> void
+  {
+    std::erase_if(
+      _deadlines,
+      [&fire](auto const& deadline)
+      {
+        return deadline.second == &fire;
+      }
+    );
+  }
+
+  auto run() -> void
+  {
+    auto lock = std::unique_lock(_mutex);
+    while (!_stopping) {
+      if (_deadlines.empty()) {
+        _changed.wait(lock);
+        continue;
+      }
+      auto const first = _deadlines.begin();
+      if (Clock::now() < first->first) {
+        _changed.wait_until(lock, first->first);
+        continue;
+      }
+      _firing = first->second;
+      _deadlines.erase(first);
+      lock.unlock();
+      (*_firing)();
+      lock.lock();
+      _firing = nullptr;
+      _idle.notify_all();
+    }
+  }
+
+  std::mutex                                    _mutex;
+  std::condition_variable                       _changed;
+  std::condition_variable                       _idle;
+  std::multimap<Clock::time_point, Fire const*> _deadlines;
+  Fire const*                                   _firing   = nullptr;
+  bool                                          _stopping = false;
+  std::thread                                   _thread;
+};
+
+/// Returns the thread of the `DeadlineTimer`s.
+inline auto deadline_thread() -> DeadlineThread&
+{
+  static auto thread = DeadlineThread();
+  return thread;
+}
+
+/// Calls a function at a deadline, which can be moved or cancelled, from the shared
+/// `DeadlineThread`: the timers of all the resize schedulers and message batchers cost one thread.
+class DeadlineTimer
+{
+public:
+  using Clock = DeadlineThread::Clock;
+
+  explicit DeadlineTimer(std::function<void()> fire, DeadlineThread& thread = deadline_thread())
+    : _fire(std::move(fire))
+    , _thread(thread)
+  {
+  }
+
+  DeadlineTimer(DeadlineTimer const&)                    = delete;
+  auto operator=(DeadlineTimer const&) -> DeadlineTimer& = delete;
+
+  ~DeadlineTimer()
+  {
+    _thread.disarm(_fire);
+  }
+
+  /// Calls the function at `deadline`, instead of at the previous deadline if any.
+  auto arm(Clock::time_point deadline) -> void
+  {
+    _thread.arm(_fire, deadline);
+  }
+
+  auto disarm() -> void
+  {
+    _thread.disarm(_fire);
+  }
+
+private:
+  std::function<void()> _fire;
+  /// Taken at construction, so that the thread is destroyed after the timers of the statics.
+  DeadlineThread& _thread;
+};
+
+} // namespace details
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <UBytes/AppPlatform/App/DeadlineTimer.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/Core/Rect.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+#include <UBytes/AppPlatform/WebView.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+enum class ResizeMode
+{
+  /// Applies the latest bounds at most once per frame while the window is being resized.
+  Live,
+  /// Applies the bounds once the resizing has stopped for `ResizeSettings::settle_time`.
+  Deferred,
+};
+
+struct ResizeSettings
+{
+  ResizeMode mode = ResizeMode::Live;
+
+  /// The time between two applied bounds in `Live` mode. A fixed 60 Hz by default, not
+  /// the refresh rate of the display: set it from the monitor for other rates.
+  std::chrono::nanoseconds frame_interval = std::chrono::nanoseconds(1'000'000'000 / 60);
+
+  /// The time without resize events after which the bounds are applied in `Deferred` mode.
+  std::chrono::nanoseconds settle_time = std::chrono::milliseconds(100);
+};
+
+struct ResizeStats
+{
+  /// The number of `resize()` calls.
+  std::uint64_t received = 0;
+  /// The number of times the bounds were applied.
+  std::uint64_t applied = 0;
+  /// The number of bounds replaced by newer ones before being applied.
+  std::uint64_t coalesced = 0;
+};
+
+/// Coalesces the resize events of a window, so that a drag-resize relayouts the page once
+/// per frame (or once at the end) instead of once per intermediate size.
+///
+/// ```cpp
+/// class MainWindow : public Window
+/// {
+/// public:
+///   MainWindow()
+///   {
+///     // Once per application, before the first resize: the delayed bounds are `UiQueue` tasks.
+///     attach_ui_queue_to_message_loop();
+///   }
+///
+///   auto on_resize(Rect2i bounds) -> void override
+///   {
+///     _resize.resize(bounds);
+///   }
+///
+///   WebView         webview;
+///   ResizeScheduler _resize = ResizeScheduler(webview);
+/// };
+/// ```
+///
+/// In `Live` mode the first event of a burst is applied at once and the following ones at
+/// most once per `frame_interval`, always with the latest bounds. In `Deferred` mode only
+/// the last bounds are applied, when the events stop.
+/// @note Use from the UI thread. The delayed bounds are applied from `UiQueue` tasks,
+/// posted by a shared timer thread: the UI loop must drain the queue, see
+/// `App/UiQueueMessageLoop.hpp`. While a task is late, `Live` mode applies the bounds from
+/// the next `resize()` calls instead, the last bounds of a burst wait for the task or `flush()`.
+class ResizeScheduler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Apply = std::function<void(Rect2i bounds)>;
+
+  explicit ResizeScheduler(Apply apply, ResizeSettings settings = {}, UiQueue& queue = ui_queue())
+    : _apply(std::move(apply))
+    , _settings(settings)
+    , _alive(std::make_shared<ResizeScheduler*>(this))
+    , _timer(
+        [&queue, alive = std::weak_ptr<ResizeScheduler*>(_alive)]
+        {
+          queue.post(
+            [alive]
+            {
+              if (auto self = alive.lock()) {
+                (*self)->on_timer();
+              }
+            }
+          );
+        }
+      )
+  {
+  }
+
+  /// Applies the bounds to `WebView::set_bounds`.
+  explicit ResizeScheduler(WebView& webview, ResizeSettings settings = {}, UiQueue& queue = ui_queue())
+    : ResizeScheduler(
+        [&webview](Rect2i bounds)
+        {
+          webview.set_bounds(bounds);
+        },
+        settings,
+        queue
+      )
+  {
+  }
+
+  ResizeScheduler(ResizeScheduler const&)                    = delete;
+  auto operator=(ResizeScheduler const&) -> ResizeScheduler& = delete;
+
+  /// Drops the bounds that have not been applied yet.
+  ~ResizeScheduler() = default;
+
+  /// Schedules new bounds, e.g. from `Window::on_resize`.
+  auto resize(Rect2i bounds) -> void
+  {
+    auto const now = Clock::now();
+    ++_stats.received;
+    if (_pending) {
+      ++_stats.coalesced;
+    }
+    _pending    = bounds;
+    _last_event = now;
+
+    if (_settings.mode == ResizeMode::Deferred) {
+      arm(now + _settings.settle_time);
+      return;
+    }
+    // Once its deadline has passed, the timer task is late (e.g. the UI queue is not drained
+    // yet): the bounds are applied here, still at most once per frame.
+    if (_armed && now < _armed_deadline) {
+      return;
+    }
+    auto const next_frame = _last_apply + _settings.frame_interval;
+    if (now >= next_frame) {
+      apply(now);
+    }
+    else if (!_armed) {
+      arm(next_frame);
+    }
+  }
+
+  /// Applies the pending bounds now, e.g. when the platform reports the end of a drag-resize.
+  auto flush() -> void
+  {
+    if (_pending) {
+      _timer.disarm();
+      _armed = false;
+      apply(Clock::now());
+    }
+  }
+
+  /// Returns true if bounds are waiting to be applied.
+  auto pending() const noexcept -> bool
+  {
+    return _pending.has_value();
+  }
+
+  auto mode() const noexcept -> ResizeMode
+  {
+    return _settings.mode;
+  }
+
+  /// Changes the mode, applying the pending bounds first.
+  auto set_mode(ResizeMode mode) -> void
+  {
+    flush();
+    _settings.mode = mode;
+  }
+
+  auto stats() const noexcept -> ResizeStats
+  {
+    return _stats;
+  }
+
+  auto reset_stats() noexcept -> void
+  {
+    _stats = ResizeStats();
+  }
+
+private:
+  auto arm(Clock::time_point deadline) -> void
+  {
+    _armed          = true;
+    _armed_deadline = deadline;
+    _timer.arm(deadline);
+  }
+
+  auto on_timer() -> void
+  {
+    _armed = false;
+    if (!_pending) {
+      return;
+    }
+    // The timer task may have been queued before a `flush()`, check the deadline again.
+    auto const now = Clock::now();
+    auto const due = _settings.mode == ResizeMode::Deferred ? _last_event + _settings.settle_time
+                                                            : _last_apply + _settings.frame_interval;
+    if (now < due) {
+      arm(due);
+      return;
+    }
+    apply(now);
+  }
+
+  auto apply(Clock::time_point now) -> void
+  {
+    UBYTES_TRACE_SCOPE("ResizeScheduler::apply");
+    auto const bounds = *_pending;
+    _pending.reset();
+    _last_apply = now;
+    ++_stats.applied;
+    _apply(bounds);
+  }
+
+  Apply          _apply;
+  ResizeSettings _settings;
+
+  std::optional<Rect2i> _pending;
+  Clock::time_point     _last_event;
+  Clock::time_point     _last_apply;
+  /// True from arming the timer to its task.
+  bool                  _armed = false;
+  Clock::time_point     _armed_deadline;
+  ResizeStats           _stats;
+
+  /// Expires with the scheduler, so that the timer tasks already queued do nothing.
+  std::shared_ptr<ResizeScheduler*> _alive;
+  details::DeadlineTimer            _timer;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <UBytes/AppPlatform/App/TaskPool.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Where a startup phase runs.
+enum class StartupThread
+{
+  /// On the UI thread, from a `UiQueue` task: for `Window` and `WebView`.
+  Ui,
+  /// On a `TaskPool` worker: for file I/O, decompression, indexing...
+  Worker,
+};
+
+/// The timestamps of a startup phase, from the start of the startup (see `Startup::origin()`).
+struct StartupTiming
+{
+  std::string   name;
+  StartupThread thread = StartupThread::Ui;
+  /// When the phase could run: its dependencies had ended.
+  std::chrono::nanoseconds ready = {};
+  std::chrono::nanoseconds start = {};
+  /// Unset while the phase runs. A mark (see `Startup::mark()`) ends as it starts.
+  std::optional<std::chrono::nanoseconds> end = std::nullopt;
+  /// Set if the phase threw, or did not run because a phase it depends on failed (it then
+  /// starts and ends as it becomes ready).
+  bool failed = false;
+};
+
+/// Runs the startup of an application as a graph of phases, each started as soon as the
+/// phases it depends on have ended, on the UI thread or on a worker, and records when each
+/// phase became ready, started and ended.
+///
+/// Instead of `on_start` doing everything in a row (create the window, set the WebView up,
+/// open the asset pack, load the settings, navigate), only the dependent parts wait:
+///
+/// ```cpp
+/// auto on_start() -> void override
+/// {
+///   attach_ui_queue_to_message_loop(); // The UI phases are `UiQueue` tasks.
+///   auto const window = _startup.add("window", StartupThread::Ui, [this] { _window = Window::create(); });
+///   auto const webview = _startup.add_async(
+///     "webview",
+///     StartupThread::Ui,
+///     [this](Startup::Done done) {
+///       _webview.on_ready = std::move(done);
+///       _webview.begin_setup(*_window);
+///     },
+///     {window}
+///   );
+///   auto const assets   = _startup.add("assets", StartupThread::Worker, [this] { _pack = open_asset_pack(PACK); });
+///   auto const settings = _startup.add("settings", StartupThread::Worker, [this] { _settings = load_settings(); });
+///   _startup.add("navigate", StartupThread::Ui, [this] { navigate(); }, {webview, assets, settings});
+///   _startup.run();
+/// }
+///
+/// // Later, when the page reports its first paint:
+/// _startup.mark("first_paint");
+/// send_to_log(_startup.timeline());
+/// ```
+/// A phase that throws fails, and so do the phases that depend on it, without running: above,
+/// no WebView setup without a window, and no navigation.
+/// @note Add the phases on the UI thread, before `run()`. The `Startup` must outlive the run.
+/// The UI phases and `on_finished` are posted to the queue: nothing runs on the UI thread
+/// unless its loop drains it (see `App/UiQueueMessageLoop.hpp`).
+class Startup
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  /// Ends an asynchronous phase. Call it once, from any thread.
+  using Done = std::function<void()>;
+  /// Identifies a phase, for the dependencies of the next ones.
+  using PhaseId = std::uint32_t;
+
+  /// Returned by `add()` and `add_async()` for a phase that was not added.
+  static constexpr PhaseId INVALID_PHASE = PhaseId(-1);
+
+  /// @param origin - the time the timestamps are relative to, e.g. the start of `main()`.
+  explicit Startup(Clock::time_point origin = Clock::now(), TaskPool& pool = task_pool(), UiQueue& queue = ui_queue())
+    : _origin(origin)
+    , _pool(pool)
+    , _queue(queue)
+  {
+  }
+
+  Startup(Startup const&)                    = delete;
+  auto operator=(Startup const&) -> Startup& = delete;
+
+  /// Adds a phase that ends when `fn` returns or throws.
+  /// @param after - the phases to wait for, added before this one.
+  /// @return The id of the phase, `INVALID_PHASE` if `after` holds another id or `run()` was called.
+  auto add(std::string name, StartupThread thread, std::function<void()> fn, std::span<PhaseId const> after = {})
+    -> PhaseId
+  {
+    return add_async(
+      std::move(name),
+      thread,
+      [this, id = static_cast<PhaseId>(_phases.size()), fn = std::move(fn)](Done done)
+      {
+        try {
+          fn();
+        }
+        catch (...) {
+          fail(id);
+        }
+        done();
+      },
+      after
+    );
+  }
+
+  auto add(std::string name, StartupThread thread, std::function<void()> fn, std::initializer_list<PhaseId> after)
+    -> PhaseId
+  {
+    return add(std::move(name), thread, std::move(fn), std::span<PhaseId const>(after.begin(), after.size()));
+  }
+
+  /// Adds a phase that ends when it calls `done`, e.g. the WebView setup on `on_ready`,
+  /// or when `fn` throws.
+  /// @param after - the phases to wait for, added before this one.
+  /// @return The id of the phase, `INVALID_PHASE` if `after` holds another id or `run()` was called.
+  auto add_async(
+    std::string                    name,
+    StartupThread                  thread,
+    std::function<void(Done done)> fn,
+    std::span<PhaseId const>       after = {}
+  ) -> PhaseId
+  {
+    // The workers read the phases once they run.
+    if (_started) {
+      return INVALID_PHASE;
+    }
+    auto const id = static_cast<PhaseId>(_phases.size());
+    for (auto const dependency : after) {
+      if (dependency >= id) {
+        return INVALID_PHASE;
+      }
+    }
+
+    auto phase    = std::make_unique<Phase>();
+    phase->fn     = std::move(fn);
+    phase->thread = thread;
+    for (auto const dependency : after) {
+      _phases[dependency]->dependents.push_back(id);
+      ++phase->dependencies;
+    }
+    phase->remaining.store(phase->dependencies, std::memory_order_relaxed);
+    _phases.push_back(std::move(phase));
+
+    auto lock = std::lock_guard(_mutex);
+    // Before the marks, if any, so that the phase ids index the timings.
+    _timings.insert(_timings.begin() + id, StartupTiming{std::move(name), thread});
+    return id;
+  }
+
+  auto add_async(
+    std::string                    name,
+    StartupThread                  thread,
+    std::function<void(Done done)> fn,
+    std::initializer_list<PhaseId> after
+  ) -> PhaseId
+  {
+    return add_async(std::move(name), thread, std::move(fn), std::span<PhaseId const>(after.begin(), after.size()));
+  }
+
+  /// Starts the phases. `on_finished` is called on the UI thread once every phase has ended.
+  /// @return false if already started.
+  auto run(std::function<void()> on_finished = {}) -> bool
+  {
+    if (_started) {
+      return false;
+    }
+    _started     = true;
+    _on_finished = std::move(on_finished);
+    _unfinished.store(_phases.size(), std::memory_order_relaxed);
+    if (_phases.empty()) {
+      finish();
+      return true;
+    }
+    for (PhaseId id = 0; id < _phases.size(); ++id) {
+      if (_phases[id]->dependencies == 0) {
+        schedule(id);
+      }
+    }
+    return true;
+  }
+
+  /// Records an instant, e.g. the first paint reported by the page. Safe from any thread.
+  auto mark(std::string name) -> void
+  {
+    auto const now  = since_origin();
+    auto       lock = std::lock_guard(_mutex);
+    _timings.push_back(StartupTiming{std::move(name), StartupThread::Ui, now, now, now});
+  }
+
+  /// Returns true once every phase has ended.
+  auto finished() const noexcept -> bool
+  {
+    return _finished.load(std::memory_order_acquire);
+  }
+
+  auto origin() const noexcept -> Clock::time_point
+  {
+    return _origin;
+  }
+
+  /// Returns the phases (in the order they were added) followed by the marks. Safe from any thread.
+  auto timeline() const -> std::vector<StartupTiming>
+  {
+    auto lock = std::lock_guard(_mutex);
+    return _timings;
+  }
+
+  /// Returns the timestamps of a phase or a mark, the first one with that name.
+  auto timing(std::string_view name) const -> std::optional<StartupTiming>
+  {
+    auto lock = std::lock_guard(_mutex);
+    for (auto const& timing : _timings) {
+      if (timing.name == name) {
+        return timing;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Writes `[{"name":..,"thread":"ui"|"worker","ready_ms":..,"start_ms":..,"end_ms":..|null,"failed":..},..]`.
+  auto write_json(JsonWriter& writer) const -> void
+  {
+    auto const ms = [](std::chrono::nanoseconds time)
+    {
+      return std::chrono::duration<double, std::milli>(time).count();
+    };
+
+    writer.begin_array();
+    for (auto const& timing : timeline()) {
+      writer.begin_object();
+      writer.field("name", std::string_view(timing.name));
+      writer.field("thread", timing.thread == StartupThread::Ui ? "ui" : "worker");
+      writer.field("ready_ms", ms(timing.ready));
+      writer.field("start_ms", ms(timing.start));
+      if (timing.end) {
+        writer.field("end_ms", ms(*timing.end));
+      }
+      else {
+        writer.key("end_ms").null();
+      }
+      writer.field("failed", timing.failed);
+      writer.end_object();
+    }
+    writer.end_array();
+  }
+
+private:
+  struct Phase
+  {
+    std::function<void(Done)>  fn;
+    StartupThread              thread = StartupThread::Ui;
+    std::vector<PhaseId>       dependents;
+    std::uint32_t              dependencies = 0;
+    std::atomic<std::uint32_t> remaining    = 0;
+    std::atomic<bool>          ended        = false;
+    /// Set when a dependency fails, before it ends.
+    std::atomic<bool>          skipped      = false;
+  };
+
+  auto since_origin() const noexcept -> std::chrono::nanoseconds
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _origin);
+  }
+
+  auto schedule(PhaseId id) -> void
+  {
+    auto const now     = since_origin();
+    auto const skipped = _phases[id]->skipped.load(std::memory_order_relaxed);
+    {
+      auto lock          = std::lock_guard(_mutex);
+      _timings[id].ready = now;
+      if (skipped) {
+        _timings[id].start = now;
+      }
+    }
+    if (skipped) {
+      fail(id);
+      end(id);
+      return;
+    }
+    auto task = [this, id]
+    {
+      start(id);
+    };
+    if (_phases[id]->thread == StartupThread::Ui) {
+      _queue.post(std::move(task));
+    }
+    else {
+      // The startup is what the user waits for.
+      _pool.submit(std::move(task), TaskOptions{.priority = TaskPriority::High, .token = {}});
+    }
+  }
+
+  auto start(PhaseId id) -> void
+  {
+    UBYTES_TRACE_SCOPE("Startup::phase");
+    {
+      auto const now  = since_origin();
+      auto       lock = std::lock_guard(_mutex);
+      _timings[id].start = now;
+    }
+    auto fn = std::move(_phases[id]->fn);
+    try {
+      fn(
+        [this, id]
+        {
+          end(id);
+        }
+      );
+    }
+    catch (...) {
+      fail(id);
+      end(id);
+    }
+  }
+
+  /// Records that a phase threw (or was skipped), and skips its dependents. The workers and
+  /// the UI queue have no one to report the exception to: the phase ends anyway, so that the
+  /// startup goes on.
+  auto fail(PhaseId id) -> void
+  {
+    // Published by the release of `remaining` in `end()`.
+    for (auto const dependent : _phases[id]->dependents) {
+      _phases[dependent]->skipped.store(true, std::memory_order_relaxed);
+    }
+    auto lock           = std::lock_guard(_mutex);
+    _timings[id].failed = true;
+  }
+
+  auto end(PhaseId id) -> void
+  {
+    auto& phase = *_phases[id];
+    if (phase.ended.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    {
+      auto const now  = since_origin();
+      auto       lock = std::lock_guard(_mutex);
+      _timings[id].end = now;
+    }
+    for (auto const dependent : phase.dependents) {
+      if (_phases[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        schedule(dependent);
+      }
+    }
+    if (_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      finish();
+    }
+  }
+
+  auto finish() -> void
+  {
+    _finished.store(true, std::memory_order_release);
+    if (!_on_finished) {
+      return;
+    }
+    _queue.post(
+      [this]
+      {
+        _on_finished();
+      }
+    );
+  }
+
+  Clock::time_point _origin;
+  TaskPool&         _pool;
+  UiQueue&          _queue;
+
+  std::vector<std::unique_ptr<Phase>> _phases;
+  std::function<void()>               _on_finished;
+  std::atomic<std::size_t>            _unfinished = 0;
+  std::atomic<bool>                   _finished   = false;
+  bool                                _started    = false;
+
+  /// Guards `_timings`, written by the threads running the phases.
+  mutable std::mutex         _mutex;
+  std::vector<StartupTiming> _timings;
+};
+
+} // namespace app_platform
+} // namespace ubytes
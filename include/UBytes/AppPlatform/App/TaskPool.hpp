@@ -0,0 +1,448 @@
+#pragma once
+
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Observes the cancellation requested through a `CancellationSource`.
+/// A default-constructed token is never cancelled.
+class CancellationToken
+{
+public:
+  CancellationToken() noexcept = default;
+
+  auto is_cancelled() const noexcept -> bool
+  {
+    return _state && _state->load(std::memory_order_acquire);
+  }
+
+private:
+  friend class CancellationSource;
+
+  explicit CancellationToken(std::shared_ptr<std::atomic<bool>> state) noexcept
+    : _state(std::move(state))
+  {
+  }
+
+  std::shared_ptr<std::atomic<bool>> _state;
+};
+
+/// Requests the cancellation of every task holding one of its tokens.
+class CancellationSource
+{
+public:
+  CancellationSource()
+    : _state(std::make_shared<std::atomic<bool>>(false))
+  {
+  }
+
+  auto token() const noexcept -> CancellationToken
+  {
+    return CancellationToken(_state);
+  }
+
+  auto cancel() noexcept -> void
+  {
+    _state->store(true, std::memory_order_release);
+  }
+
+  auto is_cancelled() const noexcept -> bool
+  {
+    return _state->load(std::memory_order_acquire);
+  }
+
+private:
+  std::shared_ptr<std::atomic<bool>> _state;
+};
+
+enum class TaskPriority
+{
+  High = 0,
+  Normal,
+  Low,
+};
+
+struct TaskOptions
+{
+  TaskPriority priority = TaskPriority::Normal;
+
+  /// A cancelled task that has not started yet is dropped, and the UI
+  /// continuation of a cancelled task is not run.
+  CancellationToken token;
+};
+
+struct TaskPoolSettings
+{
+  /// The number of worker threads, 0 means one per hardware thread.
+  std::size_t threads = 0;
+
+  /// The queue the continuations are posted to, null means `ui_queue()`.
+  UiQueue* ui = nullptr;
+};
+
+namespace details
+{
+
+/// A move-only type-erased task.
+class PoolTask
+{
+public:
+  PoolTask() noexcept = default;
+
+  template <typename Fn>
+  explicit PoolTask(Fn&& fn, CancellationToken token)
+    : _callable(std::make_unique<Callable<std::decay_t<Fn>>>(std::forward<Fn>(fn)))
+    , _token(std::move(token))
+  {
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _callable != nullptr;
+  }
+
+  /// Runs the task unless it was cancelled before starting.
+  auto run() -> void
+  {
+    if (!_token.is_cancelled()) {
+      _callable->run();
+    }
+  }
+
+private:
+  struct CallableBase
+  {
+    virtual ~CallableBase() = default;
+    virtual auto run() -> void = 0;
+  };
+
+  template <typename Fn>
+  struct Callable final : CallableBase
+  {
+    explicit Callable(Fn fn)
+      : fn(std::move(fn))
+    {
+    }
+
+    auto run() -> void override
+    {
+      fn();
+    }
+
+    Fn fn;
+  };
+
+  std::unique_ptr<CallableBase> _callable;
+  CancellationToken             _token;
+};
+
+inline constexpr std::size_t TASK_PRIORITY_COUNT = 3;
+
+/// The tasks of one worker: the owner takes the newest ones, thieves the oldest.
+struct alignas(64) WorkerQueue
+{
+  std::mutex               mutex;
+  std::deque<PoolTask>     tasks[TASK_PRIORITY_COUNT];
+  std::atomic<std::size_t> sizes[TASK_PRIORITY_COUNT] = {};
+};
+
+} // namespace details
+
+/// A work-stealing pool of background threads.
+///
+/// Every worker has its own queue per priority: tasks submitted from a worker go
+/// to its own queue (hot in its cache), the others are spread over the workers.
+/// An idle worker takes its newest task of the highest priority available,
+/// or steals the oldest one from another worker before going to sleep.
+///
+/// ```cpp
+/// pool.submit(
+///   [path] { return unpack(path); },
+///   [&webview](UnpackResult const& result) { webview.send_message(result.json); } // On the UI thread.
+/// );
+/// ```
+///
+/// The continuations are posted to a `UiQueue` and only run when the UI loop drains it:
+/// with `run_default`, after `attach_ui_queue_to_message_loop()` (`App/UiQueueMessageLoop.hpp`).
+/// @note The destructor waits for the tasks still queued, cancelled ones excepted: they run
+/// first, their continuations are posted to the queue as usual.
+class TaskPool
+{
+public:
+  explicit TaskPool(TaskPoolSettings settings = {})
+    : _ui(settings.ui)
+    , _count(settings.threads != 0 ? settings.threads : std::max(1u, std::thread::hardware_concurrency()))
+    , _queues(std::make_unique<details::WorkerQueue[]>(_count))
+  {
+    _threads.reserve(_count);
+    for (std::size_t i = 0; i < _count; ++i) {
+      _threads.emplace_back(
+        [this, i]
+        {
+          UBYTES_TRACE_THREAD_NAME("TaskPool worker");
+          work(i);
+        }
+      );
+    }
+  }
+
+  TaskPool(TaskPool const&)                    = delete;
+  auto operator=(TaskPool const&) -> TaskPool& = delete;
+
+  ~TaskPool()
+  {
+    {
+      auto lock = std::lock_guard(_sleep_mutex);
+      _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  /// Returns the number of worker threads.
+  auto thread_count() const noexcept -> std::size_t
+  {
+    return _count;
+  }
+
+  /// Returns the number of queued tasks that have not started yet.
+  auto pending() const noexcept -> std::size_t
+  {
+    return _pending.load(std::memory_order_acquire);
+  }
+
+  /// Runs `work` on a worker thread.
+  /// `work` may take a `CancellationToken` to check it while running.
+  template <typename Work>
+  auto submit(Work&& work, TaskOptions options = {}) -> void
+  {
+    if constexpr (std::is_invocable_v<Work&, CancellationToken const&>) {
+      push(
+        details::PoolTask(
+          [work = std::forward<Work>(work), token = options.token]() mutable
+          {
+            work(token);
+          },
+          options.token
+        ),
+        options.priority
+      );
+    }
+    else {
+      push(details::PoolTask(std::forward<Work>(work), options.token), options.priority);
+    }
+  }
+
+  /// Runs `work` on a worker thread, then `then` with its result on the UI thread.
+  template <typename Work, typename Then>
+  auto submit(Work&& work, Then&& then, TaskOptions options = {}) -> void
+  {
+    submit(
+      [this, work = std::forward<Work>(work), then = std::forward<Then>(then)](CancellationToken const& token) mutable
+      {
+        auto const call = [&]
+        {
+          if constexpr (std::is_invocable_v<Work&, CancellationToken const&>) {
+            return work(token);
+          }
+          else {
+            return work();
+          }
+        };
+
+        if constexpr (std::is_void_v<decltype(call())>) {
+          call();
+          post_to_ui_queue(
+            [then = std::move(then), token]() mutable
+            {
+              if (!token.is_cancelled()) {
+                then();
+              }
+            }
+          );
+        }
+        else {
+          post_to_ui_queue(
+            [then = std::move(then), result = call(), token]() mutable
+            {
+              if (!token.is_cancelled()) {
+                then(std::move(result));
+              }
+            }
+          );
+        }
+      },
+      std::move(options)
+    );
+  }
+
+private:
+  static constexpr std::size_t NO_WORKER = std::size_t(-1);
+
+  /// Identifies the pool and the worker running on the current thread.
+  struct WorkerIdentity
+  {
+    TaskPool const* pool  = nullptr;
+    std::size_t     index = NO_WORKER;
+  };
+
+  static auto current_worker() noexcept -> WorkerIdentity&
+  {
+    thread_local auto identity = WorkerIdentity();
+    return identity;
+  }
+
+  template <typename Fn>
+  auto post_to_ui_queue(Fn&& fn) -> void
+  {
+    (_ui ? *_ui : ui_queue()).post(std::forward<Fn>(fn));
+  }
+
+  auto push(details::PoolTask task, TaskPriority priority) -> void
+  {
+    auto const& worker = current_worker();
+    auto const  index  = worker.pool == this
+                           ? worker.index
+                           : _next_queue.fetch_add(1, std::memory_order_relaxed) % _count;
+    auto const  level  = static_cast<std::size_t>(priority);
+
+    // Count the task first, so that `pending()` never goes below the number of queued tasks.
+    _pending.fetch_add(1, std::memory_order_seq_cst);
+
+    auto& queue = _queues[index];
+    {
+      auto lock = std::lock_guard(queue.mutex);
+      queue.tasks[level].push_back(std::move(task));
+      queue.sizes[level].fetch_add(1, std::memory_order_release);
+    }
+
+    if (_sleeping.load(std::memory_order_seq_cst) > 0) {
+      // Lock to not slip between the check and the wait of a falling asleep worker.
+      { auto lock = std::lock_guard(_sleep_mutex); }
+      _wake.notify_one();
+    }
+  }
+
+  /// Takes a task from a queue: the newest for the owner, the oldest for a thief.
+  auto take(std::size_t index, std::size_t level, bool steal) -> details::PoolTask
+  {
+    auto& queue = _queues[index];
+    if (queue.sizes[level].load(std::memory_order_acquire) == 0) {
+      return details::PoolTask();
+    }
+
+    auto lock = std::unique_lock(queue.mutex, std::defer_lock);
+    if (steal) {
+      if (!lock.try_lock()) {
+        return details::PoolTask();
+      }
+    }
+    else {
+      lock.lock();
+    }
+
+    auto& tasks = queue.tasks[level];
+    if (tasks.empty()) {
+      return details::PoolTask();
+    }
+
+    auto task = std::move(steal ? tasks.front() : tasks.back());
+    if (steal) {
+      tasks.pop_front();
+    }
+    else {
+      tasks.pop_back();
+    }
+    queue.sizes[level].fetch_sub(1, std::memory_order_release);
+    return task;
+  }
+
+  auto find_task(std::size_t index, details::PoolTask& task) -> bool
+  {
+    auto const count = _count;
+    for (std::size_t level = 0; level < details::TASK_PRIORITY_COUNT; ++level) {
+      if (task = take(index, level, false); task) {
+        return true;
+      }
+      for (std::size_t offset = 1; offset < count; ++offset) {
+        if (task = take((index + offset) % count, level, true); task) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  auto work(std::size_t index) -> void
+  {
+    current_worker() = WorkerIdentity{this, index};
+
+    auto task = details::PoolTask();
+    while (true) {
+      if (find_task(index, task)) {
+        _pending.fetch_sub(1, std::memory_order_acq_rel);
+        task.run();
+        task = details::PoolTask();
+        continue;
+      }
+
+      // Stops once the queues are drained. A failed `try_lock()` may have skipped a task,
+      // look again before stopping or sleeping.
+      auto lock = std::unique_lock(_sleep_mutex);
+      if (_pending.load(std::memory_order_seq_cst) != 0) {
+        continue;
+      }
+      if (_stopping) {
+        return;
+      }
+      _sleeping.fetch_add(1, std::memory_order_seq_cst);
+      if (_pending.load(std::memory_order_seq_cst) == 0) {
+        _wake.wait(lock);
+      }
+      _sleeping.fetch_sub(1, std::memory_order_seq_cst);
+    }
+  }
+
+  UiQueue* const                          _ui;
+  std::size_t const                       _count;
+  std::unique_ptr<details::WorkerQueue[]> _queues;
+  std::vector<std::thread>                _threads;
+
+  std::atomic<std::size_t> _next_queue = 0;
+  std::atomic<std::size_t> _pending    = 0;
+  std::atomic<std::size_t> _sleeping   = 0;
+
+  std::mutex              _sleep_mutex;
+  std::condition_variable _wake;
+  bool                    _stopping = false;
+};
+
+/// Returns the shared task pool, sized to the hardware, started on the first call.
+/// Its continuations are posted to `ui_queue()`. It is stopped at exit, once the queued
+/// tasks have run.
+/// @note One per module, like `ui_queue()`.
+inline auto task_pool() -> TaskPool&
+{
+  static auto pool = TaskPool(TaskPoolSettings{.ui = &ui_queue()});
+  return pool;
+}
+
+} // namespace app_platform
+} // namespace ubytes
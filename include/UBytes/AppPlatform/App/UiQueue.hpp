@@ -0,0 +1,241 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// An intrusive node of `UiQueue`, followed in memory by the callable.
+struct UiTask
+{
+  std::atomic<UiTask*> next = nullptr;
+
+  /// Runs (if `run` is true) and releases the task.
+  void (*complete)(UiTask* task, bool run) = nullptr;
+};
+
+template <typename Fn>
+struct UiTaskImpl : UiTask
+{
+  explicit UiTaskImpl(Fn&& fn)
+    : fn(std::move(fn))
+  {
+    complete = [](UiTask* task, bool run)
+    {
+      // Released even if `fn` throws.
+      auto const self = std::unique_ptr<UiTaskImpl>(static_cast<UiTaskImpl*>(task));
+      if (run) {
+        self->fn();
+      }
+    };
+  }
+
+  Fn fn;
+};
+
+} // namespace details
+
+/// A multi-producer, single-consumer queue of tasks for the UI thread.
+///
+/// Posting is wait-free: one allocation, one atomic exchange to link the task
+/// and one to check whether the loop has to be woken up. The loop is woken up
+/// once per batch, not once per task: after a wake-up, further posts only link
+/// their tasks until the loop calls `drain()`.
+///
+/// Nothing drains the queue by itself, the `run_default` loop included. The consumer side
+/// (a custom loop, or the message loop of `run_default` once attached with
+/// `attach_ui_queue_to_message_loop()` from `App/UiQueueMessageLoop.hpp`) does:
+///
+/// ```cpp
+/// queue.set_waker([] { /* post a native message to the loop */ });
+/// // ... when the native message arrives:
+/// queue.drain();
+/// ```
+/// @note Based on the intrusive MPSC queue by Dmitry Vyukov.
+class UiQueue
+{
+public:
+  /// Wakes the UI loop up, called from the posting thread.
+  using Waker = std::function<void()>;
+
+  UiQueue() noexcept
+    : _head(&_stub)
+    , _tail(&_stub)
+  {
+  }
+
+  UiQueue(UiQueue const&)                    = delete;
+  auto operator=(UiQueue const&) -> UiQueue& = delete;
+
+  /// Destroys the remaining tasks without running them.
+  ~UiQueue()
+  {
+    while (auto* task = pop()) {
+      task->complete(task, false);
+    }
+  }
+
+  /// Sets the function that wakes the UI loop up.
+  /// @note Set it before the first `post()`, it is not synchronized with posting threads.
+  auto set_waker(Waker waker) -> void
+  {
+    _waker = std::move(waker);
+    if (_wake_pending.load(std::memory_order_acquire) && _waker) {
+      _waker();
+    }
+  }
+
+  /// Queues `fn` to be run on the UI thread. Safe to call from any thread.
+  template <typename Fn>
+  auto post(Fn&& fn) -> void
+  {
+    using Task = details::UiTaskImpl<std::decay_t<Fn>>;
+    push(new Task(std::decay_t<Fn>(std::forward<Fn>(fn))));
+  }
+
+  /// Queues a task whose storage is owned by the caller (e.g. an awaiter living
+  /// in a coroutine frame). It must stay alive until its `complete` is called.
+  auto post_task(details::UiTask& task) -> void
+  {
+    push(&task);
+  }
+
+  /// Runs the tasks queued so far, in posting order. Call it on the UI thread.
+  /// Tasks posted while draining are left for the next wake-up, so a busy
+  /// producer cannot keep the loop from processing its native events.
+  /// @return The number of tasks run.
+  auto drain() -> std::size_t
+  {
+    // Clear the flag first: a task linked after this point wakes the loop up again.
+    _wake_pending.store(false, std::memory_order_seq_cst);
+
+    auto* const last = _head.load(std::memory_order_acquire);
+    if (last == &_stub) {
+      return 0;
+    }
+
+    UBYTES_TRACE_SCOPE_METRIC("UiQueue::drain", TraceMetric::LoopTick);
+
+    std::size_t count = 0;
+    while (auto* task = pop()) {
+      auto const done = task == last;
+      task->complete(task, true);
+      ++count;
+      if (done) {
+        break;
+      }
+    }
+    return count;
+  }
+
+  /// Returns the number of times the loop was woken up.
+  auto wakes() const noexcept -> std::size_t
+  {
+    return _wakes.load(std::memory_order_relaxed);
+  }
+
+private:
+  auto push(details::UiTask* task) -> void
+  {
+    link(task);
+    if (!_wake_pending.exchange(true, std::memory_order_seq_cst)) {
+      _wakes.fetch_add(1, std::memory_order_relaxed);
+      if (_waker) {
+        _waker();
+      }
+    }
+  }
+
+  auto link(details::UiTask* task) noexcept -> void
+  {
+    task->next.store(nullptr, std::memory_order_relaxed);
+    auto* prev = _head.exchange(task, std::memory_order_acq_rel);
+    prev->next.store(task, std::memory_order_release);
+  }
+
+  /// Returns the oldest task, or null if the queue is empty (or a producer is
+  /// between the two steps of `link()`; its wake-up check comes after linking).
+  auto pop() noexcept -> details::UiTask*
+  {
+    auto* tail = _tail;
+    auto* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &_stub) {
+      if (!next) {
+        return nullptr;
+      }
+      _tail = next;
+      tail  = next;
+      next  = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+      _tail = next;
+      return tail;
+    }
+
+    if (tail != _head.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    // `tail` is the last task, put the stub behind it to be able to unlink it.
+    link(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+      _tail = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  // The producers and the consumer write to different cache lines.
+  alignas(64) std::atomic<details::UiTask*> _head;
+  alignas(64) std::atomic<bool> _wake_pending = false;
+  std::atomic<std::size_t>      _wakes        = 0;
+
+  alignas(64) details::UiTask* _tail;
+  details::UiTask _stub;
+  Waker           _waker;
+};
+
+/// Returns the queue of the UI thread, the default of the helpers that post to it.
+/// @note One per module: an executable and the DLLs it loads have a queue each. The loop of
+/// the UI thread must install the waker and drain it, `run_default` does not: see
+/// `attach_ui_queue_to_message_loop()` in `App/UiQueueMessageLoop.hpp`.
+inline auto ui_queue() -> UiQueue&
+{
+  static auto queue = UiQueue();
+  return queue;
+}
+
+/// Runs `fn` on the UI thread, from any thread.
+///
+/// `Window` and `WebView` must only be used from the UI thread; worker threads
+/// hand their results over with this:
+///
+/// ```cpp
+/// std::thread([&webview] {
+///   auto result = compute();
+///   post_to_ui([&webview, result] { webview.send_message(result); });
+/// }).detach();
+/// ```
+template <typename Fn>
+auto post_to_ui(Fn&& fn) -> void
+{
+  ui_queue().post(std::forward<Fn>(fn));
+}
+
+} // namespace app_platform
+} // namespace ubytes
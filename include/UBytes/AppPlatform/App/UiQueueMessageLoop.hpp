@@ -0,0 +1,68 @@
+#pragma once
+
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+
+// Opt-in, not included by `App.hpp`, as it includes `<windows.h>`.
+
+#if defined(_WIN32)
+
+// Without the `min`/`max` macros, which would break `std::min`/`std::max` in the headers included later.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Makes the message loop of the calling thread drain `queue`, e.g. the loop of `run_default`,
+/// which does not know about the queue: creates a message-only window that drains it, and
+/// installs a waker that posts a message to that window. Call it from the UI thread before
+/// the first post, e.g. at the start of `on_start`:
+///
+/// ```cpp
+/// auto on_start() -> void override
+/// {
+///   attach_ui_queue_to_message_loop();
+///   // ...
+/// }
+/// ```
+/// @return false if the window could not be created.
+inline auto attach_ui_queue_to_message_loop(UiQueue& queue = ui_queue()) -> bool
+{
+  static constexpr wchar_t CLASS_NAME[] = L"UBytesAppPlatformUiQueue";
+
+  auto window_class          = WNDCLASSW();
+  window_class.hInstance     = ::GetModuleHandleW(nullptr);
+  window_class.lpszClassName = CLASS_NAME;
+  window_class.lpfnWndProc   = [](HWND window, UINT message, WPARAM wparam, LPARAM lparam) -> LRESULT
+  {
+    if (message == WM_APP) {
+      reinterpret_cast<UiQueue*>(lparam)->drain();
+      return 0;
+    }
+    return ::DefWindowProcW(window, message, wparam, lparam);
+  };
+  // Fails once the class is registered, which is fine.
+  ::RegisterClassW(&window_class);
+
+  auto const window =
+    ::CreateWindowExW(0, CLASS_NAME, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, window_class.hInstance, nullptr);
+  if (!window) {
+    return false;
+  }
+  queue.set_waker(
+    [window, &queue]
+    {
+      ::PostMessageW(window, WM_APP, 0, reinterpret_cast<LPARAM>(&queue));
+    }
+  );
+  return true;
+}
+
+} // namespace app_platform
+} // namespace ubytes
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/Core/Task.hpp>
+
+#include <coroutine>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Awaiter that continues the coroutine on the UI thread, on the next drain of a `UiQueue`.
+///
+/// The awaiter itself is the queued task (it lives in the coroutine frame),
+/// so switching threads does not allocate.
+/// @note If the queue is destroyed before draining, the coroutine is not resumed.
+class ResumeOnUi : private details::UiTask
+{
+public:
+  explicit ResumeOnUi(UiQueue& queue) noexcept
+    : _queue(queue)
+  {
+    complete = [](details::UiTask* task, bool run)
+    {
+      if (run) {
+        static_cast<ResumeOnUi*>(task)->_handle.resume();
+      }
+    };
+  }
+
+  auto await_ready() const noexcept -> bool
+  {
+    return false;
+  }
+
+  auto await_suspend(std::coroutine_handle<> handle) -> void
+  {
+    _handle = handle;
+    _queue.post_task(*this);
+  }
+
+  auto await_resume() const noexcept -> void
+  {
+  }
+
+private:
+  UiQueue&                _queue;
+  std::coroutine_handle<> _handle;
+};
+
+/// Continues the coroutine on the UI thread, at the next drain of the queue (with `run_default`,
+/// once attached by `attach_ui_queue_to_message_loop()`):
+///
+/// ```cpp
+/// auto result = co_await decompress_in_background(path);
+/// co_await resume_on_ui();
+/// webview.send_message(result);
+/// ```
+inline auto resume_on_ui(UiQueue& queue = ui_queue()) noexcept -> ResumeOnUi
+{
+  return ResumeOnUi(queue);
+}
+
+} // namespace app_platform
+} // namespace ubytes
@@ -2,6 +2,22 @@
 
 #include <UBytes/AppPlatform/Core/Vec2.hpp>
 #include <UBytes/AppPlatform/Core/Color.hpp>
+#include <UBytes/AppPlatform/Core/Pixels.hpp>
+#include <UBytes/AppPlatform/Core/ImageCodec.hpp>
 #include <UBytes/AppPlatform/Core/Rect.hpp>
+#include <UBytes/AppPlatform/Core/Region.hpp>
+#include <UBytes/AppPlatform/Core/Utf.hpp>
+#include <UBytes/AppPlatform/Core/Text.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/MessageBuffer.hpp>
+#include <UBytes/AppPlatform/Core/Base64.hpp>
+#include <UBytes/AppPlatform/Core/PerfectHash.hpp>
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+#include <UBytes/AppPlatform/Core/EmbeddedAssets.hpp>
+#include <UBytes/AppPlatform/Core/Task.hpp>
+#include <UBytes/AppPlatform/Core/Delegate.hpp>
+#include <UBytes/AppPlatform/Core/Event.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
 
 // TODO: include every header file in `Core/` folder
\ No newline at end of file
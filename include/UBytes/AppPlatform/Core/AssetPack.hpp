@@ -0,0 +1,560 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// How the bytes of an asset are encoded, served as `Content-Encoding`.
+enum class AssetEncoding : std::uint8_t
+{
+  Identity = 0,
+  Gzip     = 1,
+  Brotli   = 2,
+};
+
+/// Returns the `Content-Encoding` value of an encoding, empty for `Identity`.
+constexpr auto content_encoding_name(AssetEncoding encoding) noexcept -> std::string_view
+{
+  switch (encoding) {
+  case AssetEncoding::Gzip: return "gzip";
+  case AssetEncoding::Brotli: return "br";
+  default: return {};
+  }
+}
+
+/// A view of a stored asset. The views point into the storage (e.g. the mapped pack)
+/// and stay valid as long as it does.
+struct Asset
+{
+  std::string_view           path;
+  std::span<std::byte const> data;
+  std::string_view           mime_type;
+  /// A quoted strong ETag, ready to be used as a header value.
+  std::string_view etag;
+  AssetEncoding    encoding = AssetEncoding::Identity;
+  /// The size of the asset once decoded.
+  std::uint64_t original_size = 0;
+};
+
+namespace details
+{
+
+constexpr auto asset_hash(std::span<std::byte const> bytes) noexcept -> std::uint64_t
+{
+  auto hash = std::uint64_t(14695981039346656037ull);
+  for (auto byte : bytes) {
+    hash = (hash ^ static_cast<std::uint8_t>(byte)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+constexpr auto asset_path_hash(std::string_view path) noexcept -> std::uint64_t
+{
+  auto hash = std::uint64_t(14695981039346656037ull);
+  for (auto c : path) {
+    hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/// Removes the leading slashes, paths are stored relative to the root.
+constexpr auto asset_relative_path(std::string_view path) noexcept -> std::string_view
+{
+  while (!path.empty() && path.front() == '/') {
+    path.remove_prefix(1);
+  }
+  return path;
+}
+
+} // namespace details
+
+/// Guesses the MIME type of a file from its extension, `application/octet-stream` if unknown.
+constexpr auto mime_type_for(std::string_view path) noexcept -> std::string_view
+{
+  struct Mapping
+  {
+    std::string_view extension;
+    std::string_view mime_type;
+  };
+
+  constexpr Mapping MAPPINGS[] = {
+    {".html", "text/html; charset=utf-8"},
+    {".htm", "text/html; charset=utf-8"},
+    {".js", "text/javascript; charset=utf-8"},
+    {".mjs", "text/javascript; charset=utf-8"},
+    {".css", "text/css; charset=utf-8"},
+    {".json", "application/json"},
+    {".map", "application/json"},
+    {".wasm", "application/wasm"},
+    {".svg", "image/svg+xml"},
+    {".png", "image/png"},
+    {".jpg", "image/jpeg"},
+    {".jpeg", "image/jpeg"},
+    {".gif", "image/gif"},
+    {".webp", "image/webp"},
+    {".avif", "image/avif"},
+    {".ico", "image/x-icon"},
+    {".woff", "font/woff"},
+    {".woff2", "font/woff2"},
+    {".ttf", "font/ttf"},
+    {".otf", "font/otf"},
+    {".txt", "text/plain; charset=utf-8"},
+    {".xml", "application/xml"},
+    {".mp3", "audio/mpeg"},
+    {".wav", "audio/wav"},
+    {".mp4", "video/mp4"},
+    {".webm", "video/webm"},
+  };
+
+  auto const dot = path.rfind('.');
+  if (dot == std::string_view::npos || path.find('/', dot) != std::string_view::npos) {
+    return "application/octet-stream";
+  }
+
+  auto const extension = path.substr(dot);
+  for (auto const& mapping : MAPPINGS) {
+    if (mapping.extension.size() != extension.size()) {
+      continue;
+    }
+    auto const same = std::equal(
+      extension.begin(),
+      extension.end(),
+      mapping.extension.begin(),
+      [](char a, char b)
+      {
+        return (a >= 'A' && a <= 'Z' ? char(a - 'A' + 'a') : a) == b;
+      }
+    );
+    if (same) {
+      return mapping.mime_type;
+    }
+  }
+  return "application/octet-stream";
+}
+
+/// Returns a quoted strong ETag for the given contents.
+inline auto asset_etag(std::span<std::byte const> data) -> std::string
+{
+  constexpr char DIGITS[] = "0123456789abcdef";
+
+  auto hash = details::asset_hash(data);
+  auto etag = std::string(18, '"');
+  for (std::size_t i = 16; i > 0; --i, hash >>= 4) {
+    etag[i] = DIGITS[hash & 0xF];
+  }
+  return etag;
+}
+
+namespace details
+{
+
+// The pack layout, all integers are little-endian:
+//
+//   AssetPackHeader
+//   AssetPackEntry[entry_count]   sorted by (path_hash, path)
+//   strings                       paths, MIME types and ETags
+//   data                          16-byte aligned blobs
+
+constexpr std::uint32_t ASSET_PACK_MAGIC   = 0x4B504255; // "UBPK"
+constexpr std::uint32_t ASSET_PACK_VERSION = 1;
+
+struct AssetPackHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t entry_count;
+  std::uint32_t reserved;
+  std::uint64_t strings_offset;
+  std::uint64_t strings_size;
+};
+static_assert(sizeof(AssetPackHeader) == 32, "AssetPackHeader size is invalid");
+
+struct AssetPackEntry
+{
+  std::uint64_t path_hash;
+  std::uint64_t data_offset;
+  std::uint64_t data_size;
+  std::uint64_t original_size;
+  std::uint32_t path_offset;
+  std::uint32_t path_size;
+  std::uint32_t mime_offset;
+  std::uint32_t etag_offset;
+  std::uint16_t mime_size;
+  std::uint8_t  etag_size;
+  std::uint8_t  encoding;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(AssetPackEntry) == 56, "AssetPackEntry size is invalid");
+
+static_assert(std::endian::native == std::endian::little, "AssetPack expects a little-endian target");
+
+} // namespace details
+
+/// A read-only, indexed bundle of web assets.
+///
+/// The directory is sorted by path hash, a lookup is a binary search over it and
+/// returns views into the pack: nothing is copied or decompressed. Compressed
+/// entries are meant to be served as they are, with `Content-Encoding` set.
+///
+/// ```cpp
+/// auto pack = open_asset_pack("assets.pack"); // `Core/AssetPackFile.hpp`
+/// if (auto asset = pack.find("/index.html")) {
+///   // asset->data, asset->mime_type, asset->etag...
+/// }
+/// ```
+/// @note Build packs with `AssetPackBuilder`. The pack is validated once when opened,
+/// a malformed one is empty. Copies share the storage.
+class AssetPack
+{
+public:
+  AssetPack() noexcept = default;
+
+  /// Uses a pack stored in memory (e.g. embedded in the binary). The memory must outlive the pack.
+  static auto from_memory(std::span<std::byte const> bytes) -> AssetPack
+  {
+    auto pack = AssetPack();
+    if (validate(bytes)) {
+      auto const header = header_of(bytes);
+
+      pack._bytes   = bytes;
+      pack._count   = header.entry_count;
+      pack._strings = static_cast<std::size_t>(header.strings_offset);
+    }
+    return pack;
+  }
+
+  /// Uses a pack stored in memory owned by `owner`, which the pack keeps alive
+  /// (e.g. a `MappedFile`, see `open_asset_pack()`).
+  static auto from_memory(std::span<std::byte const> bytes, std::shared_ptr<void const> owner) -> AssetPack
+  {
+    auto pack = from_memory(bytes);
+    if (pack.valid()) {
+      pack._owner = std::move(owner);
+    }
+    return pack;
+  }
+
+  auto valid() const noexcept -> bool
+  {
+    return !_bytes.empty();
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _count;
+  }
+
+  /// Finds an asset by its path, leading slashes are ignored.
+  auto find(std::string_view path) const -> std::optional<Asset>
+  {
+    path = details::asset_relative_path(path);
+
+    auto const hash = details::asset_path_hash(path);
+
+    // Lower bound on the hash, then compare the paths of the colliding entries. The
+    // halving has no branch on the comparison: the hashes are random, it would miss half the time.
+    std::size_t first = 0;
+    std::size_t count = _count;
+    while (count > 1) {
+      auto const half = count / 2;
+      first           = hash_at(first + half - 1) < hash ? first + half : first;
+      count          -= half;
+    }
+    if (count == 1 && hash_at(first) < hash) {
+      ++first;
+    }
+
+    for (; first < _count && hash_at(first) == hash; ++first) {
+      auto const entry = entry_at(first);
+      if (string_at(entry.path_offset, entry.path_size) == path) {
+        return asset_of(entry);
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the asset at `index` (in directory order).
+  auto at(std::size_t index) const -> Asset
+  {
+    return asset_of(entry_at(index));
+  }
+
+private:
+  static auto header_of(std::span<std::byte const> bytes) noexcept -> details::AssetPackHeader
+  {
+    auto header = details::AssetPackHeader();
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+  }
+
+  static auto validate(std::span<std::byte const> bytes) noexcept -> bool
+  {
+    using details::AssetPackEntry;
+    using details::AssetPackHeader;
+
+    if (bytes.size() < sizeof(AssetPackHeader)) {
+      return false;
+    }
+
+    auto const header = header_of(bytes);
+    auto const size   = std::uint64_t(bytes.size());
+    auto const table  = std::uint64_t(header.entry_count) * sizeof(AssetPackEntry);
+    if (header.magic != details::ASSET_PACK_MAGIC || header.version != details::ASSET_PACK_VERSION ||
+        table > size - sizeof(AssetPackHeader) || header.strings_offset < sizeof(AssetPackHeader) + table ||
+        header.strings_offset > size || header.strings_size > size - header.strings_offset) {
+      return false;
+    }
+
+    auto const within = [size](std::uint64_t offset, std::uint64_t length)
+    {
+      return offset <= size && length <= size - offset;
+    };
+    auto previous = std::uint64_t(0);
+    for (std::uint32_t i = 0; i < header.entry_count; ++i) {
+      auto entry = AssetPackEntry();
+      std::memcpy(&entry, bytes.data() + sizeof(AssetPackHeader) + i * sizeof(AssetPackEntry), sizeof(entry));
+
+      if (entry.path_hash < previous || entry.encoding > std::uint8_t(AssetEncoding::Brotli) ||
+          !within(entry.data_offset, entry.data_size) ||
+          std::uint64_t(entry.path_offset) + entry.path_size > header.strings_size ||
+          std::uint64_t(entry.mime_offset) + entry.mime_size > header.strings_size ||
+          std::uint64_t(entry.etag_offset) + entry.etag_size > header.strings_size) {
+        return false;
+      }
+      previous = entry.path_hash;
+    }
+    return true;
+  }
+
+  auto hash_at(std::size_t index) const noexcept -> std::uint64_t
+  {
+    auto hash = std::uint64_t();
+    std::memcpy(&hash, _bytes.data() + sizeof(details::AssetPackHeader) + index * sizeof(details::AssetPackEntry), 8);
+    return hash;
+  }
+
+  auto entry_at(std::size_t index) const noexcept -> details::AssetPackEntry
+  {
+    auto entry = details::AssetPackEntry();
+    std::memcpy(
+      &entry,
+      _bytes.data() + sizeof(details::AssetPackHeader) + index * sizeof(details::AssetPackEntry),
+      sizeof(entry)
+    );
+    return entry;
+  }
+
+  auto string_at(std::uint32_t offset, std::uint32_t size) const noexcept -> std::string_view
+  {
+    return std::string_view(reinterpret_cast<char const*>(_bytes.data() + _strings + offset), size);
+  }
+
+  auto asset_of(details::AssetPackEntry const& entry) const noexcept -> Asset
+  {
+    auto asset          = Asset();
+    asset.path          = string_at(entry.path_offset, entry.path_size);
+    asset.data          = _bytes.subspan(entry.data_offset, entry.data_size);
+    asset.mime_type     = string_at(entry.mime_offset, entry.mime_size);
+    asset.etag          = string_at(entry.etag_offset, entry.etag_size);
+    asset.encoding      = static_cast<AssetEncoding>(entry.encoding);
+    asset.original_size = entry.original_size;
+    return asset;
+  }
+
+  std::shared_ptr<void const> _owner;
+  std::span<std::byte const>  _bytes;
+  std::size_t                 _count   = 0;
+  std::size_t                 _strings = 0;
+};
+
+/// Options of an asset added to an `AssetPackBuilder`.
+struct AssetOptions
+{
+  /// Guessed from the extension when empty.
+  std::string_view mime_type;
+
+  /// The encoding of the given bytes. The pack does not compress by itself:
+  /// pass the output of gzip or brotli along with its encoding.
+  AssetEncoding encoding = AssetEncoding::Identity;
+
+  /// The decoded size, for encoded assets.
+  std::uint64_t original_size = 0;
+
+  /// Computed from the bytes when empty.
+  std::string_view etag;
+};
+
+/// Builds an `AssetPack`, typically in a build step.
+///
+/// ```cpp
+/// auto builder = AssetPackBuilder();
+/// builder.add("index.html", html_bytes);
+/// builder.add("app.js", gzipped_js, {.encoding = AssetEncoding::Gzip, .original_size = js_size});
+/// builder.save("assets.pack");
+/// ```
+class AssetPackBuilder
+{
+public:
+  /// Adds an asset, replacing an existing one with the same path.
+  auto add(std::string_view path, std::span<std::byte const> data, AssetOptions options = {}) -> void
+  {
+    path = details::asset_relative_path(path);
+
+    auto const mime_type = options.mime_type.empty() ? mime_type_for(path) : options.mime_type;
+
+    // The directory stores the MIME type size in 16 bits and the ETag size in 8 bits.
+    auto item          = Item();
+    item.path          = std::string(path);
+    item.data.assign(data.begin(), data.end());
+    item.mime_type     = std::string(mime_type.substr(0, 0xFFFF));
+    item.etag          = options.etag.empty() ? asset_etag(data) : std::string(options.etag.substr(0, 255));
+    item.encoding      = options.encoding;
+    item.original_size = options.encoding == AssetEncoding::Identity ? data.size() : options.original_size;
+
+    auto const existing = std::find_if(
+      _items.begin(),
+      _items.end(),
+      [&](Item const& other)
+      {
+        return other.path == item.path;
+      }
+    );
+    if (existing != _items.end()) {
+      *existing = std::move(item);
+    }
+    else {
+      _items.push_back(std::move(item));
+    }
+  }
+
+  auto add(std::string_view path, std::string_view data, AssetOptions options = {}) -> void
+  {
+    add(path, std::as_bytes(std::span(data.data(), data.size())), options);
+  }
+
+  /// Serializes the pack.
+  auto build() const -> std::vector<std::byte>
+  {
+    using details::AssetPackEntry;
+    using details::AssetPackHeader;
+
+    auto order = std::vector<std::pair<std::uint64_t, Item const*>>();
+    order.reserve(_items.size());
+    for (auto const& item : _items) {
+      order.emplace_back(details::asset_path_hash(item.path), &item);
+    }
+    std::sort(
+      order.begin(),
+      order.end(),
+      [](auto const& a, auto const& b)
+      {
+        return a.first != b.first ? a.first < b.first : a.second->path < b.second->path;
+      }
+    );
+
+    // Strings, with the MIME types and ETags deduplicated.
+    auto strings  = std::string();
+    auto interned = std::unordered_map<std::string_view, std::uint32_t>();
+    auto intern   = [&](std::string_view value) -> std::uint32_t
+    {
+      auto const [it, inserted] = interned.try_emplace(value, static_cast<std::uint32_t>(strings.size()));
+      if (inserted) {
+        strings += value;
+      }
+      return it->second;
+    };
+
+    auto entries = std::vector<AssetPackEntry>(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      auto const& item  = *order[i].second;
+      auto&       entry = entries[i];
+
+      entry.path_hash     = order[i].first;
+      entry.path_offset   = static_cast<std::uint32_t>(strings.size());
+      entry.path_size     = static_cast<std::uint32_t>(item.path.size());
+      strings += item.path;
+      entry.mime_offset   = intern(item.mime_type);
+      entry.mime_size     = static_cast<std::uint16_t>(item.mime_type.size());
+      entry.etag_offset   = intern(item.etag);
+      entry.etag_size     = static_cast<std::uint8_t>(item.etag.size());
+      entry.encoding      = static_cast<std::uint8_t>(item.encoding);
+      entry.data_size     = item.data.size();
+      entry.original_size = item.original_size;
+    }
+
+    auto const align = [](std::uint64_t offset)
+    {
+      return (offset + 15) & ~std::uint64_t(15);
+    };
+
+    auto header           = AssetPackHeader();
+    header.magic          = details::ASSET_PACK_MAGIC;
+    header.version        = details::ASSET_PACK_VERSION;
+    header.entry_count    = static_cast<std::uint32_t>(entries.size());
+    header.strings_offset = sizeof(AssetPackHeader) + entries.size() * sizeof(AssetPackEntry);
+    header.strings_size   = strings.size();
+
+    auto offset = align(header.strings_offset + header.strings_size);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      entries[i].data_offset = offset;
+      offset                 = align(offset + entries[i].data_size);
+    }
+
+    auto bytes = std::vector<std::byte>(offset);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!entries.empty()) {
+      std::memcpy(bytes.data() + sizeof(header), entries.data(), entries.size() * sizeof(AssetPackEntry));
+    }
+    std::memcpy(bytes.data() + header.strings_offset, strings.data(), strings.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      auto const& data = order[i].second->data;
+      std::copy(data.begin(), data.end(), bytes.begin() + static_cast<std::ptrdiff_t>(entries[i].data_offset));
+    }
+    return bytes;
+  }
+
+  /// Writes the pack to a file (UTF-8 path). Returns false on failure.
+  auto save(std::string_view path) const -> bool
+  {
+    auto const bytes = build();
+    auto       file  = std::ofstream(std::string(path), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _items.size();
+  }
+
+private:
+  struct Item
+  {
+    std::string            path;
+    std::vector<std::byte> data;
+    std::string            mime_type;
+    std::string            etag;
+    AssetEncoding          encoding      = AssetEncoding::Identity;
+    std::uint64_t          original_size = 0;
+  };
+
+  std::vector<Item> _items;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+#include <UBytes/AppPlatform/Core/MappedFile.hpp>
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+// Opt-in, not included by `Core.hpp`, as `MappedFile.hpp` includes `<windows.h>` on Windows.
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Memory-maps a pack file (UTF-8 path). The mapping is kept as long as the pack or a copy of it.
+/// @return an empty pack if the file cannot be mapped or is malformed.
+inline auto open_asset_pack(std::string_view path) -> AssetPack
+{
+  auto file = MappedFile::open(path);
+  if (!file) {
+    return AssetPack();
+  }
+
+  auto const mapping = std::make_shared<MappedFile const>(std::move(file));
+  return AssetPack::from_memory(mapping->bytes(), mapping);
+}
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Returns the length of the padded base64 encoding of `size` bytes.
+constexpr auto base64_encoded_size(std::size_t size) noexcept -> std::size_t
+{
+  return (size + 2) / 3 * 4;
+}
+
+/// Returns the maximum number of bytes decoded from `size` base64 characters.
+constexpr auto base64_decoded_capacity(std::size_t size) noexcept -> std::size_t
+{
+  return (size + 3) / 4 * 3;
+}
+
+/// The vectorized decoder stores whole blocks, so it stops `BASE64_DECODE_SLACK` bytes
+/// before the end of the output. Add it to the output buffer size to keep the fast path
+/// for the whole input.
+inline constexpr std::size_t BASE64_DECODE_SLACK = 8;
+
+namespace details
+{
+
+inline constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+inline constexpr auto BASE64_DECODE_TABLE = []
+{
+  auto table = std::array<std::uint8_t, 256>();
+  table.fill(0xFF);
+  for (std::uint8_t i = 0; i < 64; ++i) {
+    table[static_cast<std::uint8_t>(BASE64_ALPHABET[i])] = i;
+  }
+  return table;
+}();
+
+inline auto base64_encode_scalar(std::uint8_t const*& in, std::uint8_t const* end, char*& out) noexcept -> void
+{
+  while (end - in >= 3) {
+    auto const v = (std::uint32_t(in[0]) << 16) | (std::uint32_t(in[1]) << 8) | in[2];
+    out[0]       = BASE64_ALPHABET[(v >> 18) & 0x3F];
+    out[1]       = BASE64_ALPHABET[(v >> 12) & 0x3F];
+    out[2]       = BASE64_ALPHABET[(v >> 6) & 0x3F];
+    out[3]       = BASE64_ALPHABET[v & 0x3F];
+    in += 3;
+    out += 4;
+  }
+
+  if (end - in == 1) {
+    auto const v = std::uint32_t(in[0]) << 16;
+    out[0]       = BASE64_ALPHABET[(v >> 18) & 0x3F];
+    out[1]       = BASE64_ALPHABET[(v >> 12) & 0x3F];
+    out[2]       = '=';
+    out[3]       = '=';
+    in += 1;
+    out += 4;
+  }
+  else if (end - in == 2) {
+    auto const v = (std::uint32_t(in[0]) << 16) | (std::uint32_t(in[1]) << 8);
+    out[0]       = BASE64_ALPHABET[(v >> 18) & 0x3F];
+    out[1]       = BASE64_ALPHABET[(v >> 12) & 0x3F];
+    out[2]       = BASE64_ALPHABET[(v >> 6) & 0x3F];
+    out[3]       = '=';
+    in += 2;
+    out += 4;
+  }
+}
+
+/// Decodes whole 4-character groups (no padding).
+/// @return false on an invalid character, `in` points at its group.
+inline auto base64_decode_scalar(char const*& in, char const* end, std::uint8_t*& out) noexcept -> bool
+{
+  while (end - in >= 4) {
+    auto const a = BASE64_DECODE_TABLE[static_cast<std::uint8_t>(in[0])];
+    auto const b = BASE64_DECODE_TABLE[static_cast<std::uint8_t>(in[1])];
+    auto const c = BASE64_DECODE_TABLE[static_cast<std::uint8_t>(in[2])];
+    auto const d = BASE64_DECODE_TABLE[static_cast<std::uint8_t>(in[3])];
+    if ((a | b | c | d) & 0x80) {
+      return false;
+    }
+
+    auto const v = (std::uint32_t(a) << 18) | (std::uint32_t(b) << 12) | (std::uint32_t(c) << 6) | d;
+    out[0]       = static_cast<std::uint8_t>(v >> 16);
+    out[1]       = static_cast<std::uint8_t>(v >> 8);
+    out[2]       = static_cast<std::uint8_t>(v);
+    in += 4;
+    out += 3;
+  }
+  return true;
+}
+
+// Vectorized kernels, based on the SSSE3/AVX2 algorithms by Wojciech Muła
+// and Daniel Lemire: 12 bytes <-> 16 characters per 128-bit lane.
+
+#if UBYTES_APP_PLATFORM_X86
+
+struct Base64Sse41
+{
+  UBYTES_TARGET_SSE41 static auto encode(__m128i in) noexcept -> __m128i
+  {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    auto const t0      = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+    auto const t1      = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    auto const t2      = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+    auto const t3      = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    auto const indices = _mm_or_si128(t1, t3);
+
+    auto const shift_lut = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '+' - 62, '/' - 63, 'A', 0, 0
+    );
+
+    auto       shift = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto const less  = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    shift            = _mm_or_si128(shift, _mm_and_si128(less, _mm_set1_epi8(13)));
+    shift            = _mm_shuffle_epi8(shift_lut, shift);
+    return _mm_add_epi8(shift, indices);
+  }
+
+  /// @return false if the block contains a non-base64 character.
+  UBYTES_TARGET_SSE41 static auto decode(__m128i in, __m128i& out) noexcept -> bool
+  {
+    auto const lut_lo = _mm_setr_epi8(
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+    );
+    auto const lut_hi = _mm_setr_epi8(
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+    );
+    auto const lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const nibble   = _mm_set1_epi8(0x0F);
+
+    auto const hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+    auto const lo_nibbles = _mm_and_si128(in, nibble);
+    auto const lo         = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    auto const hi         = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (!_mm_testz_si128(lo, hi)) {
+      return false;
+    }
+
+    auto const eq_slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    auto const roll     = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_slash, hi_nibbles));
+    auto const values   = _mm_add_epi8(in, roll);
+
+    auto const merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    auto const packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    out = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+  }
+};
+
+struct Base64Avx2
+{
+  UBYTES_TARGET_AVX2 static auto encode(__m256i in) noexcept -> __m256i
+  {
+    in = _mm256_shuffle_epi8(
+      in,
+      _mm256_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1
+      )
+    );
+
+    auto const t0      = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+    auto const t1      = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    auto const t2      = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+    auto const t3      = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    auto const indices = _mm256_or_si256(t1, t3);
+
+    auto const shift_lut = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+    );
+
+    auto       shift = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    auto const less  = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    shift            = _mm256_or_si256(shift, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    shift            = _mm256_shuffle_epi8(shift_lut, shift);
+    return _mm256_add_epi8(shift, indices);
+  }
+
+  /// @return false if the block contains a non-base64 character.
+  UBYTES_TARGET_AVX2 static auto decode(__m256i in, __m256i& out) noexcept -> bool
+  {
+    auto const lut_lo = _mm256_setr_epi8(
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11,
+      0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+    );
+    auto const lut_hi = _mm256_setr_epi8(
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01,
+      0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+    );
+    auto const lut_roll = _mm256_setr_epi8(
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+    );
+    auto const nibble = _mm256_set1_epi8(0x0F);
+
+    auto const hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+    auto const lo_nibbles = _mm256_and_si256(in, nibble);
+    auto const lo         = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    auto const hi         = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    if (!_mm256_testz_si256(lo, hi)) {
+      return false;
+    }
+
+    auto const eq_slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+    auto const roll     = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_slash, hi_nibbles));
+    auto const values   = _mm256_add_epi8(in, roll);
+
+    auto const merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    auto const packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    auto const lanes  = _mm256_shuffle_epi8(
+      packed,
+      _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+      )
+    );
+    // Join the 12 valid bytes of both lanes.
+    out = _mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    return true;
+  }
+};
+
+UBYTES_TARGET_SSE41 inline auto base64_encode_sse41(std::uint8_t const*& in, std::uint8_t const* end, char*& out) noexcept
+  -> void
+{
+  // Loads 16 bytes, uses 12.
+  while (end - in >= 16) {
+    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), Base64Sse41::encode(block));
+    in += 12;
+    out += 16;
+  }
+}
+
+UBYTES_TARGET_AVX2 inline auto base64_encode_avx2(std::uint8_t const*& in, std::uint8_t const* end, char*& out) noexcept
+  -> void
+{
+  // Two independent 12 -> 16 lanes, loads 28 bytes, uses 24.
+  while (end - in >= 28) {
+    auto const lo    = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    auto const hi    = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + 12));
+    auto const block = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), Base64Avx2::encode(block));
+    in += 24;
+    out += 32;
+  }
+  base64_encode_sse41(in, end, out);
+}
+
+UBYTES_TARGET_SSE41 inline auto base64_decode_sse41(
+  char const*& in, char const* end, std::uint8_t*& out, std::uint8_t const* out_end
+) noexcept -> bool
+{
+  // Reads 16 characters, writes 16 bytes (12 valid).
+  while (end - in >= 16 && out_end - out >= 16) {
+    auto decoded = __m128i();
+    if (!Base64Sse41::decode(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), decoded)) {
+      return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decoded);
+    in += 16;
+    out += 12;
+  }
+  return true;
+}
+
+UBYTES_TARGET_AVX2 inline auto base64_decode_avx2(
+  char const*& in, char const* end, std::uint8_t*& out, std::uint8_t const* out_end
+) noexcept -> bool
+{
+  // Reads 32 characters, writes 32 bytes (24 valid).
+  while (end - in >= 32 && out_end - out >= 32) {
+    auto decoded = __m256i();
+    if (!Base64Avx2::decode(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(in)), decoded)) {
+      return false;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), decoded);
+    in += 32;
+    out += 24;
+  }
+  return base64_decode_sse41(in, end, out, out_end);
+}
+
+#endif
+
+} // namespace details
+
+/// Encodes `in` as padded base64 into `out`, which must hold `base64_encoded_size(in.size())` characters.
+/// @return The number of characters written.
+inline auto base64_encode(std::span<std::byte const> in, std::span<char> out, SimdLevel level = simd_level()) noexcept
+  -> std::size_t
+{
+  auto const* src = reinterpret_cast<std::uint8_t const*>(in.data());
+  auto const* end = src + in.size();
+  char*       dst = out.data();
+
+#if UBYTES_APP_PLATFORM_X86
+  // The vectorized kernels only write whole, valid blocks of characters.
+  if (level == SimdLevel::AVX2) {
+    details::base64_encode_avx2(src, end, dst);
+  }
+  else if (level == SimdLevel::SSE41) {
+    details::base64_encode_sse41(src, end, dst);
+  }
+#else
+  (void)level;
+#endif
+
+  details::base64_encode_scalar(src, end, dst);
+  return static_cast<std::size_t>(dst - out.data());
+}
+
+/// Decodes base64 (padded or not) into `out`, which must hold `base64_decoded_capacity(in.size())` bytes.
+/// @note See `BASE64_DECODE_SLACK`.
+/// @return The number of bytes written or `std::nullopt` if the input is not valid base64.
+inline auto base64_decode(std::string_view in, std::span<std::byte> out, SimdLevel level = simd_level()) noexcept
+  -> std::optional<std::size_t>
+{
+  if (!in.empty() && in.size() % 4 == 0 && in.back() == '=') {
+    in.remove_suffix(in[in.size() - 2] == '=' ? 2 : 1);
+  }
+  if (in.size() % 4 == 1) {
+    return std::nullopt;
+  }
+
+  auto const*               src     = in.data();
+  auto const*               end     = src + in.size();
+  auto*                     dst     = reinterpret_cast<std::uint8_t*>(out.data());
+  std::uint8_t const* const out_end = dst + out.size();
+
+#if UBYTES_APP_PLATFORM_X86
+  auto const whole_end = src + in.size() / 4 * 4;
+  if (level == SimdLevel::AVX2) {
+    if (!details::base64_decode_avx2(src, whole_end, dst, out_end)) {
+      return std::nullopt;
+    }
+  }
+  else if (level == SimdLevel::SSE41) {
+    if (!details::base64_decode_sse41(src, whole_end, dst, out_end)) {
+      return std::nullopt;
+    }
+  }
+#else
+  (void)level;
+  (void)out_end;
+#endif
+
+  if (!details::base64_decode_scalar(src, src + (end - src) / 4 * 4, dst)) {
+    return std::nullopt;
+  }
+
+  // The last, unpadded group of 2 or 3 characters.
+  auto const rest = end - src;
+  if (rest >= 2) {
+    std::uint32_t v = 0;
+    for (std::ptrdiff_t i = 0; i < rest; ++i) {
+      auto const bits = details::BASE64_DECODE_TABLE[static_cast<std::uint8_t>(src[i])];
+      if (bits & 0x80) {
+        return std::nullopt;
+      }
+      v = (v << 6) | bits;
+    }
+
+    if (rest == 2) {
+      *dst++ = static_cast<std::uint8_t>(v >> 4);
+    }
+    else {
+      *dst++ = static_cast<std::uint8_t>(v >> 10);
+      *dst++ = static_cast<std::uint8_t>(v >> 2);
+    }
+  }
+
+  return static_cast<std::size_t>(dst - reinterpret_cast<std::uint8_t*>(out.data()));
+}
+
+} // namespace app_platform
+} // namespace ubytes
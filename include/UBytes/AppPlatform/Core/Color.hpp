@@ -2,6 +2,7 @@
 
 #include <UBytes/AppPlatform/Export.hpp>
 
+#include <bit>
 #include <cinttypes>
 
 namespace ubytes
@@ -22,14 +23,20 @@ struct ColorTypeProperties<float>
 {
   static auto constexpr FULL_INTENSITY = float(1.0f);
 
-  static auto from_byte(std::uint8_t byte) noexcept -> float
+  static auto constexpr from_byte(std::uint8_t byte) noexcept -> float
   {
     return float(byte) / 255.0f;
   }
 
-  static auto to_byte(float value) noexcept -> std::uint8_t
+  /// Rounds to the nearest byte (ties to even, like the SIMD conversions in `Core/Pixels.hpp`).
+  /// Values outside of the 0 - 1 range and NaN are clamped.
+  static auto constexpr to_byte(float value) noexcept -> std::uint8_t
   {
-    return std::uint8_t(value * 255.0f);
+    auto scaled = value * 255.0f;
+    scaled      = scaled > 0.0f ? scaled : 0.0f;
+    scaled      = scaled < 255.0f ? scaled : 255.0f;
+    // Adding 1.5 * 2^23 leaves the rounded integer in the low mantissa bits.
+    return std::uint8_t(std::bit_cast<std::uint32_t>(scaled + 12582912.0f) & 0xFF);
   }
 };
 
@@ -38,12 +45,12 @@ struct ColorTypeProperties<std::uint8_t>
 {
   static auto constexpr FULL_INTENSITY = std::uint8_t(255);
 
-  static auto from_byte(std::uint8_t byte) noexcept -> std::uint8_t
+  static auto constexpr from_byte(std::uint8_t byte) noexcept -> std::uint8_t
   {
     return byte;
   }
 
-  static auto to_byte(std::uint8_t value) noexcept -> std::uint8_t
+  static auto constexpr to_byte(std::uint8_t value) noexcept -> std::uint8_t
   {
     return value;
   }
@@ -82,7 +89,7 @@ struct ColorBaseRGB
 
   static auto constexpr from_rgb(std::uint8_t r, std::uint8_t g, std::uint8_t b) noexcept -> ColorBaseRGB
   {
-    auto color = ColorBaseRGBA();
+    auto color = ColorBaseRGB();
     color.set_rgb(r, g, b);
     return color;
   }
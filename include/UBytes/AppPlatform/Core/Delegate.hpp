@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// The inline storage of `Delegate` by default: a few pointers, enough for the usual
+/// `[this]`, `[&a, &b, &c]` or `[id, shared_ptr]` captures.
+inline constexpr std::size_t DELEGATE_CAPACITY = 4 * sizeof(void*);
+
+template <typename Signature, std::size_t Capacity = DELEGATE_CAPACITY>
+class Delegate;
+
+/// A move-only callable like `std::function`, that stores callables of up to `Capacity`
+/// bytes inline instead of on the heap.
+///
+/// Larger callables (or ones that may throw when moved) still go to the heap,
+/// `is_inline()` tells which.
+/// @note Unlike `std::function`, calling an empty delegate is undefined: check it first.
+template <typename R, typename... Args, std::size_t Capacity>
+class Delegate<R(Args...), Capacity>
+{
+public:
+  /// Returns true if callables of type `Fn` are stored without allocating.
+  template <typename Fn>
+  static constexpr bool fits_inline = sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t) &&
+                                      std::is_nothrow_move_constructible_v<Fn>;
+
+  Delegate() noexcept = default;
+
+  Delegate(std::nullptr_t) noexcept
+  {
+  }
+
+  template <typename Fn>
+    requires(!std::is_same_v<std::remove_cvref_t<Fn>, Delegate> && std::is_invocable_r_v<R, std::decay_t<Fn>&, Args...>)
+  Delegate(Fn&& fn)
+  {
+    using Callable = std::decay_t<Fn>;
+    if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable>) {
+      if (fn == nullptr) {
+        return;
+      }
+    }
+
+    if constexpr (fits_inline<Callable>) {
+      ::new (static_cast<void*>(_storage)) Callable(std::forward<Fn>(fn));
+      _ops = &INLINE_OPS<Callable>;
+    }
+    else {
+      ::new (static_cast<void*>(_storage)) Callable*(new Callable(std::forward<Fn>(fn)));
+      _ops = &HEAP_OPS<Callable>;
+    }
+  }
+
+  Delegate(Delegate&& other) noexcept
+  {
+    take(other);
+  }
+
+  auto operator=(Delegate&& other) noexcept -> Delegate&
+  {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  Delegate(Delegate const&)                    = delete;
+  auto operator=(Delegate const&) -> Delegate& = delete;
+
+  ~Delegate()
+  {
+    reset();
+  }
+
+  auto reset() noexcept -> void
+  {
+    if (_ops) {
+      _ops->destroy(_storage);
+      _ops = nullptr;
+    }
+  }
+
+  /// Returns false if the callable is on the heap.
+  auto is_inline() const noexcept -> bool
+  {
+    return _ops != nullptr && _ops->is_inline;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _ops != nullptr;
+  }
+
+  auto operator()(Args... args) const -> R
+  {
+    return _ops->invoke(const_cast<std::byte*>(_storage), std::forward<Args>(args)...);
+  }
+
+private:
+  struct Ops
+  {
+    R (*invoke)(void* storage, Args&&... args);
+    /// Move-constructs the callable into `to` and destroys the one in `from`.
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* storage) noexcept;
+    bool is_inline;
+  };
+
+  template <typename Callable>
+  static constexpr Ops INLINE_OPS = {
+    [](void* storage, Args&&... args) -> R
+    {
+      // A `void` delegate drops the result of the callable, like `std::function`.
+      if constexpr (std::is_void_v<R>) {
+        std::invoke(*static_cast<Callable*>(storage), std::forward<Args>(args)...);
+      }
+      else {
+        return std::invoke(*static_cast<Callable*>(storage), std::forward<Args>(args)...);
+      }
+    },
+    [](void* from, void* to) noexcept
+    {
+      ::new (to) Callable(std::move(*static_cast<Callable*>(from)));
+      static_cast<Callable*>(from)->~Callable();
+    },
+    [](void* storage) noexcept
+    {
+      static_cast<Callable*>(storage)->~Callable();
+    },
+    true,
+  };
+
+  template <typename Callable>
+  static constexpr Ops HEAP_OPS = {
+    [](void* storage, Args&&... args) -> R
+    {
+      // A `void` delegate drops the result of the callable, like `std::function`.
+      if constexpr (std::is_void_v<R>) {
+        std::invoke(**static_cast<Callable**>(storage), std::forward<Args>(args)...);
+      }
+      else {
+        return std::invoke(**static_cast<Callable**>(storage), std::forward<Args>(args)...);
+      }
+    },
+    [](void* from, void* to) noexcept
+    {
+      ::new (to) Callable*(*static_cast<Callable**>(from));
+    },
+    [](void* storage) noexcept
+    {
+      delete *static_cast<Callable**>(storage);
+    },
+    false,
+  };
+
+  auto take(Delegate& other) noexcept -> void
+  {
+    if (other._ops) {
+      other._ops->relocate(other._storage, _storage);
+      _ops       = other._ops;
+      other._ops = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) std::byte _storage[Capacity < sizeof(void*) ? sizeof(void*) : Capacity];
+  Ops const* _ops = nullptr;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Assets compiled into the binary by the `app_platform_embed_assets()` CMake function.
+///
+/// The data lives in the read-only section of the executable and the index is built
+/// at compile time (a perfect hash, or a sorted table for large UIs), so serving the UI
+/// needs no file I/O:
+///
+/// ```cpp
+/// // Generated by app_platform_embed_assets(MyAppUi DIST ${CMAKE_SOURCE_DIR}/ui/dist NAME ui_assets)
+/// #include <ui_assets.hpp>
+///
+/// server.add_assets(ui_assets());
+/// ```
+/// @note Every asset is stored once, in the smallest of the enabled encodings.
+class EmbeddedAssets
+{
+public:
+  /// Returns the index of the asset with the given (relative) path or `npos`.
+  using Lookup = auto (*)(std::string_view path) noexcept -> std::size_t;
+
+  static constexpr std::size_t npos = std::size_t(-1);
+
+  constexpr EmbeddedAssets(std::span<Asset const> assets, Lookup lookup) noexcept
+    : _assets(assets)
+    , _lookup(lookup)
+  {
+  }
+
+  /// Finds an asset by its path, leading slashes are ignored.
+  auto find(std::string_view path) const noexcept -> std::optional<Asset>
+  {
+    auto const index = _lookup(details::asset_relative_path(path));
+    if (index == npos) {
+      return std::nullopt;
+    }
+    return _assets[index];
+  }
+
+  auto assets() const noexcept -> std::span<Asset const>
+  {
+    return _assets;
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _assets.size();
+  }
+
+private:
+  std::span<Asset const> _assets;
+  Lookup                 _lookup;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Delegate.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// The part of an event a subscription needs, without the argument types.
+class EventSlots
+{
+public:
+  virtual ~EventSlots() = default;
+
+  virtual auto remove(std::uint32_t id) noexcept -> void = 0;
+};
+
+} // namespace details
+
+/// Keeps a handler subscribed to an `Event`, unsubscribes it when destroyed or reset.
+/// Outliving the event is fine.
+class [[nodiscard]] EventSubscription
+{
+public:
+  EventSubscription() noexcept = default;
+
+  EventSubscription(std::weak_ptr<details::EventSlots> slots, std::uint32_t id) noexcept
+    : _slots(std::move(slots))
+    , _id(id)
+  {
+  }
+
+  EventSubscription(EventSubscription&& other) noexcept
+    : _slots(std::move(other._slots))
+    , _id(std::exchange(other._id, 0))
+  {
+  }
+
+  auto operator=(EventSubscription&& other) noexcept -> EventSubscription&
+  {
+    if (this != &other) {
+      reset();
+      _slots = std::move(other._slots);
+      _id    = std::exchange(other._id, 0);
+    }
+    return *this;
+  }
+
+  EventSubscription(EventSubscription const&)                    = delete;
+  auto operator=(EventSubscription const&) -> EventSubscription& = delete;
+
+  ~EventSubscription()
+  {
+    reset();
+  }
+
+  /// Unsubscribes the handler. Safe to call from a handler of the event, even this one.
+  auto reset() noexcept -> void
+  {
+    if (_id != 0) {
+      if (auto slots = _slots.lock()) {
+        slots->remove(_id);
+      }
+      _slots.reset();
+      _id = 0;
+    }
+  }
+
+  /// Keeps the handler subscribed for the lifetime of the event.
+  auto release() noexcept -> void
+  {
+    _slots.reset();
+    _id = 0;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _id != 0;
+  }
+
+private:
+  std::weak_ptr<details::EventSlots> _slots;
+  std::uint32_t                      _id = 0;
+};
+
+/// An event with any number of subscribers, called in order of priority (higher first),
+/// then of subscription.
+///
+/// The handlers are `Delegate`s, so the usual captures don't allocate, and dispatching is
+/// a loop over a contiguous array. Handlers may subscribe and unsubscribe (themselves or
+/// others) while the event is dispatched: the new handlers are called from the next
+/// dispatch on, the removed ones are not called anymore.
+///
+/// ```cpp
+/// auto messages = Event<MessageBuffer>();
+/// auto receiver = MessageReceiver(messages.dispatcher());
+/// receiver.attach(webview);
+///
+/// auto subscription = messages.subscribe([this](MessageBuffer const& message) { ... });
+/// ```
+/// @note Not thread-safe, and must not be destroyed by one of its handlers.
+template <typename... Args>
+class Event
+{
+public:
+  using Handler = Delegate<void(Args const&...)>;
+
+  Event() = default;
+
+  // A copy would share the subscribers of the original.
+  Event(Event const&)                    = delete;
+  auto operator=(Event const&) -> Event& = delete;
+
+  Event(Event&&) noexcept                    = default;
+  auto operator=(Event&&) noexcept -> Event& = default;
+
+  /// Adds a handler.
+  /// @param priority - the handlers with a higher priority are called first.
+  template <typename Fn>
+  auto subscribe(Fn&& fn, int priority = 0) -> EventSubscription
+  {
+    auto& state = this->state();
+    auto  id    = state.next_id++;
+    state.insert(Subscriber{Handler(std::forward<Fn>(fn)), priority, id});
+    return EventSubscription(_state, id);
+  }
+
+  /// Calls the handlers.
+  auto operator()(Args const&... args) -> void
+  {
+    if (_state) {
+      _state->dispatch(args...);
+    }
+  }
+
+  /// Returns a callable that dispatches the event, e.g. for `WebView::on_message`.
+  /// It shares the subscribers: it keeps dispatching after the event is moved.
+  auto dispatcher() -> auto
+  {
+    state();
+    return [state = _state](Args const&... args)
+    {
+      state->dispatch(args...);
+    };
+  }
+
+  /// Returns the number of subscribed handlers.
+  auto size() const noexcept -> std::size_t
+  {
+    return _state ? _state->live : 0;
+  }
+
+  auto empty() const noexcept -> bool
+  {
+    return size() == 0;
+  }
+
+  /// Unsubscribes every handler.
+  auto clear() noexcept -> void
+  {
+    if (_state) {
+      _state->remove_all();
+    }
+  }
+
+private:
+  struct Subscriber
+  {
+    Handler       handler;
+    int           priority;
+    /// 0 once removed during a dispatch, the subscriber is erased after it.
+    std::uint32_t id;
+  };
+
+  class State final : public details::EventSlots
+  {
+  public:
+    auto insert(Subscriber subscriber) -> void
+    {
+      ++live;
+      if (depth > 0) {
+        added.push_back(std::move(subscriber));
+        return;
+      }
+      place(std::move(subscriber));
+    }
+
+    auto remove(std::uint32_t id) noexcept -> void override
+    {
+      for (auto* list : {&subscribers, &added}) {
+        auto it = std::find_if(
+          list->begin(),
+          list->end(),
+          [id](Subscriber const& subscriber)
+          {
+            return subscriber.id == id;
+          }
+        );
+        if (it == list->end()) {
+          continue;
+        }
+        --live;
+        if (depth > 0) {
+          // The handler may be running: destroy it after the dispatch.
+          it->id  = 0;
+          removed = true;
+        }
+        else {
+          list->erase(it);
+        }
+        return;
+      }
+    }
+
+    auto remove_all() noexcept -> void
+    {
+      if (depth > 0) {
+        for (auto& subscriber : subscribers) {
+          subscriber.id = 0;
+        }
+        added.clear();
+        removed = true;
+      }
+      else {
+        subscribers.clear();
+      }
+      live = 0;
+    }
+
+    auto dispatch(Args const&... args) -> void
+    {
+      // Indexed: the handlers added meanwhile go to `added`, so `subscribers` does not move.
+      auto const dispatching = Dispatching(*this);
+      auto const count       = subscribers.size();
+      for (std::size_t i = 0; i < count; ++i) {
+        if (subscribers[i].id != 0) {
+          subscribers[i].handler(args...);
+        }
+      }
+    }
+
+    std::vector<Subscriber> subscribers;
+    std::vector<Subscriber> added;
+    std::size_t             live    = 0;
+    std::uint32_t           next_id = 1;
+    int                     depth   = 0;
+    bool                    removed = false;
+
+  private:
+    /// Counts a dispatch in `depth`, and applies the changes made meanwhile once the last
+    /// one ends, even if a handler throws.
+    class Dispatching
+    {
+    public:
+      explicit Dispatching(State& state) noexcept
+        : _state(state)
+      {
+        ++_state.depth;
+      }
+
+      Dispatching(Dispatching const&)                    = delete;
+      auto operator=(Dispatching const&) -> Dispatching& = delete;
+
+      ~Dispatching()
+      {
+        if (--_state.depth == 0 && (_state.removed || !_state.added.empty())) {
+          try {
+            _state.commit();
+          }
+          catch (std::bad_alloc const&) {
+            // The subscribers not placed yet stay in `added`, for the end of the next dispatch.
+          }
+        }
+      }
+
+    private:
+      State& _state;
+    };
+
+    auto place(Subscriber subscriber) -> void
+    {
+      auto const it = std::upper_bound(
+        subscribers.begin(),
+        subscribers.end(),
+        subscriber.priority,
+        [](int priority, Subscriber const& other)
+        {
+          return priority > other.priority;
+        }
+      );
+      subscribers.insert(it, std::move(subscriber));
+    }
+
+    auto commit() -> void
+    {
+      if (removed) {
+        std::erase_if(
+          subscribers,
+          [](Subscriber const& subscriber)
+          {
+            return subscriber.id == 0;
+          }
+        );
+        removed = false;
+      }
+      for (auto& subscriber : added) {
+        if (subscriber.id != 0) {
+          place(std::move(subscriber));
+          // Placed: skipped if placing the next one throws and the commit is retried.
+          subscriber.id = 0;
+        }
+      }
+      added.clear();
+    }
+  };
+
+  auto state() -> State&
+  {
+    if (!_state) {
+      _state = std::make_shared<State>();
+    }
+    return *_state;
+  }
+
+  std::shared_ptr<State> _state;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Color.hpp>
+#include <UBytes/AppPlatform/Core/Rect.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// How the pixels of an image tile are stored.
+enum class ImageCodec : std::uint8_t
+{
+  /// RGBA bytes, row by row. Used when the other codecs don't make the tile smaller.
+  Raw = 0,
+  /// The "Quite OK Image" format (https://qoiformat.org) without its file header and end marker:
+  /// lossless, several times faster than PNG and usually within 10-30% of its size.
+  Qoi = 1,
+};
+
+enum ImageTileFlags : std::uint8_t
+{
+  /// The tile is the whole image downscaled by `scale`, sent before the full resolution tiles.
+  ImageTilePreview = 1 << 0,
+};
+
+/// Precedes the encoded pixels of every tile (little-endian, see `js/ImageTransfer.js`).
+struct ImageTileHeader
+{
+  static constexpr std::uint32_t MAGIC = 0x4D494255; // "UBIM"
+
+  std::uint32_t magic = MAGIC;
+  ImageCodec    codec = ImageCodec::Raw;
+  std::uint8_t  flags = 0;
+  /// The downscale factor of a preview, 1 for full resolution tiles.
+  std::uint16_t scale = 1;
+  /// Identifies the `send()` the tile belongs to: the page drops tiles of older frames.
+  std::uint32_t frame = 0;
+
+  std::uint32_t image_width  = 0;
+  std::uint32_t image_height = 0;
+
+  /// The tile rectangle, in the pixels of the (downscaled for previews) image.
+  std::uint32_t x      = 0;
+  std::uint32_t y      = 0;
+  std::uint32_t width  = 0;
+  std::uint32_t height = 0;
+
+  /// The number of full resolution tiles of the frame.
+  std::uint32_t tiles = 0;
+};
+static_assert(sizeof(ImageTileHeader) == 40, "ImageTileHeader must have no padding");
+static_assert(std::endian::native == std::endian::little, "ImageTileHeader is written as is");
+
+namespace details
+{
+
+inline constexpr std::uint8_t QOI_OP_INDEX = 0x00;
+inline constexpr std::uint8_t QOI_OP_DIFF  = 0x40;
+inline constexpr std::uint8_t QOI_OP_LUMA  = 0x80;
+inline constexpr std::uint8_t QOI_OP_RUN   = 0xC0;
+inline constexpr std::uint8_t QOI_OP_RGB   = 0xFE;
+inline constexpr std::uint8_t QOI_OP_RGBA  = 0xFF;
+inline constexpr std::uint8_t QOI_MASK     = 0xC0;
+
+inline auto qoi_hash(Color4u px) noexcept -> std::uint32_t
+{
+  return (px.r * 3u + px.g * 5u + px.b * 7u + px.a * 11u) % 64u;
+}
+
+inline auto qoi_same(Color4u a, Color4u b) noexcept -> bool
+{
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+} // namespace details
+
+/// Returns the largest possible QOI encoding of `pixels` pixels.
+constexpr auto qoi_max_size(std::size_t pixels) noexcept -> std::size_t
+{
+  return pixels * 5;
+}
+
+/// QOI-encodes a rectangle of an image into `out`, which must hold `qoi_max_size(rect.w * rect.h)` bytes.
+/// @param stride - the width of the image, in pixels.
+/// @return The number of bytes written.
+inline auto qoi_encode(std::span<Color4u const> image, std::uint32_t stride, Rect2u rect, std::byte* out) noexcept
+  -> std::size_t
+{
+  using namespace details;
+
+  auto* const begin = reinterpret_cast<std::uint8_t*>(out);
+  auto*       dst   = begin;
+
+  auto index = std::array<Color4u, 64>();
+  index.fill(Color4u(0, 0, 0, 0));
+  auto prev = Color4u(0, 0, 0, 255);
+  int  run  = 0;
+
+  for (std::uint32_t y = 0; y < rect.h; ++y) {
+    auto const* row = image.data() + std::size_t(rect.y + y) * stride + rect.x;
+    for (std::uint32_t x = 0; x < rect.w; ++x) {
+      auto const px = row[x];
+      if (qoi_same(px, prev)) {
+        if (++run == 62) {
+          *dst++ = std::uint8_t(QOI_OP_RUN | (run - 1));
+          run    = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        *dst++ = std::uint8_t(QOI_OP_RUN | (run - 1));
+        run    = 0;
+      }
+
+      auto const hash = qoi_hash(px);
+      if (qoi_same(index[hash], px)) {
+        *dst++ = std::uint8_t(QOI_OP_INDEX | hash);
+      }
+      else {
+        index[hash] = px;
+        if (px.a == prev.a) {
+          auto const dr   = std::int8_t(px.r - prev.r);
+          auto const dg   = std::int8_t(px.g - prev.g);
+          auto const db   = std::int8_t(px.b - prev.b);
+          auto const dr_g = dr - dg;
+          auto const db_g = db - dg;
+          if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+            *dst++ = std::uint8_t(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+          }
+          else if (dr_g > -9 && dr_g < 8 && dg > -33 && dg < 32 && db_g > -9 && db_g < 8) {
+            *dst++ = std::uint8_t(QOI_OP_LUMA | (dg + 32));
+            *dst++ = std::uint8_t((dr_g + 8) << 4 | (db_g + 8));
+          }
+          else {
+            dst[0] = QOI_OP_RGB;
+            dst[1] = px.r;
+            dst[2] = px.g;
+            dst[3] = px.b;
+            dst += 4;
+          }
+        }
+        else {
+          dst[0] = QOI_OP_RGBA;
+          dst[1] = px.r;
+          dst[2] = px.g;
+          dst[3] = px.b;
+          dst[4] = px.a;
+          dst += 5;
+        }
+      }
+      prev = px;
+    }
+  }
+  if (run > 0) {
+    *dst++ = std::uint8_t(QOI_OP_RUN | (run - 1));
+  }
+  return static_cast<std::size_t>(dst - begin);
+}
+
+/// Decodes QOI data into `out`, filling it completely.
+/// @return false if the data is truncated or describes more pixels than `out` holds.
+inline auto qoi_decode(std::span<std::byte const> data, std::span<Color4u> out) noexcept -> bool
+{
+  using namespace details;
+
+  auto const* src = reinterpret_cast<std::uint8_t const*>(data.data());
+  auto const* end = src + data.size();
+
+  auto index = std::array<Color4u, 64>();
+  index.fill(Color4u(0, 0, 0, 0));
+  auto px = Color4u(0, 0, 0, 255);
+
+  std::size_t i = 0;
+  while (i < out.size()) {
+    if (src == end) {
+      return false;
+    }
+    auto const op = *src++;
+    if (op == QOI_OP_RGB || op == QOI_OP_RGBA) {
+      auto const size = op == QOI_OP_RGB ? 3 : 4;
+      if (end - src < size) {
+        return false;
+      }
+      px.r = src[0];
+      px.g = src[1];
+      px.b = src[2];
+      if (op == QOI_OP_RGBA) {
+        px.a = src[3];
+      }
+      src += size;
+    }
+    else if ((op & QOI_MASK) == QOI_OP_INDEX) {
+      px = index[op];
+    }
+    else if ((op & QOI_MASK) == QOI_OP_DIFF) {
+      px.r = std::uint8_t(px.r + ((op >> 4) & 0x03) - 2);
+      px.g = std::uint8_t(px.g + ((op >> 2) & 0x03) - 2);
+      px.b = std::uint8_t(px.b + (op & 0x03) - 2);
+    }
+    else if ((op & QOI_MASK) == QOI_OP_LUMA) {
+      if (src == end) {
+        return false;
+      }
+      auto const second = *src++;
+      auto const dg     = (op & 0x3F) - 32;
+      px.r              = std::uint8_t(px.r + dg - 8 + ((second >> 4) & 0x0F));
+      px.g              = std::uint8_t(px.g + dg);
+      px.b              = std::uint8_t(px.b + dg - 8 + (second & 0x0F));
+    }
+    else {
+      // The run repeats the previous pixel, which is already in the index.
+      auto const run = std::size_t((op & 0x3F) + 1);
+      if (out.size() - i < run) {
+        return false;
+      }
+      std::fill_n(out.data() + i, run, px);
+      i += run;
+      continue;
+    }
+    index[qoi_hash(px)] = px;
+    out[i++]            = px;
+  }
+  return true;
+}
+
+/// Encodes a tile of an image: the header followed by the pixels of `header.x/y/width/height`,
+/// QOI-encoded or raw, whichever is smaller. Sets `header.codec`.
+/// @param stride - the width of `image`, in pixels.
+inline auto encode_image_tile(
+  std::span<Color4u const> image, std::uint32_t stride, ImageTileHeader header, std::vector<std::byte>& out
+) -> void
+{
+  auto const rect     = Rect2u{header.x, header.y, header.width, header.height};
+  auto const pixels   = std::size_t(rect.w) * rect.h;
+  auto const raw_size = pixels * sizeof(Color4u);
+
+  out.resize(sizeof(ImageTileHeader) + qoi_max_size(pixels));
+  auto* const data = out.data() + sizeof(ImageTileHeader);
+  auto        size = qoi_encode(image, stride, rect, data);
+  header.codec     = ImageCodec::Qoi;
+
+  if (size >= raw_size) {
+    for (std::uint32_t y = 0; y < rect.h; ++y) {
+      auto const* row = image.data() + std::size_t(rect.y + y) * stride + rect.x;
+      std::memcpy(data + std::size_t(y) * rect.w * sizeof(Color4u), row, rect.w * sizeof(Color4u));
+    }
+    size         = raw_size;
+    header.codec = ImageCodec::Raw;
+  }
+
+  std::memcpy(out.data(), &header, sizeof(header));
+  out.resize(sizeof(ImageTileHeader) + size);
+}
+
+/// Decodes a tile produced by `encode_image_tile()`.
+/// @param out - receives `header.width * header.height` pixels; resized as needed.
+/// @return false if the tile is malformed.
+inline auto decode_image_tile(std::span<std::byte const> tile, ImageTileHeader& header, std::vector<Color4u>& out)
+  -> bool
+{
+  if (tile.size() < sizeof(ImageTileHeader)) {
+    return false;
+  }
+  std::memcpy(&header, tile.data(), sizeof(header));
+  if (header.magic != ImageTileHeader::MAGIC) {
+    return false;
+  }
+
+  auto const data = tile.subspan(sizeof(ImageTileHeader));
+  out.resize(std::size_t(header.width) * header.height);
+  switch (header.codec) {
+  case ImageCodec::Raw:
+    if (data.size() != out.size() * sizeof(Color4u)) {
+      return false;
+    }
+    std::memcpy(out.data(), data.data(), data.size());
+    return true;
+  case ImageCodec::Qoi: return qoi_decode(data, out);
+  }
+  return false;
+}
+
+/// Downscales an image by an integer factor, averaging the `scale`x`scale` boxes (the ones on the
+/// right and bottom edges may be smaller). The result is `ceil(width / scale)` x `ceil(height / scale)`.
+inline auto downscale_image(
+  std::span<Color4u const> image, std::uint32_t width, std::uint32_t height, std::uint32_t scale,
+  std::vector<Color4u>& out
+) -> void
+{
+  auto const out_width  = (width + scale - 1) / scale;
+  auto const out_height = (height + scale - 1) / scale;
+  out.resize(std::size_t(out_width) * out_height);
+
+  auto sums = std::vector<std::array<std::uint32_t, 4>>(out_width);
+  for (std::uint32_t oy = 0; oy < out_height; ++oy) {
+    std::fill(sums.begin(), sums.end(), std::array<std::uint32_t, 4>());
+    auto const y_end = std::min(height, (oy + 1) * scale);
+    for (auto y = oy * scale; y < y_end; ++y) {
+      auto const* row = image.data() + std::size_t(y) * width;
+      for (std::uint32_t x = 0; x < width; ++x) {
+        auto& sum = sums[x / scale];
+        sum[0] += row[x].r;
+        sum[1] += row[x].g;
+        sum[2] += row[x].b;
+        sum[3] += row[x].a;
+      }
+    }
+
+    auto const rows = y_end - oy * scale;
+    for (std::uint32_t ox = 0; ox < out_width; ++ox) {
+      auto const count = (std::min(width, (ox + 1) * scale) - ox * scale) * rows;
+      auto const round = count / 2;
+      auto const& sum  = sums[ox];
+      out[std::size_t(oy) * out_width + ox] = Color4u(
+        std::uint8_t((sum[0] + round) / count),
+        std::uint8_t((sum[1] + round) / count),
+        std::uint8_t((sum[2] + round) / count),
+        std::uint8_t((sum[3] + round) / count)
+      );
+    }
+  }
+}
+
+} // namespace app_platform
+} // namespace ubytes
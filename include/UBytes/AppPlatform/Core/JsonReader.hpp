@@ -0,0 +1,734 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/Utf.hpp>
+
+#include <bit>
+#include <charconv>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+class JsonReader;
+
+namespace details
+{
+
+/// Character classes of a 64-byte block, one bit per byte.
+struct JsonBlockMasks
+{
+  std::uint64_t quote;
+  std::uint64_t backslash;
+  std::uint64_t op;
+  std::uint64_t whitespace;
+};
+
+inline auto json_classify_scalar(char const* block) noexcept -> JsonBlockMasks
+{
+  auto masks = JsonBlockMasks{};
+  for (std::size_t i = 0; i < 64; ++i) {
+    auto const bit = std::uint64_t(1) << i;
+    switch (block[i]) {
+    case '"': masks.quote |= bit; break;
+    case '\\': masks.backslash |= bit; break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',': masks.op |= bit; break;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r': masks.whitespace |= bit; break;
+    default: break;
+    }
+  }
+  return masks;
+}
+
+#if UBYTES_APP_PLATFORM_X86
+
+inline auto json_classify_sse2(char const* block) noexcept -> JsonBlockMasks
+{
+  auto masks = JsonBlockMasks{};
+  for (int part = 0; part < 4; ++part) {
+    auto const v     = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + part * 16));
+    auto const shift = part * 16;
+
+    auto const eq = [&](char c)
+    {
+      return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+    };
+    auto const mask = [&](__m128i m)
+    {
+      return std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(m))) << shift;
+    };
+
+    // `[` `]` `{` `}` differ only in bit 5 and bit 1, fold them with an OR.
+    auto const folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    auto const op     = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+      _mm_or_si128(eq(':'), eq(','))
+    );
+    auto const ws = _mm_or_si128(_mm_or_si128(eq(' '), eq('\t')), _mm_or_si128(eq('\n'), eq('\r')));
+
+    masks.quote |= mask(eq('"'));
+    masks.backslash |= mask(eq('\\'));
+    masks.op |= mask(op);
+    masks.whitespace |= mask(ws);
+  }
+  return masks;
+}
+
+UBYTES_TARGET_AVX2 inline auto json_classify_avx2(char const* block) noexcept -> JsonBlockMasks
+{
+  auto masks = JsonBlockMasks{};
+  for (int part = 0; part < 2; ++part) {
+    auto const v     = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + part * 32));
+    auto const shift = part * 32;
+
+    auto const eq = [&](char c) UBYTES_TARGET_AVX2
+    {
+      return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+    };
+    auto const mask = [&](__m256i m) UBYTES_TARGET_AVX2
+    {
+      return std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(m))) << shift;
+    };
+
+    auto const folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    auto const op     = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))
+      ),
+      _mm256_or_si256(eq(':'), eq(','))
+    );
+    auto const ws = _mm256_or_si256(_mm256_or_si256(eq(' '), eq('\t')), _mm256_or_si256(eq('\n'), eq('\r')));
+
+    masks.quote |= mask(eq('"'));
+    masks.backslash |= mask(eq('\\'));
+    masks.op |= mask(op);
+    masks.whitespace |= mask(ws);
+  }
+  return masks;
+}
+
+#endif
+
+/// Returns the characters escaped by an odd-length backslash sequence.
+/// (The classic simdjson stage 1 algorithm.)
+inline auto json_find_escaped(std::uint64_t backslash, std::uint64_t& prev_ends_odd_backslash) noexcept -> std::uint64_t
+{
+  constexpr auto even_bits = std::uint64_t(0x5555555555555555ull);
+  constexpr auto odd_bits  = ~even_bits;
+
+  auto const start_edges     = backslash & ~(backslash << 1);
+  auto const even_start_mask = even_bits ^ prev_ends_odd_backslash;
+  auto const even_starts     = start_edges & even_start_mask;
+  auto const odd_starts      = start_edges & ~even_start_mask;
+  auto const even_carries    = backslash + even_starts;
+
+  auto       odd_carries = backslash + odd_starts;
+  bool const overflow    = odd_carries < backslash;
+  odd_carries |= prev_ends_odd_backslash;
+  prev_ends_odd_backslash = overflow ? 1 : 0;
+
+  auto const even_carry_ends = even_carries & ~backslash;
+  auto const odd_carry_ends  = odd_carries & ~backslash;
+  return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+/// Inclusive prefix XOR: bit i is the parity of the bits 0..i.
+constexpr auto prefix_xor(std::uint64_t bits) noexcept -> std::uint64_t
+{
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+} // namespace details
+
+/// A lazily parsed JSON value: a position in the structural index of a `JsonReader`.
+///
+/// Nothing is materialized, accessing a field scans the structural index and skips
+/// over the values in between. The value is valid as long as the reader and the
+/// parsed text are alive and the reader is not reused.
+class JsonValue
+{
+public:
+  enum class Type
+  {
+    Invalid,
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+  };
+
+  JsonValue() noexcept = default;
+
+  auto type() const noexcept -> Type;
+
+  auto valid() const noexcept -> bool
+  {
+    return type() != Type::Invalid;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return valid();
+  }
+
+  /// Returns the value of an object field, or an invalid value.
+  /// @note Keys with escape sequences are unescaped into the reader's buffer, which may allocate.
+  auto operator[](std::string_view key) const -> JsonValue;
+
+  /// Returns the array element at `index`, or an invalid value.
+  auto at(std::size_t index) const noexcept -> JsonValue;
+
+  /// Returns the string contents. Strings without escape sequences are returned
+  /// as views into the parsed text, the rest is unescaped into a reader-owned buffer
+  /// valid until the next unescaping.
+  auto get_string() const -> std::optional<std::string_view>;
+
+  /// Returns the string contents exactly as written (with escape sequences).
+  auto get_raw_string() const noexcept -> std::optional<std::string_view>;
+
+  auto get_bool() const noexcept -> std::optional<bool>;
+  auto get_int64() const noexcept -> std::optional<std::int64_t>;
+  auto get_uint64() const noexcept -> std::optional<std::uint64_t>;
+  auto get_double() const noexcept -> std::optional<double>;
+
+  auto is_null() const noexcept -> bool
+  {
+    return type() == Type::Null;
+  }
+
+  /// Returns the JSON text of the value, e.g. to forward it.
+  auto raw_json() const noexcept -> std::string_view;
+
+  /// Calls `fn(std::string_view raw_key, JsonValue value)` for every object field.
+  /// Return `false` from `fn` to stop.
+  /// @return false if the object is malformed.
+  template <typename Fn>
+  auto for_each_field(Fn&& fn) const -> bool;
+
+  /// Calls `fn(JsonValue element)` for every array element. Return `false` from `fn` to stop.
+  /// @return false if the array is malformed.
+  template <typename Fn>
+  auto for_each_element(Fn&& fn) const -> bool;
+
+private:
+  friend class JsonReader;
+
+  JsonValue(JsonReader const* reader, std::uint32_t index) noexcept
+    : _reader(reader)
+    , _index(index)
+  {
+  }
+
+  auto character() const noexcept -> char;
+  auto scalar_text() const noexcept -> std::string_view;
+
+  JsonReader const* _reader = nullptr;
+  std::uint32_t     _index  = 0;
+};
+
+/// An on-demand JSON parser.
+///
+/// `parse()` only runs the vectorized structural indexing (the positions of
+/// `{}[]:,`, string starts and scalar starts, with escapes and string contents
+/// resolved 64 bytes at a time). Values are decoded on access, so dispatching
+/// on a `type` field costs a scan of the index instead of a full parse:
+///
+/// ```cpp
+/// auto root = reader.parse(message.view());
+/// if (root["type"].get_string() == "scroll") {
+///   auto y = root["y"].get_double();
+/// }
+/// ```
+/// @note Reuse the reader, its buffers keep their storage between messages.
+/// Only the structure is validated up front; scalars are validated when accessed.
+class JsonReader
+{
+public:
+  /// Indexes `json` and returns the root value, or an invalid value if the
+  /// text is not structurally valid (e.g. an unterminated string).
+  /// @note `json` must outlive the returned values.
+  auto parse(std::string_view json, SimdLevel level = simd_level()) -> JsonValue
+  {
+    _json        = json;
+    _structurals = {};
+    if (json.size() >= std::numeric_limits<std::uint32_t>::max()) {
+      return JsonValue();
+    }
+
+    // Every byte may be structural, plus a sentinel. The storage only grows and is
+    // written without being cleared first.
+    if (_capacity < json.size() + 1) {
+      _storage  = std::make_unique_for_overwrite<std::uint32_t[]>(json.size() + 1);
+      _capacity = json.size() + 1;
+    }
+    auto* out = _storage.get();
+
+    std::uint64_t prev_ends_odd_backslash = 0;
+    std::uint64_t prev_in_string          = 0;
+    std::uint64_t prev_scalar             = 0;
+
+    auto const index_block = [&](char const* block, std::uint32_t base)
+    {
+      auto masks = details::JsonBlockMasks();
+#if UBYTES_APP_PLATFORM_X86
+      if (level == SimdLevel::AVX2) {
+        masks = details::json_classify_avx2(block);
+      }
+      else {
+        masks = details::json_classify_sse2(block);
+      }
+#else
+      (void)level;
+      masks = details::json_classify_scalar(block);
+#endif
+
+      auto const escaped     = details::json_find_escaped(masks.backslash, prev_ends_odd_backslash);
+      auto const quotes      = masks.quote & ~escaped;
+      auto const in_string   = details::prefix_xor(quotes) ^ prev_in_string;
+      prev_in_string         = std::uint64_t(0) - (in_string >> 63);
+
+      // `in_string` covers the opening quote and the contents, not the closing quote.
+      auto const outside = ~in_string & ~quotes;
+      auto const op      = masks.op & outside;
+      auto const scalar  = outside & ~masks.op & ~masks.whitespace;
+      auto const starts  = scalar & ~((scalar << 1) | prev_scalar);
+      prev_scalar        = scalar >> 63;
+
+      auto bits = op | (quotes & in_string) | starts;
+      while (bits) {
+        *out++ = base + static_cast<std::uint32_t>(std::countr_zero(bits));
+        bits &= bits - 1;
+      }
+    };
+
+    auto const full = json.size() / 64 * 64;
+    for (std::size_t offset = 0; offset < full; offset += 64) {
+      index_block(json.data() + offset, static_cast<std::uint32_t>(offset));
+    }
+    if (full < json.size()) {
+      char tail[64];
+      std::memset(tail, ' ', sizeof(tail));
+      std::memcpy(tail, json.data() + full, json.size() - full);
+      index_block(tail, static_cast<std::uint32_t>(full));
+    }
+
+    _structurals = std::span(_storage.get(), out);
+    if (prev_in_string != 0 || _structurals.empty()) {
+      _structurals = {};
+      return JsonValue();
+    }
+
+    // The root must span the whole document.
+    auto const root = JsonValue(this, 0);
+    if (skip(0) != _structurals.size()) {
+      _structurals = {};
+      return JsonValue();
+    }
+    *out         = static_cast<std::uint32_t>(json.size());
+    _structurals = std::span(_storage.get(), out + 1);
+    return root;
+  }
+
+  /// Returns the number of structural positions found by the last `parse()`.
+  auto structural_count() const noexcept -> std::size_t
+  {
+    return _structurals.empty() ? 0 : _structurals.size() - 1;
+  }
+
+private:
+  friend class JsonValue;
+
+  static constexpr auto npos = std::uint32_t(-1);
+
+  auto character(std::uint32_t index) const noexcept -> char
+  {
+    if (index >= _structurals.size() || _structurals[index] >= _json.size()) {
+      return '\0';
+    }
+    return _json[_structurals[index]];
+  }
+
+  /// Returns the index right after the value starting at `index`, or `npos`.
+  auto skip(std::uint32_t index) const noexcept -> std::uint32_t
+  {
+    auto const count = static_cast<std::uint32_t>(_structurals.size());
+    if (index >= count) {
+      return npos;
+    }
+
+    auto const c = character(index);
+    if (c != '{' && c != '[') {
+      return (c == '}' || c == ']' || c == ',' || c == ':') ? npos : index + 1;
+    }
+
+    // Bracket types are checked when the containers are walked.
+    std::uint32_t depth = 0;
+    for (auto i = index; i < count; ++i) {
+      auto const d = _json[_structurals[i]];
+      if (d == '{' || d == '[') {
+        ++depth;
+      }
+      else if ((d == '}' || d == ']') && --depth == 0) {
+        return i + 1;
+      }
+    }
+    return npos;
+  }
+
+  /// Returns the text between a structural position and the next one, without trailing whitespace.
+  auto text_until_next(std::uint32_t index) const noexcept -> std::string_view
+  {
+    auto const begin = _structurals[index];
+    auto       end   = _structurals[index + 1];
+    while (end > begin) {
+      auto const c = _json[end - 1];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+        break;
+      }
+      --end;
+    }
+    return _json.substr(begin, end - begin);
+  }
+
+  /// Returns the raw contents of the string starting at `index`.
+  auto raw_string(std::uint32_t index) const noexcept -> std::string_view
+  {
+    auto const text = text_until_next(index);
+    if (text.size() < 2 || text.back() != '"') {
+      return std::string_view();
+    }
+    return text.substr(1, text.size() - 2);
+  }
+
+  auto unescape(std::string_view raw) const -> std::optional<std::string_view>
+  {
+    auto& out = _scratch;
+    out.clear();
+    auto* dst = out.prepare(raw.size());
+    auto* begin = dst;
+
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+      if (raw[i] != '\\') {
+        *dst++ = raw[i];
+        continue;
+      }
+      if (++i == raw.size()) {
+        return std::nullopt;
+      }
+      switch (raw[i]) {
+      case '"': *dst++ = '"'; break;
+      case '\\': *dst++ = '\\'; break;
+      case '/': *dst++ = '/'; break;
+      case 'b': *dst++ = '\b'; break;
+      case 'f': *dst++ = '\f'; break;
+      case 'n': *dst++ = '\n'; break;
+      case 'r': *dst++ = '\r'; break;
+      case 't': *dst++ = '\t'; break;
+      case 'u': {
+        auto const hex = [&](std::size_t at, std::uint32_t& unit)
+        {
+          if (at + 4 > raw.size()) {
+            return false;
+          }
+          auto const [end, error] = std::from_chars(raw.data() + at, raw.data() + at + 4, unit, 16);
+          return error == std::errc() && end == raw.data() + at + 4;
+        };
+
+        std::uint32_t unit = 0;
+        if (!hex(i + 1, unit)) {
+          return std::nullopt;
+        }
+        i += 4;
+
+        char16_t units[2] = {static_cast<char16_t>(unit), 0};
+        auto     count    = std::size_t(1);
+        std::uint32_t low = 0;
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u' &&
+            hex(i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+          units[1] = static_cast<char16_t>(low);
+          count    = 2;
+          i += 6;
+        }
+
+        // At most 6 escaped characters become at most 4 bytes, the output never outgrows the input.
+        auto const converted = convert_wide_to_utf8(std::u16string_view(units, count), std::span<char>(dst, 4));
+        dst += converted.written;
+        break;
+      }
+      default: return std::nullopt;
+      }
+    }
+
+    out.commit(static_cast<std::size_t>(dst - begin));
+    return out.view();
+  }
+
+  std::string_view                 _json;
+  /// The positions found by the last `parse()`, in `_storage`.
+  std::span<std::uint32_t>         _structurals;
+  std::unique_ptr<std::uint32_t[]> _storage;
+  std::size_t                      _capacity = 0;
+  mutable JsonBuffer               _scratch;
+};
+
+inline auto JsonValue::character() const noexcept -> char
+{
+  return _reader->character(_index);
+}
+
+inline auto JsonValue::scalar_text() const noexcept -> std::string_view
+{
+  return _reader->text_until_next(_index);
+}
+
+inline auto JsonValue::type() const noexcept -> Type
+{
+  if (!_reader) {
+    return Type::Invalid;
+  }
+
+  switch (character()) {
+  case '{': return Type::Object;
+  case '[': return Type::Array;
+  case '"': return Type::String;
+  case 't':
+  case 'f': return Type::Bool;
+  case 'n': return Type::Null;
+  case '-':
+  case '0':
+  case '1':
+  case '2':
+  case '3':
+  case '4':
+  case '5':
+  case '6':
+  case '7':
+  case '8':
+  case '9': return Type::Number;
+  default: return Type::Invalid;
+  }
+}
+
+template <typename Fn>
+auto JsonValue::for_each_field(Fn&& fn) const -> bool
+{
+  if (type() != Type::Object) {
+    return false;
+  }
+
+  auto index = _index + 1;
+  if (_reader->character(index) == '}') {
+    return true;
+  }
+
+  while (true) {
+    if (_reader->character(index) != '"' || _reader->character(index + 1) != ':') {
+      return false;
+    }
+
+    auto const key   = _reader->raw_string(index);
+    auto const value = JsonValue(_reader, index + 2);
+    auto const next  = _reader->skip(index + 2);
+    if (next == JsonReader::npos) {
+      return false;
+    }
+    if (!fn(key, value)) {
+      return true;
+    }
+
+    auto const separator = _reader->character(next);
+    if (separator == '}') {
+      return true;
+    }
+    if (separator != ',') {
+      return false;
+    }
+    index = next + 1;
+  }
+}
+
+template <typename Fn>
+auto JsonValue::for_each_element(Fn&& fn) const -> bool
+{
+  if (type() != Type::Array) {
+    return false;
+  }
+
+  auto index = _index + 1;
+  if (_reader->character(index) == ']') {
+    return true;
+  }
+
+  while (true) {
+    auto const next = _reader->skip(index);
+    if (next == JsonReader::npos) {
+      return false;
+    }
+    if (!fn(JsonValue(_reader, index))) {
+      return true;
+    }
+
+    auto const separator = _reader->character(next);
+    if (separator == ']') {
+      return true;
+    }
+    if (separator != ',') {
+      return false;
+    }
+    index = next + 1;
+  }
+}
+
+inline auto JsonValue::operator[](std::string_view key) const -> JsonValue
+{
+  auto found = JsonValue();
+  for_each_field(
+    [&](std::string_view raw_key, JsonValue value)
+    {
+      // Keys with escape sequences are compared after unescaping.
+      if (raw_key == key || (raw_key.find('\\') != std::string_view::npos && _reader->unescape(raw_key) == key)) {
+        found = value;
+        return false;
+      }
+      return true;
+    }
+  );
+  return found;
+}
+
+inline auto JsonValue::at(std::size_t index) const noexcept -> JsonValue
+{
+  auto found = JsonValue();
+  for_each_element(
+    [&](JsonValue element)
+    {
+      if (index-- == 0) {
+        found = element;
+        return false;
+      }
+      return true;
+    }
+  );
+  return found;
+}
+
+inline auto JsonValue::get_raw_string() const noexcept -> std::optional<std::string_view>
+{
+  if (type() != Type::String) {
+    return std::nullopt;
+  }
+  return _reader->raw_string(_index);
+}
+
+inline auto JsonValue::get_string() const -> std::optional<std::string_view>
+{
+  auto const raw = get_raw_string();
+  if (!raw || raw->find('\\') == std::string_view::npos) {
+    return raw;
+  }
+  return _reader->unescape(*raw);
+}
+
+inline auto JsonValue::get_bool() const noexcept -> std::optional<bool>
+{
+  auto const text = type() == Type::Bool ? scalar_text() : std::string_view();
+  if (text == "true") {
+    return true;
+  }
+  if (text == "false") {
+    return false;
+  }
+  return std::nullopt;
+}
+
+inline auto JsonValue::get_int64() const noexcept -> std::optional<std::int64_t>
+{
+  if (type() != Type::Number) {
+    return std::nullopt;
+  }
+  auto const text  = scalar_text();
+  auto       value = std::int64_t();
+  auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+inline auto JsonValue::get_uint64() const noexcept -> std::optional<std::uint64_t>
+{
+  if (type() != Type::Number) {
+    return std::nullopt;
+  }
+  auto const text  = scalar_text();
+  auto       value = std::uint64_t();
+  auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+inline auto JsonValue::get_double() const noexcept -> std::optional<double>
+{
+  if (type() != Type::Number) {
+    return std::nullopt;
+  }
+  auto const text  = scalar_text();
+  auto       value = double();
+  auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+inline auto JsonValue::raw_json() const noexcept -> std::string_view
+{
+  if (!_reader) {
+    return std::string_view();
+  }
+
+  auto const next = _reader->skip(_index);
+  if (next == JsonReader::npos) {
+    return std::string_view();
+  }
+
+  // The value ends before the next structural (or at the end of the text).
+  auto const begin = _reader->_structurals[_index];
+  auto       end   = _reader->_structurals[next - 1];
+  auto const last  = _reader->_json[end];
+  if (last == '}' || last == ']') {
+    return _reader->_json.substr(begin, end + 1 - begin);
+  }
+  return _reader->text_until_next(_index);
+}
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,457 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A growable, reusable character buffer that keeps its storage between uses.
+/// The contents are always followed by a null terminator, so `view()` can be
+/// passed directly to `WebView::send_message`.
+class JsonBuffer
+{
+public:
+  JsonBuffer() = default;
+
+  /// Constructs a buffer with the given initial capacity (excluding the null terminator).
+  explicit JsonBuffer(std::size_t capacity)
+  {
+    reserve(capacity);
+  }
+
+  JsonBuffer(JsonBuffer&&) noexcept                    = default;
+  auto operator=(JsonBuffer&&) noexcept -> JsonBuffer& = default;
+
+  /// Returns the contents; `view().data()[view().size()]` is always `'\0'`.
+  auto view() const noexcept -> std::string_view
+  {
+    return _data ? std::string_view(_data.get(), _size) : std::string_view("", 0);
+  }
+
+  auto data() const noexcept -> char const*
+  {
+    return _data ? _data.get() : "";
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _size;
+  }
+
+  auto capacity() const noexcept -> std::size_t
+  {
+    return _capacity;
+  }
+
+  /// Empties the buffer, keeping the allocated storage.
+  auto clear() noexcept -> void
+  {
+    _size = 0;
+    if (_data) {
+      _data[0] = '\0';
+    }
+  }
+
+  /// Makes sure that at least `capacity` characters fit without reallocating.
+  /// The first call allocates even for 0, the null terminator needs storage too.
+  auto reserve(std::size_t capacity) -> void
+  {
+    if (_data && capacity <= _capacity) {
+      return;
+    }
+
+    auto data = std::make_unique_for_overwrite<char[]>(capacity + 1);
+    if (_data) {
+      std::memcpy(data.get(), _data.get(), _size);
+    }
+    data[_size] = '\0';
+    _data       = std::move(data);
+    _capacity   = capacity;
+  }
+
+  /// Returns a pointer to at least `count` writable characters at the end of the buffer.
+  /// Call `commit()` afterwards with the number of characters actually written.
+  auto prepare(std::size_t count) -> char*
+  {
+    if (!_data || _size + count > _capacity) {
+      reserve(std::max(_size + count, _capacity * 2));
+    }
+    return _data.get() + _size;
+  }
+
+  /// Appends `count` characters previously written through `prepare()`.
+  /// @note `prepare()` must have been called before, even for 0 characters: a buffer that
+  /// never allocated has no storage for the null terminator.
+  auto commit(std::size_t count) noexcept -> void
+  {
+    _size += count;
+    _data[_size] = '\0';
+  }
+
+  auto append(std::string_view str) -> void
+  {
+    if (str.empty()) {
+      return;
+    }
+    std::memcpy(prepare(str.size()), str.data(), str.size());
+    commit(str.size());
+  }
+
+  auto append(char c) -> void
+  {
+    *prepare(1) = c;
+    commit(1);
+  }
+
+private:
+  std::unique_ptr<char[]> _data;
+  std::size_t             _size     = 0;
+  std::size_t             _capacity = 0;
+};
+
+namespace details
+{
+
+/// Returns the escape sequence length for a byte that needs escaping in a JSON string.
+inline auto json_escape(char c, char* out) noexcept -> std::size_t
+{
+  static constexpr char hex[] = "0123456789abcdef";
+
+  out[0] = '\\';
+  switch (c) {
+  case '"': out[1] = '"'; return 2;
+  case '\\': out[1] = '\\'; return 2;
+  case '\b': out[1] = 'b'; return 2;
+  case '\f': out[1] = 'f'; return 2;
+  case '\n': out[1] = 'n'; return 2;
+  case '\r': out[1] = 'r'; return 2;
+  case '\t': out[1] = 't'; return 2;
+  default: break;
+  }
+
+  auto const byte = static_cast<std::uint8_t>(c);
+  out[1]          = 'u';
+  out[2]          = '0';
+  out[3]          = '0';
+  out[4]          = hex[byte >> 4];
+  out[5]          = hex[byte & 0xF];
+  return 6;
+}
+
+inline auto json_needs_escape(char c) noexcept -> bool
+{
+  return c == '"' || c == '\\' || static_cast<std::uint8_t>(c) < 0x20;
+}
+
+/// Writes the escaped contents of a JSON string (without the quotes).
+/// `out` must have room for `6 * str.size()` characters.
+/// @return The number of characters written.
+inline auto json_escape_string(std::string_view str, char* out) noexcept -> std::size_t
+{
+  auto const* in    = str.data();
+  auto const* end   = in + str.size();
+  char* const begin = out;
+
+#if UBYTES_APP_PLATFORM_X86
+  // Scan 16 bytes at a time for quotes, backslashes and control characters
+  // and copy the clean runs in bulk. SSE2 is always available on x86-64.
+  auto const quote     = _mm_set1_epi8('"');
+  auto const backslash = _mm_set1_epi8('\\');
+  auto const control   = _mm_set1_epi8(0x1F);
+
+  while (end - in >= 16) {
+    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    auto const special = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+      _mm_cmpeq_epi8(_mm_min_epu8(block, control), block)
+    );
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+
+    auto const mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask == 0) {
+      in += 16;
+      out += 16;
+      continue;
+    }
+
+    auto const clean = static_cast<std::size_t>(std::countr_zero(mask));
+    in += clean;
+    out += clean;
+    out += json_escape(*in++, out);
+  }
+#endif
+
+  for (; in < end; ++in) {
+    if (json_needs_escape(*in)) {
+      out += json_escape(*in, out);
+    }
+    else {
+      *out++ = *in;
+    }
+  }
+
+  return static_cast<std::size_t>(out - begin);
+}
+
+} // namespace details
+
+/// A streaming JSON writer.
+///
+/// Writes directly into a `JsonBuffer`, inserting commas and colons as needed.
+/// Reuse the same buffer (or the same writer after `reset()`) for every message
+/// and steady-state messages do no heap allocations at all:
+///
+/// ```cpp
+/// writer.reset();
+/// writer.begin_object();
+/// writer.field("type", "progress");
+/// writer.field("value", 0.75);
+/// writer.end_object();
+/// webview.send_message(writer.view());
+/// ```
+/// @note The writer does not validate the structure (e.g. a key outside of an object), except
+/// for the nesting depth, see `failed()`.
+class JsonWriter
+{
+public:
+  /// The maximum nesting depth of objects and arrays.
+  static constexpr std::size_t MAX_DEPTH = 64;
+
+  /// Strings are escaped this many bytes at a time, so that a long string does not reserve
+  /// room for its worst case (6 times its size) all at once.
+  static constexpr std::size_t ESCAPE_CHUNK = 4096;
+
+  /// Constructs a writer with its own buffer.
+  JsonWriter()
+    : _buffer(&_own_buffer)
+  {
+  }
+
+  /// Constructs a writer that appends to an external buffer.
+  explicit JsonWriter(JsonBuffer& buffer)
+    : _buffer(&buffer)
+  {
+  }
+
+  JsonWriter(JsonWriter const&)                    = delete;
+  auto operator=(JsonWriter const&) -> JsonWriter& = delete;
+
+  /// Clears the buffer (keeping its storage) and the nesting state.
+  auto reset() noexcept -> void
+  {
+    _buffer->clear();
+    _depth       = 0;
+    _needs_comma = {};
+    _after_key   = false;
+    _failed      = false;
+  }
+
+  /// Returns true if an object or array was opened beyond `MAX_DEPTH`, or closed without
+  /// being opened. The output is not valid JSON then, until `reset()`.
+  auto failed() const noexcept -> bool
+  {
+    return _failed;
+  }
+
+  /// Returns the written JSON. The view is null-terminated.
+  auto view() const noexcept -> std::string_view
+  {
+    return _buffer->view();
+  }
+
+  auto buffer() noexcept -> JsonBuffer&
+  {
+    return *_buffer;
+  }
+
+  // Structure
+
+  auto begin_object() -> JsonWriter&
+  {
+    return open('{');
+  }
+
+  auto end_object() -> JsonWriter&
+  {
+    return close('}');
+  }
+
+  auto begin_array() -> JsonWriter&
+  {
+    return open('[');
+  }
+
+  auto end_array() -> JsonWriter&
+  {
+    return close(']');
+  }
+
+  /// Writes an object key. The key is escaped.
+  auto key(std::string_view name) -> JsonWriter&
+  {
+    separate();
+    write_quoted(name);
+    _buffer->append(':');
+    _after_key = true;
+    return *this;
+  }
+
+  // Values
+
+  auto null() -> JsonWriter&
+  {
+    separate();
+    _buffer->append(std::string_view("null"));
+    return *this;
+  }
+
+  auto value(bool v) -> JsonWriter&
+  {
+    separate();
+    _buffer->append(v ? std::string_view("true") : std::string_view("false"));
+    return *this;
+  }
+
+  /// A `char` would be written as a boolean. Write a string, or cast it to an integer.
+  auto value(char v) -> JsonWriter& = delete;
+
+  /// Writes an integer using `std::to_chars`.
+  template <typename T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+  auto value(T v) -> JsonWriter&
+  {
+    separate();
+    auto* out         = _buffer->prepare(24);
+    auto [end, error] = std::to_chars(out, out + 24, v);
+    _buffer->commit(static_cast<std::size_t>(end - out));
+    return *this;
+  }
+
+  /// Writes a floating point number in the shortest round-trip form.
+  /// @note JSON has no representation for NaN and infinity, these are written as `null`.
+  template <typename T>
+    requires std::is_floating_point_v<T>
+  auto value(T v) -> JsonWriter&
+  {
+    if (!std::isfinite(v)) {
+      return null();
+    }
+
+    separate();
+    auto* out         = _buffer->prepare(32);
+    auto [end, error] = std::to_chars(out, out + 32, v);
+    _buffer->commit(static_cast<std::size_t>(end - out));
+    return *this;
+  }
+
+  /// Writes a string value. The string must be UTF-8 and is escaped.
+  auto value(std::string_view v) -> JsonWriter&
+  {
+    separate();
+    write_quoted(v);
+    return *this;
+  }
+
+  auto value(char const* v) -> JsonWriter&
+  {
+    return value(std::string_view(v));
+  }
+
+  /// Writes an already serialized JSON fragment as a value.
+  auto raw(std::string_view json) -> JsonWriter&
+  {
+    separate();
+    _buffer->append(json);
+    return *this;
+  }
+
+  /// Writes a key and a value.
+  template <typename T>
+  auto field(std::string_view name, T&& v) -> JsonWriter&
+  {
+    key(name);
+    return value(std::forward<T>(v));
+  }
+
+private:
+  auto separate() -> void
+  {
+    if (_after_key) {
+      _after_key = false;
+      return;
+    }
+    // Beyond `MAX_DEPTH` the commas are not tracked, the output is invalid anyway.
+    if (_depth == 0 || _depth > MAX_DEPTH) {
+      return;
+    }
+    if (_needs_comma[_depth - 1]) {
+      _buffer->append(',');
+    }
+    _needs_comma[_depth - 1] = true;
+  }
+
+  auto open(char bracket) -> JsonWriter&
+  {
+    separate();
+    _buffer->append(bracket);
+    if (_depth < MAX_DEPTH) {
+      _needs_comma[_depth] = false;
+    }
+    else {
+      _failed = true;
+    }
+    ++_depth;
+    return *this;
+  }
+
+  auto close(char bracket) -> JsonWriter&
+  {
+    if (_depth == 0) {
+      _failed = true;
+      return *this;
+    }
+    --_depth;
+    _buffer->append(bracket);
+    return *this;
+  }
+
+  auto write_quoted(std::string_view str) -> void
+  {
+    _buffer->append('"');
+    // Worst case every byte becomes a `\u00XX` escape, which is reserved for a chunk at a time
+    // rather than for the whole string. 16 more bytes let the vectorized escaping store whole blocks.
+    while (!str.empty()) {
+      auto const chunk = str.substr(0, ESCAPE_CHUNK);
+      auto* const out  = _buffer->prepare(chunk.size() * 6 + 16);
+      _buffer->commit(details::json_escape_string(chunk, out));
+      str.remove_prefix(chunk.size());
+    }
+    _buffer->append('"');
+  }
+
+  JsonBuffer  _own_buffer;
+  JsonBuffer* _buffer;
+
+  std::array<bool, MAX_DEPTH> _needs_comma = {};
+  std::size_t                 _depth       = 0;
+  bool                        _after_key   = false;
+  bool                        _failed      = false;
+};
+
+} // namespace app_platform
+} // namespace ubytes
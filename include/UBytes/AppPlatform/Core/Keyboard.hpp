@@ -1,5 +1,10 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
 namespace ubytes
 {
 namespace app_platform
@@ -117,8 +122,116 @@ struct Keyboard
 
     KeyMAX, // Keep this at the end
   };
+
+  /// The modifier keys held down with a key, combined as bit flags.
+  enum Modifiers : std::uint8_t
+  {
+    NoModifiers = 0,
+    Ctrl        = 1 << 0,
+    Shift       = 1 << 1,
+    Alt         = 1 << 2,
+
+    ModifiersMAX = 1 << 3, // The number of combinations, keep this at the end
+  };
+
+  /// Returns true for the keys that only modify other keys (Ctrl, Shift, Alt and System).
+  static constexpr auto is_modifier(Key key) noexcept -> bool
+  {
+    return key >= LControl && key <= RSystem;
+  }
 };
 
+/// A key pressed with a set of modifiers, e.g. Ctrl+Shift+P.
+struct KeyStroke
+{
+  /// The number of distinct strokes, the size of the tables indexed by `index()`.
+  static constexpr std::size_t COUNT = std::size_t(Keyboard::KeyMAX) * Keyboard::ModifiersMAX;
+
+  Keyboard::Key key       = Keyboard::Unknown;
+  std::uint8_t  modifiers = Keyboard::NoModifiers;
+
+  constexpr KeyStroke() noexcept = default;
+
+  constexpr KeyStroke(Keyboard::Key key, std::uint8_t modifiers = Keyboard::NoModifiers) noexcept
+    : key(key)
+    , modifiers(modifiers)
+  {
+  }
+
+  /// Returns false for unknown keys and modifiers.
+  constexpr auto is_valid() const noexcept -> bool
+  {
+    return key >= 0 && key < Keyboard::KeyMAX && modifiers < Keyboard::ModifiersMAX;
+  }
+
+  /// Returns a dense index below `COUNT`. The stroke must be valid.
+  constexpr auto index() const noexcept -> std::size_t
+  {
+    return std::size_t(key) * Keyboard::ModifiersMAX + modifiers;
+  }
+
+  friend constexpr auto operator==(KeyStroke const& a, KeyStroke const& b) noexcept -> bool = default;
+};
+
+/// A set of key strokes, one bit per stroke.
+class KeyStrokeSet
+{
+public:
+  /// Returns true if the stroke is in the set, or if the set is set to contain every stroke.
+  constexpr auto contains(KeyStroke stroke) const noexcept -> bool
+  {
+    if (_all) {
+      return true;
+    }
+    if (!stroke.is_valid()) {
+      return false;
+    }
+    auto const index = stroke.index();
+    return (_bits[index / 64] >> (index % 64)) & 1;
+  }
+
+  constexpr auto insert(KeyStroke stroke) noexcept -> void
+  {
+    if (stroke.is_valid()) {
+      auto const index = stroke.index();
+      _bits[index / 64] |= std::uint64_t(1) << (index % 64);
+    }
+  }
+
+  constexpr auto erase(KeyStroke stroke) noexcept -> void
+  {
+    if (stroke.is_valid()) {
+      auto const index = stroke.index();
+      _bits[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+    }
+  }
+
+  /// Makes `contains()` return true for every stroke, without changing the set.
+  constexpr auto set_all(bool all) noexcept -> void
+  {
+    _all = all;
+  }
+
+  /// Returns the number of strokes in the set.
+  constexpr auto size() const noexcept -> std::size_t
+  {
+    auto count = std::size_t(0);
+    for (auto const word : _bits) {
+      count += static_cast<std::size_t>(std::popcount(word));
+    }
+    return count;
+  }
+
+  constexpr auto clear() noexcept -> void
+  {
+    _bits = {};
+    _all  = false;
+  }
+
+private:
+  std::array<std::uint64_t, (KeyStroke::COUNT + 63) / 64> _bits = {};
+  bool                                                    _all  = false;
+};
 
 } // namespace app_platform
 } // namespace ubytes
\ No newline at end of file
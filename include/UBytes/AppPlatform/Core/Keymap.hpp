@@ -0,0 +1,339 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Keyboard.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// The result of `Keymap::press()`.
+struct KeyPress
+{
+  enum Status : std::uint8_t
+  {
+    /// The stroke is not bound (and cancelled the pending chord, if any).
+    Unbound,
+    /// The stroke started or continued a chord, the next strokes decide.
+    Pending,
+    /// The stroke completed a binding, `command` is set.
+    Command,
+  };
+
+  Status        status  = Unbound;
+  std::uint32_t command = 0;
+};
+
+/// Maps key strokes and chords (sequences of strokes, e.g. Ctrl+K, Ctrl+C) to command ids.
+///
+/// The first stroke is looked up in a flat table with an entry for every key and modifier
+/// combination, so `press()` is a single indexed load for single-stroke bindings. The
+/// following strokes of chords go through a trie, whose nodes list only their few children.
+/// Binding and unbinding update the table and the trie in place.
+///
+/// ```cpp
+/// auto keymap = Keymap();
+/// keymap.bind({KeyStroke(Keyboard::P, Keyboard::Ctrl | Keyboard::Shift)}, COMMAND_PALETTE);
+/// keymap.bind({KeyStroke(Keyboard::K, Keyboard::Ctrl), KeyStroke(Keyboard::C, Keyboard::Ctrl)}, COMMENT);
+/// keymap.on_command = [](std::uint32_t command) { run(command); };
+///
+/// // Every key: `press()` is as cheap as checking `strokes()` first.
+/// webview.on_accelerator_key = [&keymap](WebView::AcceleratorKey key) { keymap.press(key.stroke()); };
+/// ```
+/// @note Command ids must be non-zero and below 2^31.
+class Keymap
+{
+public:
+  /// Called when a binding is completed by `press()`.
+  std::function<void(std::uint32_t command)> on_command;
+
+  Keymap()
+    : _table(KeyStroke::COUNT, EMPTY)
+    , _nodes(1)
+    , _strokes(std::make_shared<KeyStrokeSet>())
+  {
+  }
+
+  /// Binds a sequence of strokes to a command, replacing the command it was bound to.
+  /// @return false if the sequence is empty or invalid, or if it conflicts with another binding:
+  /// a sequence cannot be both a command and the beginning of a longer chord.
+  auto bind(std::span<KeyStroke const> sequence, std::uint32_t command) -> bool
+  {
+    if (sequence.empty() || command == EMPTY || (command & NODE_FLAG) != 0 || !all_valid(sequence)) {
+      return false;
+    }
+    if (_current != ROOT) {
+      reset();
+    }
+
+    // A conflict can only be found in existing nodes, before any new one is made.
+    auto node = ROOT;
+    for (std::size_t i = 0; i + 1 < sequence.size(); ++i) {
+      auto entry = find(node, sequence[i]);
+      if (entry == EMPTY) {
+        entry                   = NODE_FLAG | allocate_node();
+        slot(node, sequence[i]) = entry;
+        if (node == ROOT) {
+          _strokes->insert(sequence[i]);
+        }
+      }
+      else if ((entry & NODE_FLAG) == 0) {
+        return false;
+      }
+      node = entry & ~NODE_FLAG;
+    }
+
+    auto& entry = slot(node, sequence.back());
+    if ((entry & NODE_FLAG) != 0) {
+      return false;
+    }
+    entry = command;
+    if (node == ROOT) {
+      _strokes->insert(sequence.back());
+    }
+    return true;
+  }
+
+  auto bind(std::initializer_list<KeyStroke> sequence, std::uint32_t command) -> bool
+  {
+    return bind(std::span<KeyStroke const>(sequence.begin(), sequence.size()), command);
+  }
+
+  /// Removes the binding of a sequence.
+  /// @return false if the sequence was not bound to a command.
+  auto unbind(std::span<KeyStroke const> sequence) -> bool
+  {
+    if (sequence.empty() || !all_valid(sequence)) {
+      return false;
+    }
+    if (_current != ROOT) {
+      reset();
+    }
+
+    // The path, to remove the nodes left without children.
+    auto path = std::vector<std::uint32_t>{ROOT};
+    for (std::size_t i = 0; i + 1 < sequence.size(); ++i) {
+      auto const entry = find(path.back(), sequence[i]);
+      if ((entry & NODE_FLAG) == 0) {
+        return false;
+      }
+      path.push_back(entry & ~NODE_FLAG);
+    }
+    auto const entry = find(path.back(), sequence.back());
+    if (entry == EMPTY || (entry & NODE_FLAG) != 0) {
+      return false;
+    }
+
+    erase(path.back(), sequence.back());
+    for (auto i = path.size() - 1; i > 0 && _nodes[path[i]].children.empty(); --i) {
+      release_node(path[i]);
+      erase(path[i - 1], sequence[i - 1]);
+    }
+    return true;
+  }
+
+  auto unbind(std::initializer_list<KeyStroke> sequence) -> bool
+  {
+    return unbind(std::span<KeyStroke const>(sequence.begin(), sequence.size()));
+  }
+
+  /// Returns the command bound to a single stroke, 0 if none. Does not change the chord state.
+  auto lookup(KeyStroke stroke) const noexcept -> std::uint32_t
+  {
+    if (!stroke.is_valid()) {
+      return EMPTY;
+    }
+    auto const entry = _table[stroke.index()];
+    return (entry & NODE_FLAG) != 0 ? EMPTY : entry;
+  }
+
+  /// Handles a stroke: completes a binding (and calls `on_command`), continues a chord or
+  /// cancels it. Modifier keys pressed alone are ignored, so that they don't cancel chords.
+  auto press(KeyStroke stroke) -> KeyPress
+  {
+    if (!stroke.is_valid() || Keyboard::is_modifier(stroke.key)) {
+      return KeyPress();
+    }
+
+    auto const entry = _current == ROOT ? _table[stroke.index()] : find(_current, stroke);
+    if (entry == EMPTY) {
+      if (_current != ROOT) {
+        reset();
+      }
+      return KeyPress();
+    }
+    if ((entry & NODE_FLAG) != 0) {
+      _current = entry & ~NODE_FLAG;
+      // Every stroke has to reach `press()` now, to continue or cancel the chord.
+      _strokes->set_all(true);
+      return KeyPress{KeyPress::Pending};
+    }
+
+    if (_current != ROOT) {
+      reset();
+    }
+    if (on_command) {
+      on_command(entry);
+    }
+    return KeyPress{KeyPress::Command, entry};
+  }
+
+  /// Returns true while a chord is pending.
+  auto is_pending() const noexcept -> bool
+  {
+    return _current != ROOT;
+  }
+
+  /// Cancels the pending chord.
+  auto reset() noexcept -> void
+  {
+    _current = ROOT;
+    _strokes->set_all(false);
+  }
+
+  /// Returns the strokes to forward to `press()`: the first strokes of the bindings, or all
+  /// of them while a chord is pending. Updated in place, for a backend that filters the keys
+  /// before calling the handler (see `filter_accelerator_keys()`).
+  auto strokes() const noexcept -> std::shared_ptr<KeyStrokeSet const>
+  {
+    return _strokes;
+  }
+
+  /// Removes every binding.
+  auto clear() -> void
+  {
+    std::fill(_table.begin(), _table.end(), EMPTY);
+    _nodes.resize(1);
+    _free_nodes.clear();
+    _current = ROOT;
+    _strokes->clear();
+  }
+
+private:
+  static constexpr std::uint32_t EMPTY     = 0;
+  static constexpr std::uint32_t NODE_FLAG = 0x8000'0000u;
+  static constexpr std::uint32_t ROOT      = 0;
+
+  struct Child
+  {
+    std::uint16_t stroke;
+    std::uint32_t entry;
+  };
+  static_assert(KeyStroke::COUNT <= 0xFFFF, "Child::stroke must hold every stroke index");
+
+  /// A chord prefix. The root's children are in `_table` instead.
+  struct Node
+  {
+    /// Sorted by stroke. Chords rarely have more than a few continuations.
+    std::vector<Child> children;
+  };
+
+  static auto all_valid(std::span<KeyStroke const> sequence) noexcept -> bool
+  {
+    return std::all_of(
+      sequence.begin(),
+      sequence.end(),
+      [](KeyStroke stroke)
+      {
+        return stroke.is_valid() && !Keyboard::is_modifier(stroke.key);
+      }
+    );
+  }
+
+  auto find(std::uint32_t node, KeyStroke stroke) const noexcept -> std::uint32_t
+  {
+    if (node == ROOT) {
+      return _table[stroke.index()];
+    }
+    auto const& children = _nodes[node].children;
+    auto const  index    = static_cast<std::uint16_t>(stroke.index());
+    auto const  it       = std::lower_bound(
+      children.begin(),
+      children.end(),
+      index,
+      [](Child const& child, std::uint16_t index)
+      {
+        return child.stroke < index;
+      }
+    );
+    return it != children.end() && it->stroke == index ? it->entry : EMPTY;
+  }
+
+  /// Returns the entry of a stroke in a node, inserting an empty one if needed.
+  auto slot(std::uint32_t node, KeyStroke stroke) -> std::uint32_t&
+  {
+    if (node == ROOT) {
+      return _table[stroke.index()];
+    }
+    auto&      children = _nodes[node].children;
+    auto const index    = static_cast<std::uint16_t>(stroke.index());
+    auto       it       = std::lower_bound(
+      children.begin(),
+      children.end(),
+      index,
+      [](Child const& child, std::uint16_t index)
+      {
+        return child.stroke < index;
+      }
+    );
+    if (it == children.end() || it->stroke != index) {
+      it = children.insert(it, Child{index, EMPTY});
+    }
+    return it->entry;
+  }
+
+  auto erase(std::uint32_t node, KeyStroke stroke) -> void
+  {
+    if (node == ROOT) {
+      _table[stroke.index()] = EMPTY;
+      _strokes->erase(stroke);
+      return;
+    }
+    auto&      children = _nodes[node].children;
+    auto const index    = static_cast<std::uint16_t>(stroke.index());
+    std::erase_if(
+      children,
+      [index](Child const& child)
+      {
+        return child.stroke == index;
+      }
+    );
+  }
+
+  auto allocate_node() -> std::uint32_t
+  {
+    if (!_free_nodes.empty()) {
+      auto const node = _free_nodes.back();
+      _free_nodes.pop_back();
+      return node;
+    }
+    _nodes.emplace_back();
+    return static_cast<std::uint32_t>(_nodes.size() - 1);
+  }
+
+  auto release_node(std::uint32_t node) -> void
+  {
+    _nodes[node].children.clear();
+    _free_nodes.push_back(node);
+  }
+
+  /// The entries of the first strokes: a command id, a `NODE_FLAG`ged node index or `EMPTY`.
+  std::vector<std::uint32_t> _table;
+  std::vector<Node>          _nodes;
+  std::vector<std::uint32_t> _free_nodes;
+  std::uint32_t              _current = ROOT;
+
+  std::shared_ptr<KeyStrokeSet> _strokes;
+};
+
+} // namespace app_platform
+} // namespace ubytes
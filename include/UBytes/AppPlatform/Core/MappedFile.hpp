@@ -0,0 +1,192 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Text.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Opt-in, not included by `Core.hpp`, as it includes `<windows.h>` on Windows.
+
+#if defined(_WIN32)
+// Without the `min`/`max` macros, like `App/UiQueueMessageLoop.hpp`.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// The platform state of a mapping.
+struct FileMapping
+{
+  void const* data   = nullptr;
+  std::size_t size   = 0;
+  void*       handle = nullptr;
+};
+
+#if defined(_WIN32)
+
+/// Maps a whole file read-only.
+inline auto map_file(std::string_view path, FileMapping& mapping) -> bool
+{
+  auto const wide_path = utf8_to_wstring(path);
+  auto const file      = ::CreateFileW(
+    wide_path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr
+  );
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  auto size = LARGE_INTEGER();
+  if (!::GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    ::CloseHandle(file);
+    return false;
+  }
+
+  // The section keeps the file open.
+  auto const section = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (!section) {
+    return false;
+  }
+
+  auto const* data = ::MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+  if (!data) {
+    ::CloseHandle(section);
+    return false;
+  }
+
+  mapping.data   = data;
+  mapping.size   = static_cast<std::size_t>(size.QuadPart);
+  mapping.handle = section;
+  return true;
+}
+
+inline auto unmap_file(FileMapping& mapping) -> void
+{
+  ::UnmapViewOfFile(mapping.data);
+  ::CloseHandle(mapping.handle);
+}
+
+#else
+
+inline auto map_file(std::string_view path, FileMapping& mapping) -> bool
+{
+  auto const fd = ::open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info = {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  auto const size = static_cast<std::size_t>(info.st_size);
+  auto*      data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  mapping.data = data;
+  mapping.size = size;
+  return true;
+}
+
+inline auto unmap_file(FileMapping& mapping) -> void
+{
+  ::munmap(const_cast<void*>(mapping.data), mapping.size);
+}
+
+#endif
+
+} // namespace details
+
+/// A read-only, memory-mapped file.
+///
+/// Pages are loaded on first access and shared with the page cache, so opening
+/// a large file costs no reads and no copies.
+class MappedFile
+{
+public:
+  MappedFile() noexcept = default;
+
+  /// Maps the file at `path` (UTF-8). Check the result with `operator bool`.
+  static auto open(std::string_view path) -> MappedFile
+  {
+    auto file = MappedFile();
+    if (!details::map_file(path, file._mapping)) {
+      file._mapping = {};
+    }
+    return file;
+  }
+
+  MappedFile(MappedFile&& other) noexcept
+    : _mapping(std::exchange(other._mapping, {}))
+  {
+  }
+
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&
+  {
+    if (this != &other) {
+      close();
+      _mapping = std::exchange(other._mapping, {});
+    }
+    return *this;
+  }
+
+  MappedFile(MappedFile const&)                    = delete;
+  auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+  ~MappedFile()
+  {
+    close();
+  }
+
+  auto bytes() const noexcept -> std::span<std::byte const>
+  {
+    return std::span(static_cast<std::byte const*>(_mapping.data), _mapping.size);
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _mapping.data != nullptr;
+  }
+
+private:
+  auto close() noexcept -> void
+  {
+    if (_mapping.data) {
+      details::unmap_file(_mapping);
+      _mapping = {};
+    }
+  }
+
+  details::FileMapping _mapping;
+};
+
+} // namespace app_platform
+} // namespace ubytes
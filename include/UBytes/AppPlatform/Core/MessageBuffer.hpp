@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+class MessageBufferPool;
+
+namespace details
+{
+
+struct MessageBufferPoolState;
+
+/// A reference-counted storage block, owned by a pool while not in use.
+struct MessageBufferBlock
+{
+  std::atomic<std::uint32_t>              refs = 0;
+  std::unique_ptr<char[]>                 data;
+  std::size_t                             size     = 0;
+  std::size_t                             capacity = 0;
+  std::shared_ptr<MessageBufferPoolState> pool;
+};
+
+struct MessageBufferPoolState
+{
+  std::mutex                       mutex;
+  std::vector<MessageBufferBlock*> free;
+  std::size_t                      max_pooled   = 0;
+  std::size_t                      max_capacity = 0;
+  bool                             closed       = false;
+
+  std::atomic<std::size_t> allocations = 0;
+  std::atomic<std::size_t> reuses      = 0;
+
+  /// Takes back a block whose last reference was released.
+  auto recycle(MessageBufferBlock* block) -> void
+  {
+    {
+      auto lock = std::lock_guard(mutex);
+      if (!closed && free.size() < max_pooled && block->capacity <= max_capacity) {
+        free.push_back(block);
+        return;
+      }
+    }
+    delete block;
+  }
+};
+
+} // namespace details
+
+/// A handle to a received message stored in a pooled buffer.
+///
+/// The handle is cheap to copy (one atomic increment) and the buffer goes back
+/// to its pool when the last handle is released, from any thread.
+/// The contents are UTF-8 and always followed by a null terminator.
+class MessageBuffer
+{
+public:
+  MessageBuffer() noexcept = default;
+
+  MessageBuffer(MessageBuffer const& other) noexcept
+    : _block(other._block)
+  {
+    if (_block) {
+      _block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  MessageBuffer(MessageBuffer&& other) noexcept
+    : _block(std::exchange(other._block, nullptr))
+  {
+  }
+
+  auto operator=(MessageBuffer const& other) noexcept -> MessageBuffer&
+  {
+    if (this != &other) {
+      release();
+      _block = other._block;
+      if (_block) {
+        _block->refs.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    return *this;
+  }
+
+  auto operator=(MessageBuffer&& other) noexcept -> MessageBuffer&
+  {
+    if (this != &other) {
+      release();
+      _block = std::exchange(other._block, nullptr);
+    }
+    return *this;
+  }
+
+  ~MessageBuffer()
+  {
+    release();
+  }
+
+  /// Returns the contents. The view is null-terminated.
+  auto view() const noexcept -> std::string_view
+  {
+    return _block ? std::string_view(_block->data.get(), _block->size) : std::string_view("", 0);
+  }
+
+  auto data() const noexcept -> char const*
+  {
+    return view().data();
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _block ? _block->size : 0;
+  }
+
+  auto empty() const noexcept -> bool
+  {
+    return size() == 0;
+  }
+
+  /// Returns the writable storage of a freshly acquired buffer.
+  /// @note Only the producer (the library or a custom backend) writes to a buffer,
+  /// and only before sharing the handle.
+  auto storage() noexcept -> char*
+  {
+    return _block->data.get();
+  }
+
+  /// Sets the size of the contents written through `storage()`.
+  auto commit(std::size_t size) noexcept -> void
+  {
+    _block->size       = size;
+    _block->data[size] = '\0';
+  }
+
+  /// Returns the number of characters that fit in `storage()`.
+  auto capacity() const noexcept -> std::size_t
+  {
+    return _block ? _block->capacity : 0;
+  }
+
+  /// Releases the buffer, returning it to the pool if this was the last handle.
+  auto release() noexcept -> void
+  {
+    auto* block = std::exchange(_block, nullptr);
+    if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // Keep the pool state alive, recycling may free the block (and its reference).
+      auto pool = block->pool;
+      pool->recycle(block);
+    }
+  }
+
+private:
+  friend class MessageBufferPool;
+
+  explicit MessageBuffer(details::MessageBufferBlock* block) noexcept
+    : _block(block)
+  {
+    _block->refs.store(1, std::memory_order_relaxed);
+  }
+
+  details::MessageBufferBlock* _block = nullptr;
+};
+
+/// A thread-safe pool of message buffers.
+/// Buffers keep their storage when recycled, so once the pool is warmed up
+/// acquiring a buffer for a message of a similar size does not allocate.
+/// Buffers grown past `max_capacity` are freed on release, so one large message
+/// does not keep its storage pooled.
+class MessageBufferPool
+{
+public:
+  static constexpr std::size_t DEFAULT_MAX_CAPACITY = 256 * 1024;
+
+  struct Stats
+  {
+    /// Number of heap allocations made for buffer storage.
+    std::size_t allocations = 0;
+    /// Number of acquisitions served from recycled buffers without allocating.
+    std::size_t reuses = 0;
+  };
+
+  /// @param max_pooled - how many idle buffers are kept, the rest is freed on release.
+  /// @param max_capacity - the largest buffer kept, larger ones are freed on release.
+  explicit MessageBufferPool(std::size_t max_pooled = 16, std::size_t max_capacity = DEFAULT_MAX_CAPACITY)
+    : _state(std::make_shared<details::MessageBufferPoolState>())
+  {
+    _state->max_pooled   = max_pooled;
+    _state->max_capacity = max_capacity;
+  }
+
+  MessageBufferPool(MessageBufferPool&&) noexcept                    = default;
+  auto operator=(MessageBufferPool&&) noexcept -> MessageBufferPool& = default;
+
+  ~MessageBufferPool()
+  {
+    if (!_state) {
+      return;
+    }
+
+    auto free = std::vector<details::MessageBufferBlock*>();
+    {
+      auto lock      = std::lock_guard(_state->mutex);
+      _state->closed = true;
+      free.swap(_state->free);
+    }
+    for (auto* block : free) {
+      delete block;
+    }
+  }
+
+  /// Returns an empty buffer with room for at least `capacity` characters (plus the null terminator).
+  auto acquire(std::size_t capacity) -> MessageBuffer
+  {
+    details::MessageBufferBlock* block = nullptr;
+    {
+      auto lock = std::lock_guard(_state->mutex);
+      if (!_state->free.empty()) {
+        block = _state->free.back();
+        _state->free.pop_back();
+      }
+    }
+
+    if (!block) {
+      block       = new details::MessageBufferBlock();
+      block->pool = _state;
+    }
+
+    if (block->capacity < capacity || !block->data) {
+      auto const new_capacity = std::max(capacity, block->capacity * 2);
+      block->data             = std::make_unique_for_overwrite<char[]>(new_capacity + 1);
+      block->capacity         = new_capacity;
+      _state->allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+      _state->reuses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto buffer = MessageBuffer(block);
+    buffer.commit(0);
+    return buffer;
+  }
+
+  /// Returns a buffer holding a copy of `contents`.
+  auto acquire(std::string_view contents) -> MessageBuffer
+  {
+    auto buffer = acquire(contents.size());
+    std::memcpy(buffer.storage(), contents.data(), contents.size());
+    buffer.commit(contents.size());
+    return buffer;
+  }
+
+  auto stats() const noexcept -> Stats
+  {
+    return Stats{
+      _state->allocations.load(std::memory_order_relaxed),
+      _state->reuses.load(std::memory_order_relaxed),
+    };
+  }
+
+private:
+  std::shared_ptr<details::MessageBufferPoolState> _state;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <string_view>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// Reads `Bytes` bytes as a little-endian integer (a plain load outside of constant evaluation).
+template <std::size_t Bytes>
+constexpr auto perfect_hash_load(char const* bytes) noexcept -> std::uint64_t
+{
+  if (std::is_constant_evaluated()) {
+    auto word = std::uint64_t(0);
+    for (std::size_t i = 0; i < Bytes; ++i) {
+      word |= std::uint64_t(static_cast<std::uint8_t>(bytes[i])) << (8 * i);
+    }
+    return word;
+  }
+  if constexpr (Bytes == 8) {
+    auto word = std::uint64_t(0);
+    std::memcpy(&word, bytes, 8);
+    return word;
+  }
+  else {
+    auto word = std::uint32_t(0);
+    std::memcpy(&word, bytes, 4);
+    return word;
+  }
+}
+
+/// Hashes a key for `PerfectHash`, once per lookup, 8 bytes at a time.
+constexpr auto perfect_hash_key(std::string_view key) noexcept -> std::uint64_t
+{
+  auto const* const data = key.data();
+  auto const        size = key.size();
+  auto const        step = [](std::uint64_t hash, std::uint64_t word) noexcept
+  {
+    hash  = (hash ^ word) * 0xFF51AFD7ED558CCDu;
+    return hash ^ (hash >> 32);
+  };
+
+  auto hash = std::uint64_t(size) * 0x9E3779B97F4A7C15u;
+  if (size >= 8) {
+    for (std::size_t i = 0; i + 8 <= size; i += 8) {
+      hash = step(hash, perfect_hash_load<8>(data + i));
+    }
+    // The last bytes are read with an overlapping load, the size is in the hash already.
+    if (size % 8 != 0) {
+      hash = step(hash, perfect_hash_load<8>(data + size - 8));
+    }
+  }
+  else if (size >= 4) {
+    hash = step(hash, perfect_hash_load<4>(data) | (perfect_hash_load<4>(data + size - 4) << 32));
+  }
+  else if (size > 0) {
+    auto const byte = [data](std::size_t i) noexcept
+    {
+      return std::uint64_t(static_cast<std::uint8_t>(data[i]));
+    };
+    hash = step(hash, byte(0) | (byte(size / 2) << 8) | (byte(size - 1) << 16));
+  }
+  return hash;
+}
+
+/// Derives a seeded hash from the hash of a key (a murmur3 finalizer).
+constexpr auto perfect_hash_mix(std::uint64_t hash, std::uint32_t seed) noexcept -> std::uint32_t
+{
+  hash ^= seed * 0x9E3779B97F4A7C15u;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53u;
+  hash ^= hash >> 33;
+  return static_cast<std::uint32_t>(hash);
+}
+
+// Not constexpr on purpose: reaching these during constant evaluation is a compile error.
+inline auto perfect_hash_error_duplicate_key() -> void
+{
+}
+
+inline auto perfect_hash_error_no_displacement_found() -> void
+{
+}
+
+} // namespace details
+
+/// A perfect hash table over a fixed set of keys, built at compile time.
+///
+/// Uses the "hash and displace" scheme: keys are grouped into buckets by one hash,
+/// then every bucket gets a displacement (a seed) that places its keys in free slots.
+/// A lookup is one hash of the key, two table reads and one key comparison, no allocation.
+///
+/// ```cpp
+/// constexpr auto table = PerfectHash<3>({"open", "close", "list"});
+/// static_assert(table.find("close") == 1);
+/// ```
+template <std::size_t N>
+class PerfectHash
+{
+public:
+  /// Returned by `find()` for keys outside of the set.
+  static constexpr std::size_t npos = std::size_t(-1);
+
+  static constexpr std::size_t TABLE_SIZE  = std::bit_ceil(N * 2 > 2 ? N * 2 : std::size_t(2));
+  static constexpr std::size_t BUCKET_SIZE = std::bit_ceil(N / 2 > 1 ? N / 2 : std::size_t(1));
+
+  consteval explicit PerfectHash(std::array<std::string_view, N> const& keys)
+    : _keys(keys)
+  {
+    auto hashes    = std::array<std::uint64_t, N>();
+    auto bucket_of = std::array<std::size_t, N>();
+    auto sizes     = std::array<std::size_t, BUCKET_SIZE>();
+    for (std::size_t i = 0; i < N; ++i) {
+      hashes[i]    = details::perfect_hash_key(keys[i]);
+      bucket_of[i] = details::perfect_hash_mix(hashes[i], 0) & (BUCKET_SIZE - 1);
+      ++sizes[bucket_of[i]];
+    }
+
+    // The keys grouped by bucket, so that placing a bucket only visits its own keys:
+    // the build stays linear in N and within the constant evaluation limits.
+    auto starts  = std::array<std::size_t, BUCKET_SIZE + 1>();
+    auto members = std::array<std::size_t, N>();
+    auto largest = std::size_t(0);
+    for (std::size_t b = 0; b < BUCKET_SIZE; ++b) {
+      starts[b + 1] = starts[b] + sizes[b];
+      largest       = sizes[b] > largest ? sizes[b] : largest;
+    }
+    auto filled = starts;
+    for (std::size_t i = 0; i < N; ++i) {
+      members[filled[bucket_of[i]]++] = i;
+    }
+
+    // Equal keys land in the same bucket.
+    for (std::size_t b = 0; b < BUCKET_SIZE; ++b) {
+      for (std::size_t i = starts[b]; i < starts[b + 1]; ++i) {
+        for (std::size_t j = i + 1; j < starts[b + 1]; ++j) {
+          if (keys[members[i]] == keys[members[j]]) {
+            details::perfect_hash_error_duplicate_key();
+          }
+        }
+      }
+    }
+
+    // Place the largest buckets first, they are the hardest to fit.
+    auto taken = std::array<std::size_t, N>();
+    for (auto size = largest; size > 0; --size) {
+      for (std::size_t bucket = 0; bucket < BUCKET_SIZE; ++bucket) {
+        if (sizes[bucket] != size) {
+          continue;
+        }
+
+        bool done = false;
+        for (std::uint32_t displacement = 1; displacement < (1u << 20) && !done; ++displacement) {
+          done = true;
+          for (std::size_t m = 0; m < size && done; ++m) {
+            auto const slot = details::perfect_hash_mix(hashes[members[starts[bucket] + m]], displacement)
+                              & (TABLE_SIZE - 1);
+            if (_slots[slot] != 0) {
+              done = false;
+            }
+            for (std::size_t t = 0; t < m && done; ++t) {
+              done = taken[t] != slot;
+            }
+            taken[m] = slot;
+          }
+
+          if (done) {
+            _displacements[bucket] = displacement;
+            for (std::size_t m = 0; m < size; ++m) {
+              _slots[taken[m]] = static_cast<std::uint32_t>(members[starts[bucket] + m] + 1);
+            }
+          }
+        }
+
+        if (!done) {
+          details::perfect_hash_error_no_displacement_found();
+        }
+      }
+    }
+  }
+
+  /// Returns the index of `key` in the array the table was built from, or `npos`.
+  constexpr auto find(std::string_view key) const noexcept -> std::size_t
+  {
+    auto const hash   = details::perfect_hash_key(key);
+    auto const bucket = details::perfect_hash_mix(hash, 0) & (BUCKET_SIZE - 1);
+    auto const slot   = details::perfect_hash_mix(hash, _displacements[bucket]) & (TABLE_SIZE - 1);
+    auto const index  = _slots[slot];
+    if (index == 0 || _keys[index - 1] != key) {
+      return npos;
+    }
+    return index - 1;
+  }
+
+  constexpr auto keys() const noexcept -> std::array<std::string_view, N> const&
+  {
+    return _keys;
+  }
+
+private:
+  std::array<std::string_view, N>        _keys          = {};
+  std::array<std::uint32_t, BUCKET_SIZE> _displacements = {};
+  std::array<std::uint32_t, TABLE_SIZE>  _slots         = {};
+};
+
+} // namespace app_platform
+} // namespace ubytes
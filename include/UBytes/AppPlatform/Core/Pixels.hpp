@@ -0,0 +1,776 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Color.hpp>
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+// Batch conversions of pixel buffers (e.g. texture previews) between the color formats.
+//
+// Every function converts `min(in.size(), out.size())` colors and takes the instruction set
+// to use, by default the best one available. All levels produce the same results: the float
+// to byte conversions round to nearest like `ColorTypeProperties<float>::to_byte`.
+
+namespace details
+{
+
+static_assert(sizeof(Color4u) == 4 && sizeof(Color3u) == 3, "Byte colors must be tightly packed");
+static_assert(sizeof(Color4f) == 16, "Float colors must be tightly packed");
+
+using FloatProps = ColorTypeProperties<float>;
+
+/// Rounds a value in the byte range to the nearest byte, see `ColorTypeProperties<float>::to_byte`.
+inline auto round_to_byte(float value) noexcept -> std::uint8_t
+{
+  value = value < 255.0f ? value : 255.0f;
+  return std::uint8_t(std::bit_cast<std::uint32_t>(value + 12582912.0f) & 0xFF);
+}
+
+/// Multiplies two bytes as 0 - 1 values, rounding to nearest.
+constexpr auto multiply_bytes(std::uint8_t a, std::uint8_t b) noexcept -> std::uint8_t
+{
+  auto const t = std::uint32_t(a) * b + 128;
+  return std::uint8_t((t + (t >> 8)) >> 8);
+}
+
+inline auto unpremultiply_byte(std::uint8_t c, float scale) noexcept -> std::uint8_t
+{
+  return round_to_byte(float(c) * scale);
+}
+
+/// The sRGB transfer function lookups.
+///
+/// Linear to sRGB splits 0 - 1 into 4096 buckets. Each bucket stores the sRGB byte at its start;
+/// the buckets are narrower than the distance between two rounding thresholds, so one comparison
+/// with the next threshold gives the correctly rounded byte.
+struct SrgbTables
+{
+  static constexpr std::size_t BUCKETS = 4096;
+
+  std::array<float, 256>            to_linear;
+  std::array<std::int32_t, BUCKETS> bucket;
+  /// `threshold[k]` is the linear value halfway between the sRGB bytes `k - 1` and `k`.
+  std::array<float, 257> threshold;
+};
+
+inline auto srgb_tables() -> SrgbTables const&
+{
+  static auto const tables = []
+  {
+    auto const to_linear = [](double srgb)
+    {
+      return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+    };
+
+    auto result = SrgbTables();
+    for (std::size_t i = 0; i < 256; ++i) {
+      result.to_linear[i] = float(to_linear(double(i) / 255.0));
+    }
+    result.threshold[0] = 0.0f;
+    for (std::size_t k = 1; k < 256; ++k) {
+      result.threshold[k] = float(to_linear((double(k) - 0.5) / 255.0));
+    }
+    result.threshold[256] = 2.0f;
+
+    auto byte = std::int32_t(0);
+    for (std::size_t q = 0; q < SrgbTables::BUCKETS; ++q) {
+      auto const start = float(q) / float(SrgbTables::BUCKETS);
+      while (byte < 255 && result.threshold[std::size_t(byte) + 1] <= start) {
+        ++byte;
+      }
+      result.bucket[q] = byte;
+    }
+    return result;
+  }();
+  return tables;
+}
+
+inline auto linear_to_srgb_byte(SrgbTables const& tables, float value) noexcept -> std::uint8_t
+{
+  value        = value > 0.0f ? value : 0.0f;
+  value        = value < 1.0f ? value : 1.0f;
+  auto const q = std::min(std::int32_t(value * float(SrgbTables::BUCKETS)), std::int32_t(SrgbTables::BUCKETS - 1));
+  auto       b = tables.bucket[std::size_t(q)];
+  b += value >= tables.threshold[std::size_t(b) + 1] ? 1 : 0;
+  return std::uint8_t(b);
+}
+
+// Scalar kernels, also used for the remainders of the vectorized ones.
+
+inline auto floats_to_bytes_scalar(Color4f const* in, Color4u* out, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color4u(
+      FloatProps::to_byte(in[i].r),
+      FloatProps::to_byte(in[i].g),
+      FloatProps::to_byte(in[i].b),
+      FloatProps::to_byte(in[i].a)
+    );
+  }
+}
+
+inline auto bytes_to_floats_scalar(Color4u const* in, Color4f* out, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color4f(
+      FloatProps::from_byte(in[i].r),
+      FloatProps::from_byte(in[i].g),
+      FloatProps::from_byte(in[i].b),
+      FloatProps::from_byte(in[i].a)
+    );
+  }
+}
+
+inline auto premultiply_scalar(Color4u* pixels, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& p = pixels[i];
+    p.r     = multiply_bytes(p.r, p.a);
+    p.g     = multiply_bytes(p.g, p.a);
+    p.b     = multiply_bytes(p.b, p.a);
+  }
+}
+
+inline auto unpremultiply_scalar(Color4u* pixels, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& p = pixels[i];
+    if (p.a == 0) {
+      p.set(0, 0, 0, 0);
+      continue;
+    }
+    auto const scale = 255.0f / float(p.a);
+    p.r              = unpremultiply_byte(p.r, scale);
+    p.g              = unpremultiply_byte(p.g, scale);
+    p.b              = unpremultiply_byte(p.b, scale);
+  }
+}
+
+inline auto premultiply_scalar(Color4f* pixels, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& p = pixels[i];
+    p.r *= p.a;
+    p.g *= p.a;
+    p.b *= p.a;
+  }
+}
+
+inline auto unpremultiply_scalar(Color4f* pixels, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& p = pixels[i];
+    if (p.a > 0.0f) {
+      p.r /= p.a;
+      p.g /= p.a;
+      p.b /= p.a;
+    }
+    else {
+      p.r = p.g = p.b = 0.0f;
+    }
+  }
+}
+
+inline auto srgb_to_linear_scalar(Color4u const* in, Color4f* out, std::size_t count) noexcept -> void
+{
+  auto const& tables = srgb_tables();
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color4f(
+      tables.to_linear[in[i].r],
+      tables.to_linear[in[i].g],
+      tables.to_linear[in[i].b],
+      FloatProps::from_byte(in[i].a)
+    );
+  }
+}
+
+inline auto linear_to_srgb_scalar(Color4f const* in, Color4u* out, std::size_t count) noexcept -> void
+{
+  auto const& tables = srgb_tables();
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color4u(
+      linear_to_srgb_byte(tables, in[i].r),
+      linear_to_srgb_byte(tables, in[i].g),
+      linear_to_srgb_byte(tables, in[i].b),
+      FloatProps::to_byte(in[i].a)
+    );
+  }
+}
+
+inline auto rgb_to_rgba_scalar(Color3u const* in, Color4u* out, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color4u(in[i].r, in[i].g, in[i].b, 255);
+  }
+}
+
+inline auto rgba_to_rgb_scalar(Color4u const* in, Color3u* out, std::size_t count) noexcept -> void
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Color3u(in[i].r, in[i].g, in[i].b);
+  }
+}
+
+// Vectorized kernels. They process whole blocks of pixels and return the number of pixels done.
+// A float pixel fills a 128-bit lane, so the SSE kernels work on one pixel per register and the
+// AVX2 kernels on two; byte pixels are widened to 32-bit lanes and packed back four (SSE) or
+// eight (AVX2) at a time.
+
+#if UBYTES_APP_PLATFORM_X86
+
+UBYTES_TARGET_SSE41 inline auto load_pixel_sse41(Color4u const* pixel) noexcept -> __m128i
+{
+  auto bits = std::uint32_t();
+  std::memcpy(&bits, pixel, sizeof(bits));
+  return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(bits)));
+}
+
+/// Packs four pixels of 32-bit lanes (0 - 255) into 16 bytes.
+UBYTES_TARGET_SSE41 inline auto pack_pixels_sse41(__m128i p0, __m128i p1, __m128i p2, __m128i p3) noexcept -> __m128i
+{
+  return _mm_packus_epi16(_mm_packus_epi32(p0, p1), _mm_packus_epi32(p2, p3));
+}
+
+/// Scales 0 - 1 values to bytes, rounding to nearest (the default MXCSR mode).
+UBYTES_TARGET_SSE41 inline auto float_to_byte_lanes_sse41(__m128 value) noexcept -> __m128i
+{
+  // `max` returns its second operand for NaN.
+  value = _mm_max_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_setzero_ps());
+  return _mm_cvtps_epi32(_mm_min_ps(value, _mm_set1_ps(255.0f)));
+}
+
+UBYTES_TARGET_SSE41 inline auto floats_to_bytes_sse41(Color4f const* in, Color4u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const* src = reinterpret_cast<float const*>(in);
+  std::size_t i   = 0;
+  for (; i + 4 <= count; i += 4, src += 16) {
+    auto const p0 = float_to_byte_lanes_sse41(_mm_loadu_ps(src));
+    auto const p1 = float_to_byte_lanes_sse41(_mm_loadu_ps(src + 4));
+    auto const p2 = float_to_byte_lanes_sse41(_mm_loadu_ps(src + 8));
+    auto const p3 = float_to_byte_lanes_sse41(_mm_loadu_ps(src + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), pack_pixels_sse41(p0, p1, p2, p3));
+  }
+  return i;
+}
+
+UBYTES_TARGET_SSE41 inline auto bytes_to_floats_sse41(Color4u const* in, Color4f* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto* dst = reinterpret_cast<float*>(out);
+  for (std::size_t i = 0; i < count; ++i, dst += 4) {
+    auto const value = _mm_cvtepi32_ps(load_pixel_sse41(in + i));
+    _mm_storeu_ps(dst, _mm_div_ps(value, _mm_set1_ps(255.0f)));
+  }
+  return count;
+}
+
+/// Multiplies the color bytes of two pixels (widened to 16-bit lanes) by their alpha.
+UBYTES_TARGET_SSE41 inline auto premultiply_lanes_sse41(__m128i color, __m128i alpha) noexcept -> __m128i
+{
+  auto const t = _mm_add_epi16(_mm_mullo_epi16(color, alpha), _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+UBYTES_TARGET_SSE41 inline auto premultiply_sse41(Color4u* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto const alpha_lo   = _mm_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+  auto const alpha_hi   = _mm_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+  auto const alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  auto const zero       = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    auto* const block = reinterpret_cast<__m128i*>(pixels + i);
+    auto const  in    = _mm_loadu_si128(block);
+    auto const  lo    = premultiply_lanes_sse41(_mm_unpacklo_epi8(in, zero), _mm_shuffle_epi8(in, alpha_lo));
+    auto const  hi    = premultiply_lanes_sse41(_mm_unpackhi_epi8(in, zero), _mm_shuffle_epi8(in, alpha_hi));
+    _mm_storeu_si128(block, _mm_blendv_epi8(_mm_packus_epi16(lo, hi), in, alpha_mask));
+  }
+  return i;
+}
+
+UBYTES_TARGET_SSE41 inline auto unpremultiply_lanes_sse41(__m128i pixel) noexcept -> __m128i
+{
+  auto const value = _mm_cvtepi32_ps(pixel);
+  auto const alpha = _mm_shuffle_ps(value, value, 0xFF);
+  auto       color = _mm_mul_ps(value, _mm_div_ps(_mm_set1_ps(255.0f), alpha));
+  color            = _mm_min_ps(color, _mm_set1_ps(255.0f));
+  color            = _mm_andnot_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), color);
+  return _mm_cvtps_epi32(_mm_blend_ps(color, value, 0x8));
+}
+
+UBYTES_TARGET_SSE41 inline auto unpremultiply_sse41(Color4u* pixels, std::size_t count) noexcept -> std::size_t
+{
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    auto const p0 = unpremultiply_lanes_sse41(load_pixel_sse41(pixels + i));
+    auto const p1 = unpremultiply_lanes_sse41(load_pixel_sse41(pixels + i + 1));
+    auto const p2 = unpremultiply_lanes_sse41(load_pixel_sse41(pixels + i + 2));
+    auto const p3 = unpremultiply_lanes_sse41(load_pixel_sse41(pixels + i + 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), pack_pixels_sse41(p0, p1, p2, p3));
+  }
+  return i;
+}
+
+UBYTES_TARGET_SSE41 inline auto premultiply_sse41(Color4f* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto* data = reinterpret_cast<float*>(pixels);
+  for (std::size_t i = 0; i < count; ++i, data += 4) {
+    auto const value = _mm_loadu_ps(data);
+    auto const alpha = _mm_shuffle_ps(value, value, 0xFF);
+    _mm_storeu_ps(data, _mm_blend_ps(_mm_mul_ps(value, alpha), value, 0x8));
+  }
+  return count;
+}
+
+UBYTES_TARGET_SSE41 inline auto unpremultiply_sse41(Color4f* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto* data = reinterpret_cast<float*>(pixels);
+  for (std::size_t i = 0; i < count; ++i, data += 4) {
+    auto const value = _mm_loadu_ps(data);
+    auto const alpha = _mm_shuffle_ps(value, value, 0xFF);
+    auto const color = _mm_and_ps(_mm_div_ps(value, alpha), _mm_cmpgt_ps(alpha, _mm_setzero_ps()));
+    _mm_storeu_ps(data, _mm_blend_ps(color, value, 0x8));
+  }
+  return count;
+}
+
+UBYTES_TARGET_SSE41 inline auto rgb_to_rgba_sse41(Color3u const* in, Color4u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  auto const alpha  = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+  // Loads 16 bytes, uses 12.
+  std::size_t i = 0;
+  for (; i + 6 <= count; i += 4) {
+    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_shuffle_epi8(block, expand), alpha));
+  }
+  return i;
+}
+
+UBYTES_TARGET_SSE41 inline auto rgba_to_rgb_sse41(Color4u const* in, Color3u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+  // Stores 16 bytes, 12 valid.
+  std::size_t i = 0;
+  for (; i + 6 <= count; i += 4) {
+    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(block, pack));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto load_pixels_avx2(Color4u const* pixels) noexcept -> __m256i
+{
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(pixels)));
+}
+
+/// Packs eight pixels, two per register, of 32-bit lanes (0 - 255) into 32 bytes.
+UBYTES_TARGET_AVX2 inline auto pack_pixels_avx2(__m256i p01, __m256i p23, __m256i p45, __m256i p67) noexcept
+  -> __m256i
+{
+  // The packs work per 128-bit lane, leaving the pixels in the order 0 2 4 6 1 3 5 7.
+  auto const packed = _mm256_packus_epi16(_mm256_packus_epi32(p01, p23), _mm256_packus_epi32(p45, p67));
+  return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+UBYTES_TARGET_AVX2 inline auto float_to_byte_lanes_avx2(__m256 value) noexcept -> __m256i
+{
+  value = _mm256_max_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)), _mm256_setzero_ps());
+  return _mm256_cvtps_epi32(_mm256_min_ps(value, _mm256_set1_ps(255.0f)));
+}
+
+UBYTES_TARGET_AVX2 inline auto floats_to_bytes_avx2(Color4f const* in, Color4u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const* src = reinterpret_cast<float const*>(in);
+  std::size_t i   = 0;
+  for (; i + 8 <= count; i += 8, src += 32) {
+    auto const p01 = float_to_byte_lanes_avx2(_mm256_loadu_ps(src));
+    auto const p23 = float_to_byte_lanes_avx2(_mm256_loadu_ps(src + 8));
+    auto const p45 = float_to_byte_lanes_avx2(_mm256_loadu_ps(src + 16));
+    auto const p67 = float_to_byte_lanes_avx2(_mm256_loadu_ps(src + 24));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pack_pixels_avx2(p01, p23, p45, p67));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto bytes_to_floats_avx2(Color4u const* in, Color4f* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto*       dst = reinterpret_cast<float*>(out);
+  std::size_t i   = 0;
+  for (; i + 2 <= count; i += 2, dst += 8) {
+    auto const value = _mm256_cvtepi32_ps(load_pixels_avx2(in + i));
+    _mm256_storeu_ps(dst, _mm256_div_ps(value, _mm256_set1_ps(255.0f)));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto premultiply_lanes_avx2(__m256i color, __m256i alpha) noexcept -> __m256i
+{
+  auto const t = _mm256_add_epi16(_mm256_mullo_epi16(color, alpha), _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+UBYTES_TARGET_AVX2 inline auto premultiply_avx2(Color4u* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto const alpha_lo = _mm256_setr_epi8(
+    3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1, 3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1
+  );
+  auto const alpha_hi = _mm256_setr_epi8(
+    11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1, 11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15,
+    -1, 15, -1
+  );
+  auto const alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+  auto const zero       = _mm256_setzero_si256();
+
+  // The unpacks and the pack work per 128-bit lane, so the pixels stay in order.
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto* const block = reinterpret_cast<__m256i*>(pixels + i);
+    auto const  in    = _mm256_loadu_si256(block);
+    auto const  lo    = premultiply_lanes_avx2(_mm256_unpacklo_epi8(in, zero), _mm256_shuffle_epi8(in, alpha_lo));
+    auto const  hi    = premultiply_lanes_avx2(_mm256_unpackhi_epi8(in, zero), _mm256_shuffle_epi8(in, alpha_hi));
+    _mm256_storeu_si256(block, _mm256_blendv_epi8(_mm256_packus_epi16(lo, hi), in, alpha_mask));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto unpremultiply_lanes_avx2(__m256i pixels) noexcept -> __m256i
+{
+  auto const value = _mm256_cvtepi32_ps(pixels);
+  auto const alpha = _mm256_permute_ps(value, 0xFF);
+  auto       color = _mm256_mul_ps(value, _mm256_div_ps(_mm256_set1_ps(255.0f), alpha));
+  color            = _mm256_min_ps(color, _mm256_set1_ps(255.0f));
+  color            = _mm256_andnot_ps(_mm256_cmp_ps(alpha, _mm256_setzero_ps(), _CMP_EQ_OQ), color);
+  return _mm256_cvtps_epi32(_mm256_blend_ps(color, value, 0x88));
+}
+
+UBYTES_TARGET_AVX2 inline auto unpremultiply_avx2(Color4u* pixels, std::size_t count) noexcept -> std::size_t
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto const p01 = unpremultiply_lanes_avx2(load_pixels_avx2(pixels + i));
+    auto const p23 = unpremultiply_lanes_avx2(load_pixels_avx2(pixels + i + 2));
+    auto const p45 = unpremultiply_lanes_avx2(load_pixels_avx2(pixels + i + 4));
+    auto const p67 = unpremultiply_lanes_avx2(load_pixels_avx2(pixels + i + 6));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), pack_pixels_avx2(p01, p23, p45, p67));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto premultiply_avx2(Color4f* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto*       data = reinterpret_cast<float*>(pixels);
+  std::size_t i    = 0;
+  for (; i + 2 <= count; i += 2, data += 8) {
+    auto const value = _mm256_loadu_ps(data);
+    auto const alpha = _mm256_permute_ps(value, 0xFF);
+    _mm256_storeu_ps(data, _mm256_blend_ps(_mm256_mul_ps(value, alpha), value, 0x88));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto unpremultiply_avx2(Color4f* pixels, std::size_t count) noexcept -> std::size_t
+{
+  auto*       data = reinterpret_cast<float*>(pixels);
+  std::size_t i    = 0;
+  for (; i + 2 <= count; i += 2, data += 8) {
+    auto const value = _mm256_loadu_ps(data);
+    auto const alpha = _mm256_permute_ps(value, 0xFF);
+    auto const valid = _mm256_cmp_ps(alpha, _mm256_setzero_ps(), _CMP_GT_OQ);
+    auto const color = _mm256_and_ps(_mm256_div_ps(value, alpha), valid);
+    _mm256_storeu_ps(data, _mm256_blend_ps(color, value, 0x88));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto srgb_to_linear_avx2(Color4u const* in, Color4f* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const& tables = srgb_tables();
+  auto*       dst    = reinterpret_cast<float*>(out);
+  std::size_t i      = 0;
+  for (; i + 2 <= count; i += 2, dst += 8) {
+    auto const bytes = load_pixels_avx2(in + i);
+    auto const color = _mm256_i32gather_ps(tables.to_linear.data(), bytes, 4);
+    auto const alpha = _mm256_div_ps(_mm256_cvtepi32_ps(bytes), _mm256_set1_ps(255.0f));
+    _mm256_storeu_ps(dst, _mm256_blend_ps(color, alpha, 0x88));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto linear_to_srgb_lanes_avx2(SrgbTables const& tables, __m256 value) noexcept -> __m256i
+{
+  auto const alpha = float_to_byte_lanes_avx2(value);
+
+  auto const x      = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+  auto const scaled = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(float(SrgbTables::BUCKETS))));
+  auto const q      = _mm256_min_epi32(scaled, _mm256_set1_epi32(SrgbTables::BUCKETS - 1));
+  auto const b      = _mm256_i32gather_epi32(tables.bucket.data(), q, 4);
+  auto const next   = _mm256_i32gather_ps(tables.threshold.data() + 1, b, 4);
+  // The comparison mask is -1 for the lanes at or above the next threshold.
+  auto const color = _mm256_sub_epi32(b, _mm256_castps_si256(_mm256_cmp_ps(x, next, _CMP_GE_OQ)));
+
+  return _mm256_blend_epi32(color, alpha, 0x88);
+}
+
+UBYTES_TARGET_AVX2 inline auto linear_to_srgb_avx2(Color4f const* in, Color4u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const& tables = srgb_tables();
+  auto const* src    = reinterpret_cast<float const*>(in);
+  std::size_t i      = 0;
+  for (; i + 8 <= count; i += 8, src += 32) {
+    auto const p01 = linear_to_srgb_lanes_avx2(tables, _mm256_loadu_ps(src));
+    auto const p23 = linear_to_srgb_lanes_avx2(tables, _mm256_loadu_ps(src + 8));
+    auto const p45 = linear_to_srgb_lanes_avx2(tables, _mm256_loadu_ps(src + 16));
+    auto const p67 = linear_to_srgb_lanes_avx2(tables, _mm256_loadu_ps(src + 24));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pack_pixels_avx2(p01, p23, p45, p67));
+  }
+  return i;
+}
+
+UBYTES_TARGET_AVX2 inline auto rgb_to_rgba_avx2(Color3u const* in, Color4u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const expand = _mm256_setr_epi8(
+    0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+  );
+  auto const alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+  // Two 16-byte loads 12 bytes apart, the second one reads 4 bytes past the 8 pixels.
+  std::size_t i = 0;
+  for (; i + 10 <= count; i += 8) {
+    auto const lo    = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+    auto const hi    = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i + 4));
+    auto const block = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(_mm256_shuffle_epi8(block, expand), alpha)
+    );
+  }
+  return i + rgb_to_rgba_sse41(in + i, out + i, count - i);
+}
+
+UBYTES_TARGET_AVX2 inline auto rgba_to_rgb_avx2(Color4u const* in, Color3u* out, std::size_t count) noexcept
+  -> std::size_t
+{
+  auto const pack = _mm256_setr_epi8(
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+  );
+
+  // Stores 32 bytes, 24 valid.
+  std::size_t i = 0;
+  for (; i + 11 <= count; i += 8) {
+    auto const block  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+    auto const packed = _mm256_shuffle_epi8(block, pack);
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(out + i),
+      _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7))
+    );
+  }
+  return i + rgba_to_rgb_sse41(in + i, out + i, count - i);
+}
+
+#endif
+
+} // namespace details
+
+/// Converts float colors (0 - 1) to bytes, rounding to nearest. Out of range values are clamped.
+inline auto convert_colors(std::span<Color4f const> in, std::span<Color4u> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::floats_to_bytes_avx2(in.data(), out.data(), count);
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::floats_to_bytes_sse41(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::floats_to_bytes_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+/// Converts byte colors to floats (0 - 1).
+inline auto convert_colors(std::span<Color4u const> in, std::span<Color4f> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::bytes_to_floats_avx2(in.data(), out.data(), count);
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::bytes_to_floats_sse41(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::bytes_to_floats_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+/// Converts RGB colors to opaque RGBA colors.
+inline auto convert_colors(std::span<Color3u const> in, std::span<Color4u> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::rgb_to_rgba_avx2(in.data(), out.data(), count);
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::rgb_to_rgba_sse41(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::rgb_to_rgba_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+/// Converts RGBA colors to RGB, dropping the alpha channel.
+inline auto convert_colors(std::span<Color4u const> in, std::span<Color3u> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::rgba_to_rgb_avx2(in.data(), out.data(), count);
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::rgba_to_rgb_sse41(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::rgba_to_rgb_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+/// Multiplies the color channels by alpha, in place. Rounds to nearest.
+inline auto premultiply_alpha(std::span<Color4u> pixels, SimdLevel level = simd_level()) noexcept -> void
+{
+  std::size_t done = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::premultiply_avx2(pixels.data(), pixels.size());
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::premultiply_sse41(pixels.data(), pixels.size());
+  }
+#else
+  (void)level;
+#endif
+  details::premultiply_scalar(pixels.data() + done, pixels.size() - done);
+}
+
+/// Multiplies the color channels by alpha, in place.
+inline auto premultiply_alpha(std::span<Color4f> pixels, SimdLevel level = simd_level()) noexcept -> void
+{
+  std::size_t done = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::premultiply_avx2(pixels.data(), pixels.size());
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::premultiply_sse41(pixels.data(), pixels.size());
+  }
+#else
+  (void)level;
+#endif
+  details::premultiply_scalar(pixels.data() + done, pixels.size() - done);
+}
+
+/// Divides the color channels by alpha, in place. Fully transparent pixels become transparent black.
+inline auto unpremultiply_alpha(std::span<Color4u> pixels, SimdLevel level = simd_level()) noexcept -> void
+{
+  std::size_t done = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::unpremultiply_avx2(pixels.data(), pixels.size());
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::unpremultiply_sse41(pixels.data(), pixels.size());
+  }
+#else
+  (void)level;
+#endif
+  details::unpremultiply_scalar(pixels.data() + done, pixels.size() - done);
+}
+
+/// Divides the color channels by alpha, in place. Pixels without a positive alpha get black color channels.
+inline auto unpremultiply_alpha(std::span<Color4f> pixels, SimdLevel level = simd_level()) noexcept -> void
+{
+  std::size_t done = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::unpremultiply_avx2(pixels.data(), pixels.size());
+  }
+  else if (level == SimdLevel::SSE41) {
+    done = details::unpremultiply_sse41(pixels.data(), pixels.size());
+  }
+#else
+  (void)level;
+#endif
+  details::unpremultiply_scalar(pixels.data() + done, pixels.size() - done);
+}
+
+/// Decodes sRGB byte colors to linear floats. Alpha is linear and only scaled to 0 - 1.
+/// @note Vectorized with AVX2 (gathers), the other levels use the scalar lookup.
+inline auto srgb_to_linear(std::span<Color4u const> in, std::span<Color4f> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::srgb_to_linear_avx2(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::srgb_to_linear_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+/// Encodes linear float colors to sRGB bytes, correctly rounded. Alpha is converted linearly.
+/// @note Vectorized with AVX2 (gathers), the other levels use the scalar lookup.
+inline auto linear_to_srgb(std::span<Color4f const> in, std::span<Color4u> out, SimdLevel level = simd_level()) noexcept
+  -> void
+{
+  auto const  count = std::min(in.size(), out.size());
+  std::size_t done  = 0;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    done = details::linear_to_srgb_avx2(in.data(), out.data(), count);
+  }
+#else
+  (void)level;
+#endif
+  details::linear_to_srgb_scalar(in.data() + done, out.data() + done, count - done);
+}
+
+} // namespace app_platform
+} // namespace ubytes
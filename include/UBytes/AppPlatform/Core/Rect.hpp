@@ -1,16 +1,137 @@
 #pragma once
 
+#include <UBytes/AppPlatform/Core/Vec2.hpp>
+
+#include <algorithm>
 #include <cinttypes>
+#include <type_traits>
 
 namespace ubytes
 {
 namespace app_platform
 {
 
+/// An axis-aligned rectangle: the position of its top-left corner and its size.
+/// The right and bottom edges are exclusive, so rectangles that share an edge do not overlap.
 template <typename T>
 struct Rect2Base
 {
   T x, y, w, h;
+
+  /// Constructs a rectangle from its edges, empty if `right < left` or `bottom < top`.
+  static constexpr auto from_edges(T left, T top, T right, T bottom) noexcept -> Rect2Base
+  {
+    return Rect2Base{left, top, right > left ? T(right - left) : T(), bottom > top ? T(bottom - top) : T()};
+  }
+
+  /// Constructs a rectangle from its position and size.
+  static constexpr auto from_position_size(Vec2<T> position, Vec2<T> size) noexcept -> Rect2Base
+  {
+    return Rect2Base{position.x, position.y, size.x, size.y};
+  }
+
+  constexpr auto left() const noexcept -> T
+  {
+    return x;
+  }
+
+  constexpr auto top() const noexcept -> T
+  {
+    return y;
+  }
+
+  constexpr auto right() const noexcept -> T
+  {
+    return T(x + w);
+  }
+
+  constexpr auto bottom() const noexcept -> T
+  {
+    return T(y + h);
+  }
+
+  constexpr auto position() const noexcept -> Vec2<T>
+  {
+    return Vec2<T>(x, y);
+  }
+
+  constexpr auto size() const noexcept -> Vec2<T>
+  {
+    return Vec2<T>(w, h);
+  }
+
+  /// Returns true if the rectangle has no area.
+  constexpr auto is_empty() const noexcept -> bool
+  {
+    return !(w > T()) || !(h > T());
+  }
+
+  /// Returns true if the point is inside the rectangle (the right and bottom edges are outside).
+  constexpr auto contains(Vec2<T> point) const noexcept -> bool
+  {
+    return point.x >= x && point.y >= y && point.x < right() && point.y < bottom();
+  }
+
+  /// Returns true if `other` is non-empty and entirely inside the rectangle.
+  constexpr auto contains(Rect2Base const& other) const noexcept -> bool
+  {
+    return !other.is_empty() && other.x >= x && other.y >= y && other.right() <= right() &&
+           other.bottom() <= bottom();
+  }
+
+  /// Returns true if the rectangles overlap.
+  constexpr auto intersects(Rect2Base const& other) const noexcept -> bool
+  {
+    return !intersect(other).is_empty();
+  }
+
+  /// Returns the overlap of the rectangles, an empty rectangle if they don't overlap.
+  constexpr auto intersect(Rect2Base const& other) const noexcept -> Rect2Base
+  {
+    return from_edges(
+      std::max(x, other.x), std::max(y, other.y), std::min(right(), other.right()), std::min(bottom(), other.bottom())
+    );
+  }
+
+  /// Returns the smallest rectangle that contains both rectangles. Empty rectangles are ignored.
+  constexpr auto unite(Rect2Base const& other) const noexcept -> Rect2Base
+  {
+    if (other.is_empty()) {
+      return *this;
+    }
+    if (is_empty()) {
+      return other;
+    }
+    return from_edges(
+      std::min(x, other.x), std::min(y, other.y), std::max(right(), other.right()), std::max(bottom(), other.bottom())
+    );
+  }
+
+  /// Returns the rectangle clipped to `bounds`, the same as `intersect(bounds)`.
+  constexpr auto clip(Rect2Base const& bounds) const noexcept -> Rect2Base
+  {
+    return intersect(bounds);
+  }
+
+  /// Returns the point of the rectangle closest to `point`. The rectangle must not be empty.
+  /// Integer points are clamped to the last pixel inside, floating-point ones to the edge.
+  constexpr auto clip(Vec2<T> point) const noexcept -> Vec2<T>
+  {
+    if constexpr (std::is_integral_v<T>) {
+      return Vec2<T>(std::clamp(point.x, x, T(right() - 1)), std::clamp(point.y, y, T(bottom() - 1)));
+    }
+    else {
+      return Vec2<T>(std::clamp(point.x, x, right()), std::clamp(point.y, y, bottom()));
+    }
+  }
+
+  /// Returns the rectangle moved by `offset`.
+  constexpr auto translated(Vec2<T> offset) const noexcept -> Rect2Base
+  {
+    return Rect2Base{T(x + offset.x), T(y + offset.y), w, h};
+  }
+
+  friend constexpr auto operator==(Rect2Base const& a, Rect2Base const& b) noexcept -> bool = default;
 };
 
 using Rect2f = Rect2Base<float>;
@@ -18,4 +139,4 @@ using Rect2i = Rect2Base<std::int32_t>;
 using Rect2u = Rect2Base<std::uint32_t>;
 
 } // namespace app_platform
-} // namespace ubytes
\ No newline at end of file
+} // namespace ubytes
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Rect.hpp>
+#include <UBytes/AppPlatform/Core/Vec2.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A set of points made of rectangles, e.g. the draggable parts of a borderless window.
+///
+/// The rectangles are normalized into bands: horizontal strips in which the region is the
+/// same sorted list of disjoint x-intervals (like `HRGN`s and X11 regions). Hit-testing is
+/// two binary searches, `O(log bands + log intervals)`, whatever the number of rectangles
+/// the region was built from. `add()` and `subtract()` only rebuild the bands they overlap.
+///
+/// ```cpp
+/// auto drag = Region2i(drag_rects);  // The title bar, the tab strip, ...
+/// drag.subtract(close_button);       // ... minus the no-drag parts.
+/// if (drag.contains(cursor)) {
+///   return HTCAPTION;
+/// }
+/// ```
+template <typename T>
+class RegionBase
+{
+public:
+  using Rect  = Rect2Base<T>;
+  using Point = Vec2<T>;
+
+  RegionBase() = default;
+
+  /// Constructs the union of the rectangles.
+  explicit RegionBase(std::span<Rect const> rects)
+  {
+    assign(rects);
+  }
+
+  /// Replaces the region with the union of the rectangles.
+  auto assign(std::span<Rect const> rects) -> void
+  {
+    clear();
+
+    // Sweep the distinct horizontal edges: between two of them every rectangle either covers
+    // the whole strip or none of it.
+    auto edges = std::vector<T>();
+    edges.reserve(rects.size() * 2);
+    for (auto const& rect : rects) {
+      if (!rect.is_empty()) {
+        edges.push_back(rect.top());
+        edges.push_back(rect.bottom());
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    auto spans  = std::vector<std::pair<T, T>>();
+    auto merged = std::vector<T>();
+    for (std::size_t i = 0; i + 1 < edges.size(); ++i) {
+      auto const top    = edges[i];
+      auto const bottom = edges[i + 1];
+
+      spans.clear();
+      for (auto const& rect : rects) {
+        if (!rect.is_empty() && rect.top() <= top && rect.bottom() >= bottom) {
+          spans.emplace_back(rect.left(), rect.right());
+        }
+      }
+      std::sort(spans.begin(), spans.end());
+
+      merged.clear();
+      for (auto const& [left, right] : spans) {
+        if (!merged.empty() && left <= merged.back()) {
+          merged.back() = std::max(merged.back(), right);
+        }
+        else {
+          merged.push_back(left);
+          merged.push_back(right);
+        }
+      }
+      append_band(_bands, _xs, top, bottom, merged);
+    }
+  }
+
+  /// Adds the points of `rect` to the region.
+  auto add(Rect const& rect) -> void
+  {
+    combine(rect, true);
+  }
+
+  /// Removes the points of `rect` from the region.
+  auto subtract(Rect const& rect) -> void
+  {
+    combine(rect, false);
+  }
+
+  auto clear() noexcept -> void
+  {
+    _bands.clear();
+    _xs.clear();
+  }
+
+  auto empty() const noexcept -> bool
+  {
+    return _bands.empty();
+  }
+
+  /// Returns true if the point is in the region.
+  auto contains(Point point) const noexcept -> bool
+  {
+    // The last band starting at or above the point.
+    auto const band = std::upper_bound(
+      _bands.begin(),
+      _bands.end(),
+      point.y,
+      [](T y, Band const& band)
+      {
+        return y < band.top;
+      }
+    );
+    if (band == _bands.begin() || !(point.y < std::prev(band)->bottom)) {
+      return false;
+    }
+
+    // The interval edges alternate left/right: the point is inside if an odd number of them is at or before it.
+    auto const first = _xs.begin() + std::prev(band)->begin;
+    auto const last  = _xs.begin() + std::prev(band)->end;
+    return (std::upper_bound(first, last, point.x) - first) % 2 == 1;
+  }
+
+  /// Returns the smallest rectangle containing the region.
+  auto bounds() const noexcept -> Rect
+  {
+    if (_bands.empty()) {
+      return Rect();
+    }
+    auto left  = _xs[_bands.front().begin];
+    auto right = _xs[_bands.front().end - 1];
+    for (auto const& band : _bands) {
+      left  = std::min(left, _xs[band.begin]);
+      right = std::max(right, _xs[band.end - 1]);
+    }
+    return Rect::from_edges(left, _bands.front().top, right, _bands.back().bottom);
+  }
+
+  /// Returns the region as disjoint rectangles, one per interval of every band.
+  auto rects() const -> std::vector<Rect>
+  {
+    auto result = std::vector<Rect>();
+    result.reserve(_xs.size() / 2);
+    for (auto const& band : _bands) {
+      for (auto i = band.begin; i < band.end; i += 2) {
+        result.push_back(Rect::from_edges(_xs[i], band.top, _xs[i + 1], band.bottom));
+      }
+    }
+    return result;
+  }
+
+  /// Returns the number of bands, for diagnostics.
+  auto band_count() const noexcept -> std::size_t
+  {
+    return _bands.size();
+  }
+
+private:
+  struct Band
+  {
+    T top;
+    T bottom;
+    /// The range of `_xs` holding the left and right edges of the intervals.
+    std::uint32_t begin;
+    std::uint32_t end;
+  };
+
+  /// Appends a band, or extends the last one if it is adjacent and has the same intervals.
+  static auto append_band(std::vector<Band>& bands, std::vector<T>& xs, T top, T bottom, std::span<T const> intervals)
+    -> void
+  {
+    if (intervals.empty() || !(top < bottom)) {
+      return;
+    }
+    if (!bands.empty()) {
+      auto&      last = bands.back();
+      auto const same = std::equal(xs.begin() + last.begin, xs.begin() + last.end, intervals.begin(), intervals.end());
+      if (last.bottom == top && same) {
+        last.bottom = bottom;
+        return;
+      }
+    }
+    auto const begin = static_cast<std::uint32_t>(xs.size());
+    xs.insert(xs.end(), intervals.begin(), intervals.end());
+    bands.push_back(Band{top, bottom, begin, static_cast<std::uint32_t>(xs.size())});
+  }
+
+  /// Writes the intervals of a band with `[left, right)` added or removed.
+  static auto combine_intervals(std::span<T const> xs, T left, T right, bool add, std::vector<T>& out) -> void
+  {
+    out.clear();
+    if (add) {
+      auto pending = true;
+      for (std::size_t i = 0; i < xs.size(); i += 2) {
+        if (xs[i + 1] < left) {
+          out.push_back(xs[i]);
+          out.push_back(xs[i + 1]);
+        }
+        else if (right < xs[i]) {
+          if (pending) {
+            out.push_back(left);
+            out.push_back(right);
+            pending = false;
+          }
+          out.push_back(xs[i]);
+          out.push_back(xs[i + 1]);
+        }
+        else {
+          left  = std::min(left, xs[i]);
+          right = std::max(right, xs[i + 1]);
+        }
+      }
+      if (pending) {
+        out.push_back(left);
+        out.push_back(right);
+      }
+      return;
+    }
+
+    for (std::size_t i = 0; i < xs.size(); i += 2) {
+      if (!(left < xs[i + 1]) || !(xs[i] < right)) {
+        out.push_back(xs[i]);
+        out.push_back(xs[i + 1]);
+        continue;
+      }
+      if (xs[i] < left) {
+        out.push_back(xs[i]);
+        out.push_back(left);
+      }
+      if (right < xs[i + 1]) {
+        out.push_back(right);
+        out.push_back(xs[i + 1]);
+      }
+    }
+  }
+
+  auto combine(Rect const& rect, bool add) -> void
+  {
+    if (rect.is_empty() || (!add && _bands.empty())) {
+      return;
+    }
+    auto const top    = rect.top();
+    auto const bottom = rect.bottom();
+
+    // The bands overlapping the rectangle, plus one on each side so that the rebuilt
+    // bands can be merged with their neighbours.
+    auto first = static_cast<std::size_t>(
+      std::lower_bound(
+        _bands.begin(),
+        _bands.end(),
+        top,
+        [](Band const& band, T y)
+        {
+          return !(y < band.bottom);
+        }
+      ) -
+      _bands.begin()
+    );
+    auto last = first;
+    while (last < _bands.size() && _bands[last].top < bottom) {
+      ++last;
+    }
+    if (!add && first == last) {
+      return;
+    }
+    first -= first > 0 ? 1 : 0;
+    last += last < _bands.size() ? 1 : 0;
+
+    // Rebuild [first, last) into new bands, cutting them at the rectangle's edges.
+    auto& bands    = _scratch_bands;
+    auto& xs       = _scratch_xs;
+    auto& combined = _scratch_combined;
+    bands.clear();
+    xs.clear();
+
+    auto const cut = [&](T from, T to, std::span<T const> intervals)
+    {
+      // The parts of [from, to) above, inside and below the rectangle.
+      auto const inside_top    = std::max(from, top);
+      auto const inside_bottom = std::min(to, bottom);
+      if (!(inside_top < inside_bottom)) {
+        append_band(bands, xs, from, to, intervals);
+        return;
+      }
+      append_band(bands, xs, from, inside_top, intervals);
+      combine_intervals(intervals, rect.left(), rect.right(), add, combined);
+      append_band(bands, xs, inside_top, inside_bottom, combined);
+      append_band(bands, xs, inside_bottom, to, intervals);
+    };
+
+    auto y = first < last ? std::min(top, _bands[first].top) : top;
+    for (auto i = first; i < last; ++i) {
+      auto const& band      = _bands[i];
+      auto const  intervals = std::span<T const>(_xs.data() + band.begin, band.end - band.begin);
+      if (y < band.top) {
+        cut(y, band.top, {}); // The gap above the band.
+      }
+      cut(band.top, band.bottom, intervals);
+      y = band.bottom;
+    }
+    if (y < bottom) {
+      cut(y, bottom, {});
+    }
+
+    splice(first, last, bands, xs);
+  }
+
+  /// Replaces the bands [first, last) and their intervals.
+  auto splice(std::size_t first, std::size_t last, std::vector<Band>& bands, std::vector<T> const& xs) -> void
+  {
+    // The range is empty only when the region is, and then so is `_xs`.
+    auto const xs_begin = first < last ? _bands[first].begin : std::uint32_t(0);
+    auto const xs_end   = first < last ? _bands[last - 1].end : std::uint32_t(0);
+    auto const delta    = static_cast<std::int64_t>(xs.size()) - static_cast<std::int64_t>(xs_end - xs_begin);
+
+    _xs.erase(_xs.begin() + xs_begin, _xs.begin() + xs_end);
+    _xs.insert(_xs.begin() + xs_begin, xs.begin(), xs.end());
+
+    for (auto& band : bands) {
+      band.begin += xs_begin;
+      band.end += xs_begin;
+    }
+    for (auto i = last; i < _bands.size(); ++i) {
+      _bands[i].begin = static_cast<std::uint32_t>(_bands[i].begin + delta);
+      _bands[i].end   = static_cast<std::uint32_t>(_bands[i].end + delta);
+    }
+    _bands.erase(_bands.begin() + first, _bands.begin() + last);
+    _bands.insert(_bands.begin() + first, bands.begin(), bands.end());
+  }
+
+  std::vector<Band> _bands;
+  std::vector<T>    _xs;
+
+  // Reused by `add()` and `subtract()`, which then allocate only when the region grows.
+  std::vector<Band> _scratch_bands;
+  std::vector<T>    _scratch_xs;
+  std::vector<T>    _scratch_combined;
+};
+
+using Region2i = RegionBase<std::int32_t>;
+using Region2f = RegionBase<float>;
+
+} // namespace app_platform
+} // namespace ubytes
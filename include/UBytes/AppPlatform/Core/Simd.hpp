@@ -0,0 +1,105 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define UBYTES_APP_PLATFORM_X86 1
+#else
+#define UBYTES_APP_PLATFORM_X86 0
+#endif
+
+#if UBYTES_APP_PLATFORM_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+/// Marks a function as compiled for a specific instruction set, so that it can be
+/// selected at runtime without compiling the whole project with e.g. `-mavx2`.
+/// MSVC allows intrinsics everywhere, so the attribute is not needed there.
+#if defined(__GNUC__) || defined(__clang__)
+#define UBYTES_TARGET(isa) __attribute__((target(isa)))
+#else
+#define UBYTES_TARGET(isa)
+#endif
+
+#define UBYTES_TARGET_SSE41 UBYTES_TARGET("sse4.1")
+#define UBYTES_TARGET_AVX2  UBYTES_TARGET("avx2")
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// The instruction set used by vectorized kernels.
+enum class SimdLevel
+{
+  Scalar = 0,
+  SSE41,
+  AVX2,
+};
+
+namespace details
+{
+
+inline auto detect_simd_level() noexcept -> SimdLevel
+{
+#if UBYTES_APP_PLATFORM_X86
+  unsigned int regs[4] = {};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  __cpuid(reinterpret_cast<int*>(regs), 1);
+#else
+  __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+  bool const sse41   = (regs[2] & (1u << 19)) != 0;
+  bool const osxsave = (regs[2] & (1u << 27)) != 0;
+  bool const avx     = (regs[2] & (1u << 28)) != 0;
+
+  if (!sse41) {
+    return SimdLevel::Scalar;
+  }
+
+  if (!osxsave || !avx) {
+    return SimdLevel::SSE41;
+  }
+
+  // The OS has to save the YMM registers on context switch.
+#if defined(_MSC_VER) && !defined(__clang__)
+  auto const xcr0 = static_cast<unsigned long long>(_xgetbv(0));
+#else
+  unsigned int xcr0_lo = 0, xcr0_hi = 0;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  auto const xcr0 = (static_cast<unsigned long long>(xcr0_hi) << 32) | xcr0_lo;
+#endif
+  if ((xcr0 & 0x6) != 0x6) {
+    return SimdLevel::SSE41;
+  }
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  __cpuidex(reinterpret_cast<int*>(regs), 7, 0);
+#else
+  __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+  bool const avx2 = (regs[1] & (1u << 5)) != 0;
+
+  return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE41;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+} // namespace details
+
+/// Returns the best instruction set supported by the current CPU.
+/// @note The detection runs once, the result is cached.
+inline auto simd_level() noexcept -> SimdLevel
+{
+  static auto const level = details::detect_simd_level();
+  return level;
+}
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+namespace details
+{
+
+/// Recycles coroutine frames: per-thread free lists of 64-byte size classes.
+///
+/// A coroutine frame is allocated once per call, not per await, and with this
+/// allocator a steady stream of calls reuses the same few blocks.
+/// Blocks may be freed on another thread than the one that allocated them.
+class FrameAllocator
+{
+public:
+  static constexpr std::size_t GRANULARITY = 64;
+  static constexpr std::size_t CLASSES     = 64;
+  static constexpr std::size_t MAX_CACHED  = 64;
+
+  static auto allocate(std::size_t size) -> void*
+  {
+    auto const index = size_class(size);
+    if (index < CLASSES) {
+      auto& list = local().lists[index];
+      if (list.head) {
+        auto* block = list.head;
+        list.head   = block->next;
+        --list.count;
+        return block + 1;
+      }
+    }
+
+    auto const capacity = index < CLASSES ? (index + 1) * GRANULARITY : size;
+    auto*      block    = static_cast<Header*>(::operator new(sizeof(Header) + capacity));
+    block->size_class = index;
+    return block + 1;
+  }
+
+  static auto deallocate(void* pointer) noexcept -> void
+  {
+    auto* block = static_cast<Header*>(pointer) - 1;
+    if (block->size_class < CLASSES) {
+      auto& list = local().lists[block->size_class];
+      if (list.count < MAX_CACHED) {
+        block->next = list.head;
+        list.head   = block;
+        ++list.count;
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+private:
+  /// Precedes every block, keeps the frame aligned like `operator new` does.
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header
+  {
+    std::size_t size_class;
+    Header*     next;
+  };
+
+  struct FreeList
+  {
+    Header*     head  = nullptr;
+    std::size_t count = 0;
+  };
+
+  struct Cache
+  {
+    FreeList lists[CLASSES];
+
+    ~Cache()
+    {
+      for (auto& list : lists) {
+        while (list.head) {
+          ::operator delete(std::exchange(list.head, list.head->next));
+        }
+      }
+    }
+  };
+
+  static auto size_class(std::size_t size) noexcept -> std::size_t
+  {
+    // Sizes above the largest class get `CLASSES` (or more) and bypass the cache.
+    return size == 0 ? 0 : (size - 1) / GRANULARITY;
+  }
+
+  static auto local() -> Cache&
+  {
+    thread_local auto cache = Cache();
+    return cache;
+  }
+};
+
+/// Allocates the frames of the coroutines of this library through `FrameAllocator`.
+struct FrameAllocated
+{
+  static auto operator new(std::size_t size) -> void*
+  {
+    return FrameAllocator::allocate(size);
+  }
+
+  static auto operator delete(void* pointer) noexcept -> void
+  {
+    FrameAllocator::deallocate(pointer);
+  }
+};
+
+template <typename T>
+class TaskPromise;
+
+/// Resumes the awaiting coroutine when a task finishes (symmetric transfer, no stack growth).
+template <typename T>
+struct TaskFinalAwaiter
+{
+  auto await_ready() const noexcept -> bool
+  {
+    return false;
+  }
+
+  auto await_suspend(std::coroutine_handle<TaskPromise<T>> handle) const noexcept -> std::coroutine_handle<>
+  {
+    auto continuation = handle.promise().continuation;
+    return continuation ? continuation : std::noop_coroutine();
+  }
+
+  auto await_resume() const noexcept -> void
+  {
+  }
+};
+
+template <typename T>
+class TaskPromiseBase : public FrameAllocated
+{
+public:
+  std::coroutine_handle<> continuation;
+
+  auto initial_suspend() const noexcept -> std::suspend_always
+  {
+    return {};
+  }
+
+  auto final_suspend() const noexcept -> TaskFinalAwaiter<T>
+  {
+    return {};
+  }
+
+  auto unhandled_exception() const noexcept -> void
+  {
+    std::terminate();
+  }
+};
+
+template <typename T>
+class TaskPromise final : public TaskPromiseBase<T>
+{
+public:
+  auto get_return_object() noexcept -> std::coroutine_handle<TaskPromise>
+  {
+    return std::coroutine_handle<TaskPromise>::from_promise(*this);
+  }
+
+  template <typename U>
+  auto return_value(U&& value) -> void
+  {
+    result.emplace(std::forward<U>(value));
+  }
+
+  std::optional<T> result;
+};
+
+template <>
+class TaskPromise<void> final : public TaskPromiseBase<void>
+{
+public:
+  auto get_return_object() noexcept -> std::coroutine_handle<TaskPromise>
+  {
+    return std::coroutine_handle<TaskPromise>::from_promise(*this);
+  }
+
+  auto return_void() const noexcept -> void
+  {
+  }
+};
+
+/// The coroutine behind `spawn()`: starts eagerly and frees itself when done.
+struct DetachedTask
+{
+  struct promise_type : FrameAllocated
+  {
+    auto get_return_object() const noexcept -> DetachedTask
+    {
+      return {};
+    }
+
+    auto initial_suspend() const noexcept -> std::suspend_never
+    {
+      return {};
+    }
+
+    auto final_suspend() const noexcept -> std::suspend_never
+    {
+      return {};
+    }
+
+    auto return_void() const noexcept -> void
+    {
+    }
+
+    auto unhandled_exception() const noexcept -> void
+    {
+      std::terminate();
+    }
+  };
+};
+
+} // namespace details
+
+/// A lazily started coroutine returning `T`.
+///
+/// The task starts when awaited and resumes its awaiter when it finishes.
+/// Frames come from a recycling allocator and awaiting does not allocate:
+/// every awaiter of this library lives in the frame of the awaiting coroutine.
+///
+/// ```cpp
+/// auto load(WebView& webview, Window& window) -> Task<void>
+/// {
+///   co_await setup(webview, window);
+///   webview.navigate("https://app.local/index.html");
+/// }
+///
+/// spawn(load(webview, window));
+/// ```
+template <typename T = void>
+class [[nodiscard]] Task
+{
+public:
+  using promise_type = details::TaskPromise<T>;
+  using Handle       = std::coroutine_handle<promise_type>;
+
+  Task(Handle handle) noexcept
+    : _handle(handle)
+  {
+  }
+
+  Task(Task&& other) noexcept
+    : _handle(std::exchange(other._handle, nullptr))
+  {
+  }
+
+  auto operator=(Task&& other) noexcept -> Task&
+  {
+    if (this != &other) {
+      if (_handle) {
+        _handle.destroy();
+      }
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+
+  Task(Task const&)                    = delete;
+  auto operator=(Task const&) -> Task& = delete;
+
+  ~Task()
+  {
+    if (_handle) {
+      _handle.destroy();
+    }
+  }
+
+  /// Returns true once the coroutine has run to completion.
+  auto done() const noexcept -> bool
+  {
+    return !_handle || _handle.done();
+  }
+
+  auto operator co_await() && noexcept
+  {
+    struct Awaiter
+    {
+      Handle handle;
+
+      auto await_ready() const noexcept -> bool
+      {
+        return !handle || handle.done();
+      }
+
+      auto await_suspend(std::coroutine_handle<> awaiting) const noexcept -> std::coroutine_handle<>
+      {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+
+      auto await_resume() const -> T
+      {
+        if constexpr (!std::is_void_v<T>) {
+          return std::move(*handle.promise().result);
+        }
+      }
+    };
+    return Awaiter{_handle};
+  }
+
+private:
+  Handle _handle;
+};
+
+/// Starts a task without waiting for it. The frame is freed when it finishes.
+inline auto spawn(Task<void> task) -> void
+{
+  [](Task<void> task) -> details::DetachedTask
+  {
+    co_await std::move(task);
+  }(std::move(task));
+}
+
+} // namespace app_platform
+} // namespace ubytes
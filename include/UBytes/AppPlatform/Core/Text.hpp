@@ -1,5 +1,8 @@
 #pragma once
 
+#include <UBytes/AppPlatform/Core/Utf.hpp>
+
+#include <span>
 #include <string_view>
 #include <string>
 
@@ -23,6 +26,43 @@ auto to_utf8_string(std::wstring_view wstr) -> std::string;
 /// @note The bytes or addresses are unaffected, only the type is changed.
 auto to_regular_sv(std::u8string_view str) -> std::string_view;
 
+// The converters above are compiled into the library. The inline ones below are for the
+// header-side code, with the vectorized `Utf.hpp` kernels and overloads that don't allocate.
+
+/// Converts a UTF-8 string to a UTF-16 (UTF-32 on non-Windows) string into a caller-provided buffer.
+/// Ill-formed sequences are replaced with U+FFFD.
+/// @note Does not allocate. `utf16_capacity_for_utf8(utf8str.size())` units are always enough.
+inline auto utf8_to_wstring(std::string_view utf8str, std::span<wchar_t> out) noexcept -> UtfResult
+{
+  return convert_utf8_to_wide(utf8str, out);
+}
+
+/// Converts a UTF-16 (UTF-32 on non-Windows) string to a UTF-8 string into a caller-provided buffer.
+/// Unpaired surrogates are replaced with U+FFFD.
+/// @note Does not allocate. `utf8_capacity_for_utf16(wstr.size())` bytes are always enough.
+inline auto wstring_to_utf8(std::wstring_view wstr, std::span<char> out) noexcept -> UtfResult
+{
+  return convert_wide_to_utf8(wstr, out);
+}
+
+/// Converts a UTF-8 string to a UTF-16 (UTF-32 on non-Windows) string.
+inline auto utf8_to_wstring(std::string_view utf8str) -> std::wstring
+{
+  auto result    = std::wstring(utf16_capacity_for_utf8(utf8str.size()), L'\0');
+  auto converted = utf8_to_wstring(utf8str, std::span<wchar_t>(result));
+  result.resize(converted.written);
+  return result;
+}
+
+/// Converts a UTF-16 (UTF-32 on non-Windows) string to a UTF-8 string.
+inline auto wstring_to_utf8(std::wstring_view wstr) -> std::string
+{
+  auto result    = std::string(utf8_capacity_for_utf16(wstr.size()), '\0');
+  auto converted = wstring_to_utf8(wstr, std::span<char>(result));
+  result.resize(converted.written);
+  return result;
+}
+
 } // namespace details
 } // namespace app_platform
-} // namespace ubytes
\ No newline at end of file
+} // namespace ubytes
@@ -0,0 +1,610 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// Define to 1 (see the `APP_PLATFORM_TRACING` CMake option) to record traces.
+/// When 0, the `UBYTES_TRACE_*` macros expand to nothing and their arguments are not evaluated.
+#ifndef UBYTES_APP_PLATFORM_TRACING
+#define UBYTES_APP_PLATFORM_TRACING 0
+#endif
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// The histograms recorded by the library.
+enum class TraceMetric
+{
+  /// The size of the messages sent to the page, in bytes.
+  SendSize,
+  /// The size of the messages received from the page, in bytes.
+  ReceiveSize,
+  /// The time messages spend queued before being sent, in nanoseconds.
+  MessageLatency,
+  /// The duration of the UI loop ticks (the UI queue drains), in nanoseconds.
+  LoopTick,
+
+  Count,
+};
+
+constexpr auto trace_metric_name(TraceMetric metric) noexcept -> std::string_view
+{
+  switch (metric) {
+  case TraceMetric::SendSize: return "send_size";
+  case TraceMetric::ReceiveSize: return "receive_size";
+  case TraceMetric::MessageLatency: return "message_latency_ns";
+  case TraceMetric::LoopTick: return "loop_tick_ns";
+  default: return "unknown";
+  }
+}
+
+/// A lock-free histogram with power-of-two buckets: bucket `i` counts the values
+/// in `[2^(i-1), 2^i)`, bucket 0 counts zeros.
+class TraceHistogram
+{
+public:
+  static constexpr std::size_t BUCKET_COUNT = 65;
+
+  auto record(std::uint64_t value) noexcept -> void
+  {
+    _buckets[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  auto count() const noexcept -> std::uint64_t
+  {
+    return _count.load(std::memory_order_relaxed);
+  }
+
+  auto sum() const noexcept -> std::uint64_t
+  {
+    return _sum.load(std::memory_order_relaxed);
+  }
+
+  auto max() const noexcept -> std::uint64_t
+  {
+    return _max.load(std::memory_order_relaxed);
+  }
+
+  /// Returns an upper bound of the given percentile (0-100): the end of its bucket.
+  auto percentile(double percent) const noexcept -> std::uint64_t
+  {
+    auto const total = count();
+    if (total == 0) {
+      return 0;
+    }
+
+    auto const rank = static_cast<std::uint64_t>(static_cast<double>(total) * percent / 100.0);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+      seen += _buckets[i].load(std::memory_order_relaxed);
+      if (seen > rank) {
+        return i == 0 ? 0 : std::min(max(), i >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << i) - 1);
+      }
+    }
+    return max();
+  }
+
+  auto reset() noexcept -> void
+  {
+    for (auto& bucket : _buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+  }
+
+  /// Writes `{"count":..,"sum":..,"max":..,"p50":..,"p90":..,"p99":..,"buckets":[..]}`.
+  auto write(JsonWriter& writer) const -> void
+  {
+    writer.begin_object();
+    writer.field("count", count());
+    writer.field("sum", sum());
+    writer.field("max", max());
+    writer.field("p50", percentile(50));
+    writer.field("p90", percentile(90));
+    writer.field("p99", percentile(99));
+    writer.key("buckets").begin_array();
+    auto last = BUCKET_COUNT;
+    while (last > 0 && _buckets[last - 1].load(std::memory_order_relaxed) == 0) {
+      --last;
+    }
+    for (std::size_t i = 0; i < last; ++i) {
+      writer.value(_buckets[i].load(std::memory_order_relaxed));
+    }
+    writer.end_array();
+    writer.end_object();
+  }
+
+private:
+  std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> _buckets = {};
+  std::atomic<std::uint64_t>                           _count   = 0;
+  std::atomic<std::uint64_t>                           _sum     = 0;
+  std::atomic<std::uint64_t>                           _max     = 0;
+};
+
+namespace details
+{
+
+struct TraceEvent
+{
+  enum Kind : std::uint32_t
+  {
+    Complete,
+    Instant,
+    Counter,
+  };
+
+  /// A string literal (only the pointer is stored).
+  char const*   name;
+  std::int64_t  start;
+  std::int64_t  value;
+  Kind          kind;
+  std::uint32_t reserved;
+};
+
+/// A single-producer, single-consumer ring of events, written by its thread only.
+struct alignas(64) TraceBuffer
+{
+  static constexpr std::size_t CAPACITY = 8192;
+
+  auto push(TraceEvent const& event) noexcept -> void
+  {
+    auto const head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= CAPACITY) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    _events[head & (CAPACITY - 1)] = event;
+    _head.store(head + 1, std::memory_order_release);
+  }
+
+  /// Consumes the recorded events. One consumer at a time.
+  template <typename Fn>
+  auto drain(Fn&& fn) -> void
+  {
+    auto const tail = _tail.load(std::memory_order_relaxed);
+    auto const head = _head.load(std::memory_order_acquire);
+    for (auto index = tail; index != head; ++index) {
+      fn(_events[index & (CAPACITY - 1)]);
+    }
+    _tail.store(head, std::memory_order_release);
+  }
+
+  std::uint32_t              thread_index = 0;
+  std::atomic<std::uint64_t> dropped      = 0;
+  /// Set once the thread has exited (or moved to another tracer): the ring can be reused.
+  std::atomic<bool> released = false;
+
+private:
+  std::array<TraceEvent, CAPACITY> _events;
+
+  alignas(64) std::atomic<std::uint64_t> _head = 0;
+  alignas(64) std::atomic<std::uint64_t> _tail = 0;
+};
+
+} // namespace details
+
+/// Collects spans, counters and histograms, and exports them as a Chrome trace.
+///
+/// Recording is lock-free: every thread writes to its own ring buffer (registered
+/// on the first event of the thread, and reused by a later thread once it exits).
+/// `collect()` moves the buffered events to the tracer, call it now and then (e.g. once
+/// per frame) so the rings don't overflow; events are dropped (and counted) when a ring
+/// is full. The tracer keeps the last `max_events` collected events, and the last
+/// `max_events` events sent by the page.
+///
+/// The export is a [trace-event](https://tinyurl.com/trace-event-format) JSON with
+/// timestamps in microseconds since the Unix epoch, the same time base as the page's
+/// `performance.timeOrigin + performance.now()`, so the events sent by `js/Trace.js`
+/// (see `receive()`) line up with the native ones in `chrome://tracing` or Perfetto.
+///
+/// @note Use the `UBYTES_TRACE_*` macros, they compile to nothing unless
+/// `UBYTES_APP_PLATFORM_TRACING` is enabled. Event names must be string literals.
+class Tracer
+{
+public:
+  static constexpr std::string_view TRACE_KEY = "__trace";
+
+  /// About 40 MiB of collected events.
+  static constexpr std::size_t DEFAULT_MAX_EVENTS = 1 << 20;
+
+  explicit Tracer(std::size_t max_events = DEFAULT_MAX_EVENTS)
+    : _generation(next_generation())
+    , _epoch_offset(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch() - std::chrono::steady_clock::now().time_since_epoch()
+        )
+          .count()
+      )
+    , _max_events(max_events)
+  {
+  }
+
+  Tracer(Tracer const&)                    = delete;
+  auto operator=(Tracer const&) -> Tracer& = delete;
+
+  /// Returns the current time in nanoseconds (steady clock).
+  static auto now() noexcept -> std::int64_t
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()
+    )
+      .count();
+  }
+
+  /// Records a span that started at `start` (see `now()`).
+  auto complete(char const* name, std::int64_t start, std::int64_t duration) -> void
+  {
+    buffer().push({name, start, duration, details::TraceEvent::Complete, 0});
+  }
+
+  auto instant(char const* name) -> void
+  {
+    buffer().push({name, now(), 0, details::TraceEvent::Instant, 0});
+  }
+
+  auto counter(char const* name, std::int64_t value) -> void
+  {
+    buffer().push({name, now(), value, details::TraceEvent::Counter, 0});
+  }
+
+  auto histogram(TraceMetric metric) noexcept -> TraceHistogram&
+  {
+    return _histograms[static_cast<std::size_t>(metric)];
+  }
+
+  /// Names the calling thread in the exported trace.
+  auto set_thread_name(std::string_view name) -> void
+  {
+    auto const index = buffer().thread_index;
+    auto       lock  = std::lock_guard(_mutex);
+    _thread_names.emplace_back(index, name);
+  }
+
+  /// Handles a message from the page: `{"__trace":[<trace events>]}`, discarding the
+  /// oldest page events beyond `max_events`.
+  /// @return true if it was a trace message.
+  auto receive(std::string_view message) -> bool
+  {
+    if (message.find(TRACE_KEY) == std::string_view::npos) {
+      return false;
+    }
+
+    auto lock = std::lock_guard(_mutex);
+    auto root = _reader.parse(message);
+    return root[TRACE_KEY].for_each_element(
+      [this](JsonValue event)
+      {
+        if (event.type() == JsonValue::Type::Object) {
+          _page_events.emplace_back(event.raw_json());
+          if (_page_events.size() > _max_events) {
+            _page_events.pop_front();
+            ++_dropped;
+          }
+        }
+        return true;
+      }
+    );
+  }
+
+  /// Moves the events recorded by all threads to the tracer, discarding the oldest
+  /// ones beyond `max_events`.
+  auto collect() -> void
+  {
+    auto lock = std::lock_guard(_mutex);
+    for (auto const& buffer : _buffers) {
+      drain(*buffer);
+    }
+  }
+
+  /// Returns the number of events dropped because a ring was full, or discarded
+  /// beyond `max_events`.
+  auto dropped() const -> std::uint64_t
+  {
+    auto lock = std::lock_guard(_mutex);
+
+    auto dropped = _dropped;
+    for (auto const& buffer : _buffers) {
+      dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+  }
+
+  /// Discards the collected events and resets the histograms.
+  auto clear() -> void
+  {
+    collect();
+
+    auto lock = std::lock_guard(_mutex);
+    _events.clear();
+    _page_events.clear();
+    for (auto& histogram : _histograms) {
+      histogram.reset();
+    }
+  }
+
+  /// Collects the events and writes the whole trace, with the histograms under `"histograms"`.
+  auto export_chrome_json(JsonWriter& writer) -> void
+  {
+    collect();
+
+    auto lock = std::lock_guard(_mutex);
+    writer.begin_object();
+    writer.key("traceEvents").begin_array();
+
+    for (auto const& [thread_index, name] : _thread_names) {
+      writer.begin_object();
+      writer.field("name", "thread_name");
+      writer.field("ph", "M");
+      writer.field("pid", PID);
+      writer.field("tid", thread_index);
+      writer.key("args").begin_object().field("name", std::string_view(name)).end_object();
+      writer.end_object();
+    }
+
+    for (auto const& [event, thread_index] : _events) {
+      writer.begin_object();
+      writer.field("name", event.name);
+      writer.field("pid", PID);
+      writer.field("tid", thread_index);
+      writer.field("ts", microseconds(event.start + _epoch_offset));
+      switch (event.kind) {
+      case details::TraceEvent::Complete:
+        writer.field("ph", "X");
+        writer.field("dur", microseconds(event.value));
+        break;
+      case details::TraceEvent::Instant:
+        writer.field("ph", "i");
+        writer.field("s", "t");
+        break;
+      case details::TraceEvent::Counter:
+        writer.field("ph", "C");
+        writer.key("args").begin_object().field("value", event.value).end_object();
+        break;
+      }
+      writer.end_object();
+    }
+
+    for (auto const& event : _page_events) {
+      writer.raw(event);
+    }
+    writer.end_array();
+
+    writer.field("displayTimeUnit", "ns");
+    writer.key("histograms").begin_object();
+    for (std::size_t i = 0; i < _histograms.size(); ++i) {
+      writer.key(trace_metric_name(static_cast<TraceMetric>(i)));
+      _histograms[i].write(writer);
+    }
+    writer.end_object();
+    writer.end_object();
+  }
+
+  auto export_chrome_json() -> std::string
+  {
+    auto writer = JsonWriter();
+    export_chrome_json(writer);
+    return std::string(writer.view());
+  }
+
+private:
+  /// The process id of the native events, the page uses another one.
+  static constexpr int PID = 1;
+
+  struct Collected
+  {
+    details::TraceEvent event;
+    std::uint32_t       thread_index;
+  };
+
+  static auto next_generation() noexcept -> std::uint64_t
+  {
+    static auto counter = std::atomic<std::uint64_t>(0);
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static auto microseconds(std::int64_t nanoseconds) noexcept -> double
+  {
+    return static_cast<double>(nanoseconds) / 1000.0;
+  }
+
+  /// Moves the events of a ring to `_events`. Call with `_mutex` locked.
+  auto drain(details::TraceBuffer& buffer) -> void
+  {
+    buffer.drain(
+      [&](details::TraceEvent const& event)
+      {
+        _events.push_back(Collected{event, buffer.thread_index});
+      }
+    );
+    while (_events.size() > _max_events) {
+      _events.pop_front();
+      ++_dropped;
+    }
+  }
+
+  /// Returns the ring of the calling thread, registering it on first use.
+  auto buffer() -> details::TraceBuffer&
+  {
+    /// Releases the ring of the thread when it exits, so that a later thread reuses it.
+    struct Cache
+    {
+      Cache() = default;
+
+      Cache(Cache const&)                    = delete;
+      auto operator=(Cache const&) -> Cache& = delete;
+
+      ~Cache()
+      {
+        release();
+      }
+
+      auto release() noexcept -> void
+      {
+        if (buffer) {
+          buffer->released.store(true, std::memory_order_release);
+        }
+      }
+
+      std::uint64_t                         generation = 0;
+      std::shared_ptr<details::TraceBuffer> buffer;
+    };
+    thread_local auto cache = Cache();
+
+    if (cache.generation != _generation) {
+      cache.release();
+      cache.buffer     = acquire_buffer();
+      cache.generation = _generation;
+    }
+    return *cache.buffer;
+  }
+
+  /// Returns the ring of an exited thread, emptied, or a new one.
+  auto acquire_buffer() -> std::shared_ptr<details::TraceBuffer>
+  {
+    auto lock  = std::lock_guard(_mutex);
+    auto found = std::find_if(
+      _buffers.begin(),
+      _buffers.end(),
+      [](std::shared_ptr<details::TraceBuffer> const& buffer)
+      {
+        return buffer->released.load(std::memory_order_acquire);
+      }
+    );
+    if (found == _buffers.end()) {
+      _buffers.push_back(std::make_shared<details::TraceBuffer>());
+      found = _buffers.end() - 1;
+    }
+    auto& buffer = **found;
+    drain(buffer);
+    _dropped += buffer.dropped.exchange(0, std::memory_order_relaxed);
+    buffer.released.store(false, std::memory_order_relaxed);
+    // A new id, the events already collected stay with the exited thread.
+    buffer.thread_index = ++_thread_count;
+    return *found;
+  }
+
+  std::uint64_t const _generation;
+  std::int64_t const  _epoch_offset;
+  std::size_t const   _max_events;
+
+  std::array<TraceHistogram, static_cast<std::size_t>(TraceMetric::Count)> _histograms;
+
+  mutable std::mutex                                 _mutex;
+  std::vector<std::shared_ptr<details::TraceBuffer>> _buffers;
+  std::vector<std::pair<std::uint32_t, std::string>> _thread_names;
+  std::deque<Collected>                              _events;
+  std::deque<std::string>                            _page_events;
+  JsonReader                                         _reader;
+  std::uint32_t                                      _thread_count = 0;
+  /// The events dropped by the reused rings, and discarded beyond `_max_events`.
+  std::uint64_t _dropped = 0;
+};
+
+/// Returns the tracer used by the `UBYTES_TRACE_*` macros.
+inline auto tracer() -> Tracer&
+{
+  static auto instance = Tracer();
+  return instance;
+}
+
+/// Records a span from its construction to its destruction,
+/// and optionally its duration in a histogram.
+class TraceScope
+{
+public:
+  explicit TraceScope(char const* name, Tracer& tracer = app_platform::tracer()) noexcept
+    : _tracer(tracer)
+    , _name(name)
+    , _start(Tracer::now())
+  {
+  }
+
+  TraceScope(char const* name, TraceMetric metric, Tracer& tracer = app_platform::tracer()) noexcept
+    : _tracer(tracer)
+    , _name(name)
+    , _metric(metric)
+    , _start(Tracer::now())
+  {
+  }
+
+  TraceScope(TraceScope const&)                    = delete;
+  auto operator=(TraceScope const&) -> TraceScope& = delete;
+
+  ~TraceScope()
+  {
+    auto const duration = Tracer::now() - _start;
+    _tracer.complete(_name, _start, duration);
+    if (_metric != TraceMetric::Count) {
+      _tracer.histogram(_metric).record(static_cast<std::uint64_t>(duration));
+    }
+  }
+
+private:
+  Tracer&      _tracer;
+  char const*  _name;
+  TraceMetric  _metric = TraceMetric::Count;
+  std::int64_t _start;
+};
+
+} // namespace app_platform
+} // namespace ubytes
+
+#define UBYTES_TRACE_CONCAT_IMPL(a, b) a##b
+#define UBYTES_TRACE_CONCAT(a, b) UBYTES_TRACE_CONCAT_IMPL(a, b)
+
+#if UBYTES_APP_PLATFORM_TRACING
+
+/// Records a span for the rest of the enclosing scope.
+#define UBYTES_TRACE_SCOPE(name) \
+  ::ubytes::app_platform::TraceScope UBYTES_TRACE_CONCAT(ubytes_trace_scope_, __LINE__)(name)
+
+/// Records a span for the rest of the enclosing scope and its duration in a `TraceMetric` histogram.
+#define UBYTES_TRACE_SCOPE_METRIC(name, metric) \
+  ::ubytes::app_platform::TraceScope UBYTES_TRACE_CONCAT(ubytes_trace_scope_, __LINE__)(name, metric)
+
+#define UBYTES_TRACE_INSTANT(name) ::ubytes::app_platform::tracer().instant(name)
+
+#define UBYTES_TRACE_COUNTER(name, value) \
+  ::ubytes::app_platform::tracer().counter(name, static_cast<std::int64_t>(value))
+
+/// Records a value in one of the `TraceMetric` histograms.
+#define UBYTES_TRACE_RECORD(metric, value) \
+  ::ubytes::app_platform::tracer().histogram(metric).record(static_cast<std::uint64_t>(value))
+
+#define UBYTES_TRACE_THREAD_NAME(name) ::ubytes::app_platform::tracer().set_thread_name(name)
+
+#else
+
+#define UBYTES_TRACE_SCOPE(name) ((void)0)
+#define UBYTES_TRACE_SCOPE_METRIC(name, metric) ((void)0)
+#define UBYTES_TRACE_INSTANT(name) ((void)0)
+#define UBYTES_TRACE_COUNTER(name, value) ((void)0)
+#define UBYTES_TRACE_RECORD(metric, value) ((void)0)
+#define UBYTES_TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
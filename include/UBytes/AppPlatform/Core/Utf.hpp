@@ -0,0 +1,704 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/Simd.hpp>
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Outcome of a UTF conversion into a caller-provided buffer.
+enum class UtfStatus
+{
+  Ok = 0,
+  /// The input contains an ill-formed sequence (only with `UtfErrors::Stop`).
+  InvalidSequence,
+  /// The output buffer is too small, `read` and `written` tell how far it got.
+  OutputTooSmall,
+};
+
+/// What to do with ill-formed input sequences.
+enum class UtfErrors
+{
+  /// Replace every maximal ill-formed subpart with U+FFFD (like the Win32 API does).
+  Replace,
+  /// Stop at the first ill-formed subpart and report `UtfStatus::InvalidSequence`.
+  Stop,
+};
+
+struct UtfResult
+{
+  UtfStatus   status  = UtfStatus::Ok;
+  /// Number of input code units consumed.
+  std::size_t read    = 0;
+  /// Number of output code units written.
+  std::size_t written = 0;
+};
+
+/// The output buffer size (in UTF-16 code units) that is always enough to convert `utf8_size` bytes.
+constexpr auto utf16_capacity_for_utf8(std::size_t utf8_size) noexcept -> std::size_t
+{
+  return utf8_size;
+}
+
+/// The output buffer size (in bytes) that is always enough to convert `utf16_size` code units.
+constexpr auto utf8_capacity_for_utf16(std::size_t utf16_size) noexcept -> std::size_t
+{
+  return utf16_size * 3;
+}
+
+namespace details
+{
+
+template <typename T>
+concept Utf16Unit = sizeof(T) == 2 && (std::is_same_v<T, char16_t> || std::is_same_v<T, wchar_t>);
+
+template <typename T>
+concept Utf32Unit = sizeof(T) == 4 && (std::is_same_v<T, char32_t> || std::is_same_v<T, wchar_t>);
+
+template <typename T>
+concept UtfWideUnit = Utf16Unit<T> || Utf32Unit<T>;
+
+inline constexpr char32_t UTF_REPLACEMENT = 0xFFFD;
+
+/// A single decoded code point and the number of bytes it occupied.
+/// For ill-formed input `valid` is false and `length` spans the maximal subpart.
+struct Utf8Decoded
+{
+  char32_t    code_point;
+  std::size_t length;
+  bool        valid;
+};
+
+/// Decodes a single code point from a non-empty UTF-8 range.
+inline auto decode_utf8(std::uint8_t const* in, std::uint8_t const* end) noexcept -> Utf8Decoded
+{
+  auto const b0 = in[0];
+  if (b0 < 0x80) {
+    return {b0, 1, true};
+  }
+
+  // Table 3-7 (Unicode Standard): well-formed byte sequences.
+  std::size_t  length = 0;
+  std::uint8_t lo = 0x80, hi = 0xBF;
+  char32_t     cp = 0;
+
+  if (b0 >= 0xC2 && b0 <= 0xDF) {
+    length = 2;
+    cp     = b0 & 0x1F;
+  }
+  else if (b0 >= 0xE0 && b0 <= 0xEF) {
+    length = 3;
+    cp     = b0 & 0x0F;
+    lo     = (b0 == 0xE0) ? 0xA0 : 0x80;
+    hi     = (b0 == 0xED) ? 0x9F : 0xBF;
+  }
+  else if (b0 >= 0xF0 && b0 <= 0xF4) {
+    length = 4;
+    cp     = b0 & 0x07;
+    lo     = (b0 == 0xF0) ? 0x90 : 0x80;
+    hi     = (b0 == 0xF4) ? 0x8F : 0xBF;
+  }
+  else {
+    return {UTF_REPLACEMENT, 1, false};
+  }
+
+  auto const available = static_cast<std::size_t>(end - in);
+  for (std::size_t i = 1; i < length; ++i) {
+    if (i >= available || in[i] < lo || in[i] > hi) {
+      return {UTF_REPLACEMENT, i, false};
+    }
+    cp = (cp << 6) | (in[i] & 0x3F);
+    lo = 0x80;
+    hi = 0xBF;
+  }
+
+  return {cp, length, true};
+}
+
+/// Scalar UTF-8 -> UTF-16/32 conversion, also used for the tails of the vectorized kernels.
+/// Stops after the code point that crosses `stop` (or at the end of the input).
+template <UtfWideUnit Out>
+auto utf8_to_wide_scalar(
+  std::uint8_t const*& in, std::uint8_t const* stop, std::uint8_t const* end, Out*& out, Out* out_end, UtfErrors errors
+) noexcept -> UtfStatus
+{
+  while (in < stop) {
+    auto const decoded = decode_utf8(in, end);
+    if (!decoded.valid && errors == UtfErrors::Stop) {
+      return UtfStatus::InvalidSequence;
+    }
+
+    if constexpr (Utf16Unit<Out>) {
+      if (decoded.code_point >= 0x10000) {
+        if (out_end - out < 2) {
+          return UtfStatus::OutputTooSmall;
+        }
+        auto const v = decoded.code_point - 0x10000;
+        *out++       = static_cast<Out>(0xD800 + (v >> 10));
+        *out++       = static_cast<Out>(0xDC00 + (v & 0x3FF));
+        in += decoded.length;
+        continue;
+      }
+    }
+
+    if (out == out_end) {
+      return UtfStatus::OutputTooSmall;
+    }
+    *out++ = static_cast<Out>(decoded.code_point);
+    in += decoded.length;
+  }
+  return UtfStatus::Ok;
+}
+
+/// Scalar UTF-16/32 -> UTF-8 conversion, also used for the tails of the vectorized kernels.
+template <UtfWideUnit In>
+auto wide_to_utf8_scalar(In const*& in, In const* stop, In const* end, char*& out, char* out_end, UtfErrors errors) noexcept
+  -> UtfStatus
+{
+  while (in < stop) {
+    auto        cp       = static_cast<char32_t>(in[0]);
+    std::size_t consumed = 1;
+
+    if constexpr (Utf16Unit<In>) {
+      cp &= 0xFFFF;
+      if (cp >= 0xD800 && cp <= 0xDFFF) {
+        auto const low = (end - in >= 2) ? static_cast<char32_t>(in[1]) & 0xFFFF : 0;
+        if (cp <= 0xDBFF && low >= 0xDC00 && low <= 0xDFFF) {
+          cp       = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          consumed = 2;
+        }
+        else if (errors == UtfErrors::Stop) {
+          return UtfStatus::InvalidSequence;
+        }
+        else {
+          cp = UTF_REPLACEMENT;
+        }
+      }
+    }
+    else {
+      if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        if (errors == UtfErrors::Stop) {
+          return UtfStatus::InvalidSequence;
+        }
+        cp = UTF_REPLACEMENT;
+      }
+    }
+
+    auto const length = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    if (out_end - out < length) {
+      return UtfStatus::OutputTooSmall;
+    }
+
+    switch (length) {
+    case 1: *out++ = static_cast<char>(cp); break;
+    case 2:
+      *out++ = static_cast<char>(0xC0 | (cp >> 6));
+      *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+      break;
+    case 3:
+      *out++ = static_cast<char>(0xE0 | (cp >> 12));
+      *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+      break;
+    default:
+      *out++ = static_cast<char>(0xF0 | (cp >> 18));
+      *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+      break;
+    }
+    in += consumed;
+  }
+  return UtfStatus::Ok;
+}
+
+// Vectorized kernels.
+//
+// JSON and URLs are mostly ASCII, so whole ASCII blocks are widened/narrowed at once. The
+// text in between is converted 8 code units at a time: ASCII mixed with 2-byte sequences
+// (Latin, Greek, Cyrillic, Hebrew, Arabic...) and runs of 3-byte sequences (the rest of the
+// BMP, e.g. CJK). The bytes are classified with comparisons and moved into place with a
+// shuffle, looked up by the classification mask for the mixed blocks. Anything else
+// (4-byte sequences, surrogates, ill-formed input) goes to the scalar code, which also
+// handles the errors. UTF-32 goes through the same kernels as long as it stays in the BMP.
+
+#if UBYTES_APP_PLATFORM_X86
+
+/// Gathers the code points starting in 8 bytes of ASCII and 2-byte sequences into 16-bit
+/// lanes, the continuation (or ASCII) byte low and the lead byte high.
+using Utf8Shuffle = std::array<std::uint8_t, 16>;
+
+/// Indexed by the mask of the 2-byte lead bytes. A lead in the last byte is left for the next block.
+consteval auto make_utf8_shuffles() -> std::array<Utf8Shuffle, 256>
+{
+  auto shuffles = std::array<Utf8Shuffle, 256>();
+  for (std::size_t leads = 0; leads < 256; ++leads) {
+    auto& shuffle = shuffles[leads];
+    shuffle.fill(0x80);
+
+    std::size_t in = 0, out = 0;
+    while (in < 8) {
+      if (((leads >> in) & 1) == 0) {
+        shuffle[2 * out] = static_cast<std::uint8_t>(in);
+        in += 1;
+      }
+      else if (in == 7) {
+        break;
+      }
+      else {
+        shuffle[2 * out]     = static_cast<std::uint8_t>(in + 1);
+        shuffle[2 * out + 1] = static_cast<std::uint8_t>(in);
+        in += 2;
+      }
+      ++out;
+    }
+  }
+  return shuffles;
+}
+
+/// Packs 8 code units below U+0800, each prepared as a 2-byte sequence in a 16-bit lane,
+/// dropping the second byte of the ASCII ones.
+struct Utf16Shuffle
+{
+  std::array<std::uint8_t, 16> shuffle;
+  std::uint8_t                 written;
+};
+
+/// Indexed by the mask of the ASCII code units.
+consteval auto make_utf16_shuffles() -> std::array<Utf16Shuffle, 256>
+{
+  auto shuffles = std::array<Utf16Shuffle, 256>();
+  for (std::size_t ascii = 0; ascii < 256; ++ascii) {
+    auto& entry = shuffles[ascii];
+    entry.shuffle.fill(0x80);
+
+    std::size_t out = 0;
+    for (std::size_t in = 0; in < 8; ++in) {
+      entry.shuffle[out++] = static_cast<std::uint8_t>(2 * in);
+      if (((ascii >> in) & 1) == 0) {
+        entry.shuffle[out++] = static_cast<std::uint8_t>(2 * in + 1);
+      }
+    }
+    entry.written = static_cast<std::uint8_t>(out);
+  }
+  return shuffles;
+}
+
+inline constexpr auto UTF8_SHUFFLES  = make_utf8_shuffles();
+inline constexpr auto UTF16_SHUFFLES = make_utf16_shuffles();
+
+/// The code units converted by a block kernel, none if the block needs the scalar code.
+struct UtfBlock
+{
+  std::size_t read    = 0;
+  std::size_t written = 0;
+};
+
+/// Stores 8 UTF-16 code units, widened for UTF-32.
+template <UtfWideUnit Out>
+UBYTES_TARGET_SSE41 auto store_wide(Out* out, __m128i units) noexcept -> void
+{
+  if constexpr (Utf16Unit<Out>) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), units);
+  }
+  else {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu16_epi32(units));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu16_epi32(_mm_srli_si128(units, 8)));
+  }
+}
+
+/// Loads 8 code units as UTF-16.
+/// @return false for UTF-32 input outside of the BMP.
+template <UtfWideUnit In>
+UBYTES_TARGET_SSE41 auto load_wide(In const* in, __m128i& units) noexcept -> bool
+{
+  if constexpr (Utf16Unit<In>) {
+    units = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    return true;
+  }
+  else {
+    auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + 4));
+    if (!_mm_testz_si128(_mm_or_si128(a, b), _mm_set1_epi32(static_cast<int>(0xFFFF0000)))) {
+      return false;
+    }
+    units = _mm_packus_epi32(a, b);
+    return true;
+  }
+}
+
+/// Decodes the ASCII and 2-byte sequences in 8 bytes of `block` from `offset`, given the
+/// mask of their lead bytes.
+UBYTES_TARGET_SSE41 inline auto decode_utf8_pairs(__m128i block, unsigned leads, unsigned offset) noexcept -> __m128i
+{
+  auto const shuffle = _mm_add_epi8(
+    _mm_loadu_si128(reinterpret_cast<__m128i const*>(UTF8_SHUFFLES[leads].data())),
+    _mm_set1_epi8(static_cast<char>(offset))
+  );
+  auto const pairs = _mm_shuffle_epi8(block, shuffle);
+  // The ASCII byte, or the low 6 bits from the continuation and 5 bits from the lead.
+  return _mm_or_si128(
+    _mm_and_si128(pairs, _mm_set1_epi16(0x7F)), _mm_and_si128(_mm_srli_epi16(pairs, 2), _mm_set1_epi16(0x07C0))
+  );
+}
+
+/// Converts the ASCII and 2-byte sequences starting in the next 14 to 16 bytes, or the next
+/// four 3-byte sequences. Needs 16 readable bytes and room for 16 units.
+template <UtfWideUnit Out>
+UBYTES_TARGET_SSE41 auto utf8_to_wide_block(std::uint8_t const* in, Out* out) noexcept -> UtfBlock
+{
+  auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+
+  // As signed bytes: continuations are [0x80, 0xBF], 2-byte leads [0xC2, 0xDF] and 3-byte leads [0xE0, 0xEF].
+  auto const ascii        = ~static_cast<unsigned>(_mm_movemask_epi8(block)) & 0xFFFF;
+  auto const continuation = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(0xC0)))));
+  auto const lead2        = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+    _mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(0xC1))), _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(0xE0)))
+  )));
+
+  // Every continuation follows a 2-byte lead and nothing else is there: converted in two
+  // halves, the second one starting after the sequences of the first.
+  if (((ascii | lead2 | continuation) & 0xFFFF) == 0xFFFF && continuation == ((lead2 << 1) & 0xFFFF)) {
+    auto const read_lo    = 8 - ((lead2 >> 7) & 1);
+    auto const leads_hi   = (lead2 >> read_lo) & 0xFF;
+    auto const read_hi    = 8 - (leads_hi >> 7);
+    auto const written_lo = read_lo - static_cast<unsigned>(std::popcount(lead2 & 0x7F));
+    auto const written_hi = read_hi - static_cast<unsigned>(std::popcount(leads_hi & 0x7F));
+    store_wide(out, decode_utf8_pairs(block, lead2 & 0xFF, 0));
+    store_wide(out + written_lo, decode_utf8_pairs(block, leads_hi, read_lo));
+    return UtfBlock{read_lo + read_hi, written_lo + written_hi};
+  }
+  if (((ascii | lead2 | continuation) & 0xFF) == 0xFF && (continuation & 0xFF) == ((lead2 << 1) & 0xFF)) {
+    auto const read = 8 - ((lead2 >> 7) & 1);
+    store_wide(out, decode_utf8_pairs(block, lead2 & 0xFF, 0));
+    return UtfBlock{read, read - static_cast<unsigned>(std::popcount(lead2 & 0x7F))};
+  }
+
+  auto const lead3 = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+    _mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(0xDF))), _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(0xF0)))
+  )));
+  if ((lead3 & 0xFFF) != 0b0010'0100'1001 || (continuation & 0xFFF) != 0b1101'1011'0110) {
+    return UtfBlock();
+  }
+
+  // One sequence per 32-bit lane, the lead byte highest.
+  auto const bytes = _mm_shuffle_epi8(block, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+  auto const code_points = _mm_or_si128(
+    _mm_or_si128(_mm_and_si128(bytes, _mm_set1_epi32(0x3F)), _mm_and_si128(_mm_srli_epi32(bytes, 2), _mm_set1_epi32(0x0FC0))),
+    _mm_and_si128(_mm_srli_epi32(bytes, 4), _mm_set1_epi32(0xF000))
+  );
+  // Overlong sequences and surrogates are ill-formed.
+  auto const invalid = _mm_or_si128(
+    _mm_cmplt_epi32(code_points, _mm_set1_epi32(0x800)),
+    _mm_cmpeq_epi32(_mm_and_si128(code_points, _mm_set1_epi32(0xF800)), _mm_set1_epi32(0xD800))
+  );
+  if (!_mm_testz_si128(invalid, invalid)) {
+    return UtfBlock();
+  }
+
+  if constexpr (Utf16Unit<Out>) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi32(code_points, code_points));
+  }
+  else {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), code_points);
+  }
+  return UtfBlock{12, 4};
+}
+
+/// Converts the next 8 code units if they are all below U+0800, or all 3-byte sequences.
+/// Needs 8 readable units and room for 32 bytes.
+template <UtfWideUnit In>
+UBYTES_TARGET_SSE41 auto wide_to_utf8_block(In const* in, char* out) noexcept -> UtfBlock
+{
+  auto units = _mm_setzero_si128();
+  if (!load_wide(in, units)) {
+    return UtfBlock();
+  }
+
+  auto const high = _mm_and_si128(units, _mm_set1_epi16(static_cast<short>(0xF800)));
+  if (_mm_testz_si128(high, high)) {
+    auto const ascii_lanes = _mm_cmplt_epi16(units, _mm_set1_epi16(0x80));
+    // Each unit as a 2-byte sequence, lead byte first, and the ASCII ones as they are.
+    auto const pairs = _mm_or_si128(
+      _mm_or_si128(_mm_srli_epi16(units, 6), _mm_slli_epi16(_mm_and_si128(units, _mm_set1_epi16(0x3F)), 8)),
+      _mm_set1_epi16(static_cast<short>(0x80C0))
+    );
+    auto const  bytes = _mm_blendv_epi8(pairs, units, ascii_lanes);
+    auto const  ascii = static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(ascii_lanes, _mm_setzero_si128())));
+    auto const& entry = UTF16_SHUFFLES[ascii & 0xFF];
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(out),
+      _mm_shuffle_epi8(bytes, _mm_loadu_si128(reinterpret_cast<__m128i const*>(entry.shuffle.data())))
+    );
+    return UtfBlock{8, entry.written};
+  }
+
+  auto const two_bytes  = _mm_cmpeq_epi16(high, _mm_setzero_si128());
+  auto const surrogates = _mm_cmpeq_epi16(high, _mm_set1_epi16(static_cast<short>(0xD800)));
+  if (_mm_movemask_epi8(_mm_or_si128(two_bytes, surrogates)) != 0) {
+    return UtfBlock();
+  }
+
+  // Four 3-byte sequences per 32-bit lanes, then packed to 12 bytes.
+  auto const pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  __m128i const halves[] = {units, _mm_srli_si128(units, 8)};
+  for (std::size_t i = 0; i < 2; ++i) {
+    auto const code_points = _mm_cvtepu16_epi32(halves[i]);
+    auto const sequences   = _mm_or_si128(
+      _mm_or_si128(_mm_srli_epi32(code_points, 12), _mm_and_si128(_mm_slli_epi32(code_points, 2), _mm_set1_epi32(0x3F00))),
+      _mm_or_si128(_mm_and_si128(_mm_slli_epi32(code_points, 16), _mm_set1_epi32(0x3F0000)), _mm_set1_epi32(0x8080E0))
+    );
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12 * i), _mm_shuffle_epi8(sequences, pack));
+  }
+  return UtfBlock{8, 24};
+}
+
+template <UtfWideUnit Out>
+UBYTES_TARGET_SSE41 auto utf8_to_wide_sse41(
+  std::uint8_t const*& in, std::uint8_t const* end, Out*& out, Out* out_end, UtfErrors errors
+) noexcept -> UtfStatus
+{
+  while (end - in >= 16 && out_end - out >= 16) {
+    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    if (_mm_movemask_epi8(block) == 0) {
+      store_wide(out, _mm_cvtepu8_epi16(block));
+      store_wide(out + 8, _mm_cvtepu8_epi16(_mm_srli_si128(block, 8)));
+      in += 16;
+      out += 16;
+      continue;
+    }
+    if (auto const block = utf8_to_wide_block(in, out); block.read != 0) {
+      in += block.read;
+      out += block.written;
+      continue;
+    }
+
+    auto const status = utf8_to_wide_scalar(in, in + 8, end, out, out_end, errors);
+    if (status != UtfStatus::Ok) {
+      return status;
+    }
+  }
+  return utf8_to_wide_scalar(in, end, end, out, out_end, errors);
+}
+
+template <UtfWideUnit Out>
+UBYTES_TARGET_AVX2 auto utf8_to_wide_avx2(
+  std::uint8_t const*& in, std::uint8_t const* end, Out*& out, Out* out_end, UtfErrors errors
+) noexcept -> UtfStatus
+{
+  while (end - in >= 32 && out_end - out >= 32) {
+    auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+    if (_mm256_movemask_epi8(block) == 0) {
+      if constexpr (Utf16Unit<Out>) {
+        auto const lo = _mm256_castsi256_si128(block);
+        auto const hi = _mm256_extracti128_si256(block, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(lo));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_cvtepu8_epi16(hi));
+      }
+      else {
+        for (std::size_t i = 0; i < 32; i += 8) {
+          auto const bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(in + i));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu8_epi32(bytes));
+        }
+      }
+      in += 32;
+      out += 32;
+      continue;
+    }
+    if (auto const block = utf8_to_wide_block(in, out); block.read != 0) {
+      in += block.read;
+      out += block.written;
+      continue;
+    }
+
+    auto const status = utf8_to_wide_scalar(in, in + 8, end, out, out_end, errors);
+    if (status != UtfStatus::Ok) {
+      return status;
+    }
+  }
+  return utf8_to_wide_sse41(in, end, out, out_end, errors);
+}
+
+template <UtfWideUnit In>
+UBYTES_TARGET_SSE41 auto wide_to_utf8_sse41(In const*& in, In const* end, char*& out, char* out_end, UtfErrors errors) noexcept
+  -> UtfStatus
+{
+  auto const non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+  while (end - in >= 16 && out_end - out >= 32) {
+    auto a = _mm_setzero_si128();
+    auto b = _mm_setzero_si128();
+    if (load_wide(in, a) && load_wide(in + 8, b) && _mm_testz_si128(_mm_or_si128(a, b), non_ascii)) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+      in += 16;
+      out += 16;
+      continue;
+    }
+    if (auto const block = wide_to_utf8_block(in, out); block.read != 0) {
+      in += block.read;
+      out += block.written;
+      continue;
+    }
+
+    auto const status = wide_to_utf8_scalar(in, in + 8, end, out, out_end, errors);
+    if (status != UtfStatus::Ok) {
+      return status;
+    }
+  }
+  return wide_to_utf8_scalar(in, end, end, out, out_end, errors);
+}
+
+template <UtfWideUnit In>
+UBYTES_TARGET_AVX2 auto wide_to_utf8_avx2(In const*& in, In const* end, char*& out, char* out_end, UtfErrors errors) noexcept
+  -> UtfStatus
+{
+  while (end - in >= 32 && out_end - out >= 32) {
+    if constexpr (Utf16Unit<In>) {
+      auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+      auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + 16));
+      if (_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_set1_epi16(static_cast<short>(0xFF80)))) {
+        // `packus` works per 128-bit lane, restore the order afterwards.
+        auto const packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0b11'01'10'00);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+        in += 32;
+        out += 32;
+        continue;
+      }
+    }
+    else {
+      auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+      auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + 8));
+      auto const c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + 16));
+      auto const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + 24));
+      auto const any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+      if (_mm256_testz_si256(any, _mm256_set1_epi32(static_cast<int>(0xFFFFFF80)))) {
+        // Both packs work per 128-bit lane: each lane holds 4 units of every input, in order.
+        auto const packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+        auto const order  = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(packed, order));
+        in += 32;
+        out += 32;
+        continue;
+      }
+    }
+    if (auto const block = wide_to_utf8_block(in, out); block.read != 0) {
+      in += block.read;
+      out += block.written;
+      continue;
+    }
+
+    auto const status = wide_to_utf8_scalar(in, in + 8, end, out, out_end, errors);
+    if (status != UtfStatus::Ok) {
+      return status;
+    }
+  }
+  return wide_to_utf8_sse41(in, end, out, out_end, errors);
+}
+
+#endif
+
+} // namespace details
+
+/// Converts UTF-8 to UTF-16 (or UTF-32 for 4-byte `wchar_t`) into a caller-provided buffer.
+/// Never allocates. A buffer of `utf16_capacity_for_utf8(in.size())` units is always enough.
+/// @param level - the instruction set to use, by default the best one available.
+template <details::UtfWideUnit Out>
+auto convert_utf8_to_wide(
+  std::string_view in, std::span<Out> out, UtfErrors errors = UtfErrors::Replace, SimdLevel level = simd_level()
+) noexcept -> UtfResult
+{
+  auto const* const begin     = reinterpret_cast<std::uint8_t const*>(in.data());
+  auto const*       src       = begin;
+  auto const* const end       = begin + in.size();
+  Out* const        out_begin = out.data();
+  Out*              dst       = out_begin;
+  Out* const        out_end   = out_begin + out.size();
+
+  auto status = UtfStatus::Ok;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    status = details::utf8_to_wide_avx2(src, end, dst, out_end, errors);
+  }
+  else if (level == SimdLevel::SSE41) {
+    status = details::utf8_to_wide_sse41(src, end, dst, out_end, errors);
+  }
+  else {
+    status = details::utf8_to_wide_scalar(src, end, end, dst, out_end, errors);
+  }
+#else
+  (void)level;
+  status = details::utf8_to_wide_scalar(src, end, end, dst, out_end, errors);
+#endif
+
+  return UtfResult{status, static_cast<std::size_t>(src - begin), static_cast<std::size_t>(dst - out_begin)};
+}
+
+/// Converts UTF-16 (or UTF-32 for 4-byte `wchar_t`) to UTF-8 into a caller-provided buffer.
+/// Never allocates. A buffer of `utf8_capacity_for_utf16(in.size())` bytes is always enough.
+/// @param level - the instruction set to use, by default the best one available.
+template <details::UtfWideUnit In>
+auto convert_wide_to_utf8(
+  std::basic_string_view<In> in, std::span<char> out, UtfErrors errors = UtfErrors::Replace, SimdLevel level = simd_level()
+) noexcept -> UtfResult
+{
+  In const* const   begin     = in.data();
+  In const*         src       = begin;
+  In const* const   end       = begin + in.size();
+  char* const       out_begin = out.data();
+  char*             dst       = out_begin;
+  char* const       out_end   = out_begin + out.size();
+
+  auto status = UtfStatus::Ok;
+#if UBYTES_APP_PLATFORM_X86
+  if (level == SimdLevel::AVX2) {
+    status = details::wide_to_utf8_avx2(src, end, dst, out_end, errors);
+  }
+  else if (level == SimdLevel::SSE41) {
+    status = details::wide_to_utf8_sse41(src, end, dst, out_end, errors);
+  }
+  else {
+    status = details::wide_to_utf8_scalar(src, end, end, dst, out_end, errors);
+  }
+#else
+  (void)level;
+  status = details::wide_to_utf8_scalar(src, end, end, dst, out_end, errors);
+#endif
+
+  return UtfResult{status, static_cast<std::size_t>(src - begin), static_cast<std::size_t>(dst - out_begin)};
+}
+
+/// Returns true if the input is well-formed UTF-8.
+inline auto is_valid_utf8(std::string_view str) noexcept -> bool
+{
+  auto const* in  = reinterpret_cast<std::uint8_t const*>(str.data());
+  auto const* end = in + str.size();
+
+  while (in < end) {
+#if UBYTES_APP_PLATFORM_X86
+    // Skip ASCII 16 bytes at a time, SSE2 is always available on x86-64.
+    while (end - in >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in))) == 0) {
+      in += 16;
+    }
+    if (in == end) {
+      break;
+    }
+#endif
+    auto const decoded = details::decode_utf8(in, end);
+    if (!decoded.valid) {
+      return false;
+    }
+    in += decoded.length;
+  }
+  return true;
+}
+
+} // namespace app_platform
+} // namespace ubytes
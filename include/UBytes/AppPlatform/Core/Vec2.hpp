@@ -21,16 +21,18 @@ struct Vec2
   }
 
   template <typename U>
-  static auto max(Vec2<T> a, Vec2<U> b) noexcept -> Vec2<T>
+  static constexpr auto max(Vec2<T> a, Vec2<U> b) noexcept -> Vec2<T>
   {
     return Vec2<T>(std::max(a.x, T(b.x)), std::max(a.y, T(b.y)));
   }
 
   template <typename U>
-  static auto min(Vec2<T> a, Vec2<U> b) noexcept -> Vec2<T>
+  static constexpr auto min(Vec2<T> a, Vec2<U> b) noexcept -> Vec2<T>
   {
     return Vec2<T>(std::min(a.x, T(b.x)), std::min(a.y, T(b.y)));
   }
+
+  friend constexpr auto operator==(Vec2 const& a, Vec2 const& b) noexcept -> bool = default;
 };
 
 using Vec2i = Vec2<std::int32_t>;
@@ -39,49 +41,49 @@ using Vec2f = Vec2<float>;
 using Vec2d = Vec2<double>;
 
 template <typename T>
-inline auto operator+(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
+constexpr auto operator+(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x + b.x, a.y + b.y);
 }
 
 template <typename T>
-inline auto operator-(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
+constexpr auto operator-(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x - b.x, a.y - b.y);
 }
 
 template <typename T>
-inline auto operator*(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
+constexpr auto operator*(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x * b.x, a.y * b.y);
 }
 
 template <typename T>
-inline auto operator/(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
+constexpr auto operator/(Vec2<T> a, Vec2<T> b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x / b.x, a.y / b.y);
 }
 
 template <typename T>
-inline auto operator+(Vec2<T> a, T b) noexcept -> Vec2<T>
+constexpr auto operator+(Vec2<T> a, T b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x + b, a.y + b);
 }
 
 template <typename T>
-inline auto operator-(Vec2<T> a, T b) noexcept -> Vec2<T>
+constexpr auto operator-(Vec2<T> a, T b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x - b, a.y - b);
 }
 
 template <typename T>
-inline auto operator*(Vec2<T> a, T b) noexcept -> Vec2<T>
+constexpr auto operator*(Vec2<T> a, T b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x * b, a.y * b);
 }
 
 template <typename T>
-inline auto operator/(Vec2<T> a, T b) noexcept -> Vec2<T>
+constexpr auto operator/(Vec2<T> a, T b) noexcept -> Vec2<T>
 {
   return Vec2<T>(a.x / b, a.y / b);
 }
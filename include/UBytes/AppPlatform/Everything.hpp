@@ -3,6 +3,18 @@
 #include <UBytes/AppPlatform/Core.hpp>
 #include <UBytes/AppPlatform/Window.hpp>
 #include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/WebView/MessageReceiver.hpp>
+#include <UBytes/AppPlatform/WebView/MessageBatcher.hpp>
+#include <UBytes/AppPlatform/WebView/OutboundLanes.hpp>
+#include <UBytes/AppPlatform/WebView/BinaryChannel.hpp>
+#include <UBytes/AppPlatform/WebView/Rpc.hpp>
+#include <UBytes/AppPlatform/WebView/StateStore.hpp>
+#include <UBytes/AppPlatform/WebView/AssetServer.hpp>
+#include <UBytes/AppPlatform/WebView/Stream.hpp>
+#include <UBytes/AppPlatform/WebView/ImageTransfer.hpp>
+#include <UBytes/AppPlatform/WebView/WebViewPool.hpp>
+#include <UBytes/AppPlatform/WebView/Coroutine.hpp>
+#include <UBytes/AppPlatform/WebView/AcceleratorKeys.hpp>
 #include <UBytes/AppPlatform/App.hpp>
 
 namespace ubytes
@@ -121,6 +121,15 @@ public:
     bool          shift        = false;
     bool          alt          = false;
     int           repeat_count = 1;
+
+    /// Returns the key with its modifiers, e.g. to look it up in a `Keymap`.
+    constexpr auto stroke() const noexcept -> KeyStroke
+    {
+      return KeyStroke(
+        key,
+        std::uint8_t((ctrl ? Keyboard::Ctrl : 0) | (shift ? Keyboard::Shift : 0) | (alt ? Keyboard::Alt : 0))
+      );
+    }
   };
 
   // Event handlers
@@ -131,6 +140,9 @@ public:
 
   /// Called when a message is received from the WebView.
   /// The message is a view over UTF-8 encoded string.
+  /// @note Allocates an owned string for every message (one heap allocation unless
+  /// the message fits in the small string buffer). See `MessageReceiver` in
+  /// `WebView/MessageReceiver.hpp` for pooled buffers.
   std::function<void(std::string)> on_message;
 
   /// Called when user presses a key combination that is
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/Keyboard.hpp>
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Wraps an `on_accelerator_key` handler so that it is only called for the strokes of `strokes`,
+/// e.g. the strokes a `Keymap` binds:
+///
+/// ```cpp
+/// webview.on_accelerator_key = filter_accelerator_keys(
+///   keymap.strokes(),
+///   [&keymap](WebView::AcceleratorKey key) { keymap.press(key.stroke()); }
+/// );
+/// ```
+///
+/// The set is read for every key, so it can be updated in place (see `Keymap::strokes()`).
+/// @note This saves nothing with the platform binaries (1.3.0), which cannot filter the keys
+/// natively: the WebView still calls `on_accelerator_key` for every key, and the check makes
+/// a key about 25% slower than forwarding it to `Keymap::press()` (the `keymap/forward`
+/// benchmarks). Forward every key to the keymap instead, the wrapper is only worth it for a
+/// handler that is expensive even for unbound keys.
+inline auto filter_accelerator_keys(
+  std::shared_ptr<KeyStrokeSet const>          strokes,
+  std::function<void(WebView::AcceleratorKey)> handler
+) -> std::function<void(WebView::AcceleratorKey)>
+{
+  return [strokes = std::move(strokes), handler = std::move(handler)](WebView::AcceleratorKey key)
+  {
+    if (strokes->contains(key.stroke())) {
+      handler(key);
+    }
+  };
+}
+
+} // namespace app_platform
+} // namespace ubytes
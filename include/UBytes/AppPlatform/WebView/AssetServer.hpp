@@ -0,0 +1,252 @@
+#pragma once
+
+#include <UBytes/AppPlatform/Core/AssetPack.hpp>
+#include <UBytes/AppPlatform/Core/EmbeddedAssets.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A request to the virtual origin of an `AssetServer`.
+struct ResourceRequest
+{
+  std::string_view method;
+  std::string_view url;
+  /// The `If-None-Match` header, empty if missing.
+  std::string_view if_none_match;
+};
+
+/// The answer to a `ResourceRequest`, with views into the asset storage.
+struct ResourceResponse
+{
+  int status = 404;
+  /// The body is not copied: it must stay valid while the backend reads it (e.g. point into a mapped pack).
+  std::span<std::byte const> body;
+  std::string_view           content_type;
+  std::string_view           content_encoding;
+  std::string_view           etag;
+  std::string_view           cache_control;
+};
+
+struct AssetServerSettings
+{
+  /// Served for the paths ending with a slash.
+  std::string_view index = "index.html";
+
+  /// Serves the index for unknown paths without an extension (client-side routing).
+  bool spa_fallback = false;
+
+  /// The `Cache-Control` header. The ETags make revalidation cheap, so `no-cache`
+  /// keeps the assets fresh while avoiding the transfers.
+  std::string_view cache_control = "no-cache";
+};
+
+/// Resolves the requests to a virtual origin against asset packs or other asset sources.
+///
+/// The responses point straight into the asset storage: a request costs a lookup
+/// and no copy. Requests carrying a matching `If-None-Match` get a `304`.
+///
+/// ```cpp
+/// auto pack   = open_asset_pack("assets.pack");
+/// auto server = AssetServer();
+/// server.add_pack(pack);
+///
+/// // From the request handler of a backend that intercepts `https://app.local/`:
+/// auto const response = server.resolve(ResourceRequest{"GET", url, if_none_match});
+/// ```
+/// @note The `WebView` of the platform binaries (1.3.0) cannot intercept requests, so
+/// nothing routes the page's requests here yet: the server is the header-side part,
+/// for a backend that can, or to answer requests the page sends as messages.
+/// The packs must outlive the server and the responses.
+class AssetServer
+{
+public:
+  /// Looks an asset up by its path (without the leading slash).
+  using Source = std::function<std::optional<Asset>(std::string_view path)>;
+
+  explicit AssetServer(AssetServerSettings settings = {})
+    : _settings(settings)
+  {
+  }
+
+  /// Adds a pack. Sources added first take precedence.
+  auto add_pack(AssetPack const& pack) -> void
+  {
+    add_source(
+      [&pack](std::string_view path)
+      {
+        return pack.find(path);
+      }
+    );
+  }
+
+  /// Adds the assets compiled into the binary.
+  auto add_assets(EmbeddedAssets const& assets) -> void
+  {
+    add_source(
+      [&assets](std::string_view path)
+      {
+        return assets.find(path);
+      }
+    );
+  }
+
+  auto add_source(Source source) -> void
+  {
+    _sources.push_back(std::move(source));
+  }
+
+  /// Finds the asset of a path, applying the index and fallback rules.
+  auto find(std::string_view path) const -> std::optional<Asset>
+  {
+    path = details::asset_relative_path(path);
+
+    if (path.empty() || path.back() == '/') {
+      auto index = std::string(path);
+      index += _settings.index;
+      return find_in_sources(index);
+    }
+
+    if (auto asset = find_in_sources(path)) {
+      return asset;
+    }
+
+    auto const name = path.substr(path.rfind('/') + 1);
+    if (_settings.spa_fallback && name.find('.') == std::string_view::npos) {
+      return find_in_sources(_settings.index);
+    }
+    return std::nullopt;
+  }
+
+  /// Answers a request to the virtual origin.
+  auto resolve(ResourceRequest const& request) const -> ResourceResponse
+  {
+    auto response = ResourceResponse();
+    if (!request.method.empty() && request.method != "GET" && request.method != "HEAD") {
+      response.status = 405;
+      return response;
+    }
+
+    auto decoded = std::string();
+    auto path    = path_of(request.url);
+    if (path.find('%') != std::string_view::npos) {
+      decoded = percent_decode(path);
+      path    = decoded;
+    }
+
+    auto const asset = find(path);
+    if (!asset) {
+      response.status = 404;
+      return response;
+    }
+
+    response.etag          = asset->etag;
+    response.cache_control = _settings.cache_control;
+    if (etag_matches(request.if_none_match, asset->etag)) {
+      response.status = 304;
+      return response;
+    }
+
+    response.status           = 200;
+    response.content_type     = asset->mime_type;
+    response.content_encoding = content_encoding_name(asset->encoding);
+    if (request.method != "HEAD") {
+      response.body = asset->data;
+    }
+    return response;
+  }
+
+private:
+  auto find_in_sources(std::string_view path) const -> std::optional<Asset>
+  {
+    for (auto const& source : _sources) {
+      if (auto asset = source(path)) {
+        return asset;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the path of a URL, without the query and the fragment.
+  static auto path_of(std::string_view url) noexcept -> std::string_view
+  {
+    if (auto const scheme = url.find("://"); scheme != std::string_view::npos) {
+      url.remove_prefix(scheme + 3);
+      auto const slash = url.find('/');
+      url.remove_prefix(slash == std::string_view::npos ? url.size() : slash);
+    }
+    return url.substr(0, url.find_first_of("?#"));
+  }
+
+  static auto percent_decode(std::string_view path) -> std::string
+  {
+    auto const digit = [](char c) -> int
+    {
+      if (c >= '0' && c <= '9') {
+        return c - '0';
+      }
+      if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+      }
+      if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+      }
+      return -1;
+    };
+
+    auto result = std::string();
+    result.reserve(path.size());
+    for (std::size_t i = 0; i < path.size(); ++i) {
+      if (path[i] == '%' && i + 2 < path.size() && digit(path[i + 1]) >= 0 && digit(path[i + 2]) >= 0) {
+        result += static_cast<char>(digit(path[i + 1]) * 16 + digit(path[i + 2]));
+        i += 2;
+      }
+      else {
+        result += path[i];
+      }
+    }
+    return result;
+  }
+
+  /// Checks an `If-None-Match` list (`"a", "b"` or `*`) against an ETag.
+  static auto etag_matches(std::string_view header, std::string_view etag) noexcept -> bool
+  {
+    if (header.empty() || etag.empty()) {
+      return false;
+    }
+
+    while (!header.empty()) {
+      auto const comma = header.find(',');
+      auto       item  = header.substr(0, comma);
+      while (!item.empty() && item.front() == ' ') {
+        item.remove_prefix(1);
+      }
+      while (!item.empty() && item.back() == ' ') {
+        item.remove_suffix(1);
+      }
+      if (item.starts_with("W/")) {
+        item.remove_prefix(2);
+      }
+      if (item == "*" || item == etag) {
+        return true;
+      }
+      header.remove_prefix(comma == std::string_view::npos ? header.size() : comma + 1);
+    }
+    return false;
+  }
+
+  AssetServerSettings _settings;
+  std::vector<Source> _sources;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/Base64.hpp>
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/MessageBuffer.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A block of memory that can be handed to the page without copying.
+///
+/// This is the portable, in-process representation: a reference-counted buffer of a
+/// `MessageBufferPool`, which goes back to the pool when the last copy is released, from any
+/// thread. A `BinaryChannel::SharedSink` with shared memory support (e.g. `CoreWebView2SharedBuffer`)
+/// exposes it to the page directly.
+class SharedBuffer
+{
+public:
+  SharedBuffer() = default;
+
+  auto data() const noexcept -> std::byte*
+  {
+    return _data;
+  }
+
+  auto size() const noexcept -> std::size_t
+  {
+    return _buffer.size();
+  }
+
+  auto bytes() const noexcept -> std::span<std::byte>
+  {
+    return std::span<std::byte>(_data, _buffer.size());
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _data != nullptr;
+  }
+
+private:
+  friend class BinaryChannel;
+
+  explicit SharedBuffer(MessageBuffer buffer) noexcept
+    : _buffer(std::move(buffer))
+    , _data(reinterpret_cast<std::byte*>(_buffer.storage()))
+  {
+  }
+
+  MessageBuffer _buffer;
+  std::byte*    _data = nullptr;
+};
+
+/// Sends and receives binary payloads (assets, textures, audio) to and from the page.
+///
+/// With a sink that can post shared buffers, the bytes reach the page without
+/// being copied or encoded, tagged with the metadata message:
+///
+/// ```json
+/// {"__binary":"<tag>","size":<bytes>}
+/// ```
+///
+/// Otherwise the payload is base64-encoded (vectorized, see `Core/Base64.hpp`) into
+/// a regular JSON message:
+///
+/// ```json
+/// {"__binary":"<tag>","data":"<base64>"}
+/// ```
+///
+/// The page uses `js/BinaryChannel.js` to receive both forms and to send binary
+/// data back in the second one.
+/// @note Not thread-safe, but the buffers may be released from any thread.
+class BinaryChannel
+{
+public:
+  static constexpr std::string_view BINARY_KEY = "__binary";
+
+  /// Sends a JSON message to the page.
+  using JsonSink = std::function<void(std::string_view)>;
+
+  /// Posts a shared buffer to the page, along with its JSON metadata.
+  using SharedSink = std::function<void(SharedBuffer const&, std::string_view)>;
+
+  /// Receives the binary payloads sent by the page.
+  using Handler = std::function<void(std::string_view tag, std::span<std::byte const> bytes)>;
+
+  /// Called for every binary payload received through `receive()`.
+  Handler on_binary;
+
+  /// Constructs a channel that sends through `WebView::send_message`.
+  /// @param shared_sink - posts the shared buffers, if the application has a way to reach the
+  /// browser (e.g. its own `CoreWebView2` integration).
+  /// @note `WebView` has no shared buffer API (the prebuilt binaries don't post them), so
+  /// without a `shared_sink` the payloads are always sent base64-encoded.
+  explicit BinaryChannel(WebView& webview, SharedSink shared_sink = {})
+    : BinaryChannel(
+        [&webview](std::string_view message)
+        {
+          webview.send_message(message);
+        },
+        std::move(shared_sink)
+      )
+  {
+  }
+
+  /// Constructs a channel with custom sinks.
+  /// @param shared_sink - leave empty if the backend has no shared memory support.
+  explicit BinaryChannel(JsonSink json_sink, SharedSink shared_sink = {})
+    : _json_sink(std::move(json_sink))
+    , _shared_sink(std::move(shared_sink))
+    , _pool(MAX_POOLED, std::numeric_limits<std::size_t>::max())
+  {
+  }
+
+  /// Returns true if payloads are passed as shared buffers instead of base64.
+  auto supports_shared_buffers() const noexcept -> bool
+  {
+    return static_cast<bool>(_shared_sink);
+  }
+
+  /// Returns a buffer of `size` bytes to fill and pass to `send()`.
+  /// Buffers are reused once the page (and every other holder) releases them.
+  auto acquire(std::size_t size) -> SharedBuffer
+  {
+    auto buffer = _pool.acquire(size);
+    buffer.commit(size);
+    return SharedBuffer(std::move(buffer));
+  }
+
+  /// Sends a payload. Without shared memory support the bytes are base64-encoded.
+  auto send(std::string_view tag, SharedBuffer const& buffer) -> void
+  {
+    if (_shared_sink) {
+      _message.reset();
+      _message.begin_object();
+      _message.field(BINARY_KEY, tag);
+      _message.field("size", buffer.size());
+      _message.end_object();
+      _shared_sink(buffer, _message.view());
+      return;
+    }
+    send_base64(tag, buffer.bytes());
+  }
+
+  /// Sends a payload, copying it into a shared buffer if supported.
+  auto send(std::string_view tag, std::span<std::byte const> bytes) -> void
+  {
+    if (_shared_sink) {
+      auto buffer = acquire(bytes.size());
+      if (!bytes.empty()) {
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+      }
+      send(tag, buffer);
+      return;
+    }
+    send_base64(tag, bytes);
+  }
+
+  /// Handles a message received from the page (e.g. from `WebView::on_message`).
+  /// @return true if it was a binary message, passed to `on_binary`.
+  auto receive(std::string_view message) -> bool
+  {
+    // Skips the indexing of the application messages.
+    if (message.find("\"__binary\"") == std::string_view::npos) {
+      return false;
+    }
+
+    auto const root    = _reader.parse(message);
+    auto const encoded = root["data"].get_raw_string();
+    if (!encoded || root[BINARY_KEY].type() != JsonValue::Type::String) {
+      return false;
+    }
+
+    auto const capacity = base64_decoded_capacity(encoded->size()) + BASE64_DECODE_SLACK;
+    if (_receive_capacity < capacity) {
+      _receive_buffer   = std::make_unique_for_overwrite<std::byte[]>(capacity);
+      _receive_capacity = capacity;
+    }
+
+    // Base64 has no characters to escape (an escaped `/` fails to decode).
+    auto const size = base64_decode(*encoded, std::span<std::byte>(_receive_buffer.get(), capacity));
+    if (!size) {
+      return false;
+    }
+
+    if (on_binary) {
+      on_binary(*root[BINARY_KEY].get_string(), std::span<std::byte const>(_receive_buffer.get(), *size));
+    }
+    return true;
+  }
+
+private:
+  static constexpr std::size_t MAX_POOLED = 8;
+
+  auto send_base64(std::string_view tag, std::span<std::byte const> bytes) -> void
+  {
+    _message.reset();
+    _message.begin_object();
+    _message.field(BINARY_KEY, tag);
+    _message.key("data");
+
+    // Encode straight into the message buffer.
+    auto&      buffer  = _message.buffer();
+    auto const encoded = base64_encoded_size(bytes.size());
+    buffer.append('"');
+    buffer.commit(base64_encode(bytes, std::span<char>(buffer.prepare(encoded), encoded)));
+    buffer.append(std::string_view("\"}"));
+
+    _json_sink(buffer.view());
+  }
+
+  JsonSink   _json_sink;
+  SharedSink _shared_sink;
+
+  JsonWriter        _message;
+  MessageBufferPool _pool;
+
+  JsonReader                   _reader;
+  std::unique_ptr<std::byte[]> _receive_buffer;
+  std::size_t                  _receive_capacity = 0;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/Task.hpp>
+#include <UBytes/AppPlatform/App/UiScheduler.hpp>
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Awaiter returned by `setup()`: starts the setup and completes on `on_ready`.
+///
+/// The previous `on_ready` handler is restored (and called) once the WebView is ready,
+/// or restored when the suspended coroutine is destroyed before.
+class WebViewSetupAwaitable
+{
+public:
+  WebViewSetupAwaitable(WebView& webview, Window const& window, WebViewSettings settings) noexcept
+    : _webview(webview)
+    , _window(window)
+    , _settings(settings)
+  {
+  }
+
+  WebViewSetupAwaitable(WebViewSetupAwaitable const&)                    = delete;
+  auto operator=(WebViewSetupAwaitable const&) -> WebViewSetupAwaitable& = delete;
+
+  /// Restores the previous handler if the coroutine was destroyed while suspended.
+  ~WebViewSetupAwaitable()
+  {
+    if (_installed) {
+      _webview.on_ready = std::move(_previous);
+    }
+  }
+
+  auto await_ready() const noexcept -> bool
+  {
+    return _webview.setup_finished();
+  }
+
+  auto await_suspend(std::coroutine_handle<> handle) -> void
+  {
+    _handle   = handle;
+    _previous = std::exchange(
+      _webview.on_ready,
+      [this]
+      {
+        // Restoring the handler destroys this lambda, only locals are used afterwards.
+        auto* self              = this;
+        self->_installed        = false;
+        self->_webview.on_ready = std::move(self->_previous);
+        if (self->_webview.on_ready) {
+          self->_webview.on_ready();
+        }
+        self->_handle.resume();
+      }
+    );
+    _installed = true;
+    _webview.begin_setup(_window, _settings);
+  }
+
+  auto await_resume() const noexcept -> void
+  {
+  }
+
+private:
+  WebView&                _webview;
+  Window const&           _window;
+  WebViewSettings         _settings;
+  std::coroutine_handle<> _handle;
+  std::function<void()>   _previous;
+  /// True while `on_ready` is the handler of this awaiter.
+  bool                    _installed = false;
+};
+
+/// Awaiter returned by `next_permission_request()`.
+///
+/// The coroutine resumes inside the `on_permission_request` event, so the request
+/// can be answered right away, or later with `mark_completed()`:
+///
+/// ```cpp
+/// auto request = co_await next_permission_request(webview);
+/// auto allowed = co_await ask_in_page(request.get_kind());
+/// request.set_response(allowed ? WebView::Permission::Allow : WebView::Permission::Deny);
+/// request.mark_completed();
+/// ```
+///
+/// The previous `on_permission_request` handler is restored once a request arrives, or when
+/// the suspended coroutine is destroyed before.
+class PermissionRequestAwaitable
+{
+public:
+  using Request = WebView::Permission::Request;
+
+  explicit PermissionRequestAwaitable(WebView& webview) noexcept
+    : _webview(webview)
+  {
+  }
+
+  PermissionRequestAwaitable(PermissionRequestAwaitable const&)                    = delete;
+  auto operator=(PermissionRequestAwaitable const&) -> PermissionRequestAwaitable& = delete;
+
+  /// Restores the previous handler if the coroutine was destroyed while suspended.
+  ~PermissionRequestAwaitable()
+  {
+    if (_installed) {
+      _webview.on_permission_request = std::move(_previous);
+    }
+  }
+
+  auto await_ready() const noexcept -> bool
+  {
+    return false;
+  }
+
+  auto await_suspend(std::coroutine_handle<> handle) -> void
+  {
+    _handle   = handle;
+    _previous = std::exchange(
+      _webview.on_permission_request,
+      [this](Request request)
+      {
+        // Restoring the handler destroys this lambda, only locals are used afterwards.
+        auto* self                           = this;
+        self->_installed                     = false;
+        self->_webview.on_permission_request = std::move(self->_previous);
+        self->_request.emplace(std::move(request));
+        self->_handle.resume();
+      }
+    );
+    _installed = true;
+  }
+
+  auto await_resume() -> Request
+  {
+    return std::move(*_request);
+  }
+
+private:
+  WebView&                     _webview;
+  std::coroutine_handle<>      _handle;
+  std::function<void(Request)> _previous;
+  std::optional<Request>       _request;
+  /// True while `on_permission_request` is the handler of this awaiter.
+  bool                         _installed = false;
+};
+
+/// Starts the setup of a WebView and returns an awaitable completed once it is ready:
+///
+/// ```cpp
+/// co_await setup(webview, window);
+/// ```
+/// @note [pre-ready] A free function: `WebView` is implemented by the platform binaries.
+inline auto setup(WebView& webview, Window const& window, WebViewSettings settings = {}) -> WebViewSetupAwaitable
+{
+  return WebViewSetupAwaitable(webview, window, settings);
+}
+
+/// Returns an awaitable completed with the next permission request of a WebView.
+inline auto next_permission_request(WebView& webview) -> PermissionRequestAwaitable
+{
+  return PermissionRequestAwaitable(webview);
+}
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/WebView/BinaryChannel.hpp>
+#include <UBytes/AppPlatform/App/TaskPool.hpp>
+#include <UBytes/AppPlatform/Core/ImageCodec.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+struct ImageSettings
+{
+  /// The width and height of the tiles. The tiles are encoded in parallel and drawn as they arrive.
+  std::uint32_t tile_size = 256;
+
+  /// Sends the image downscaled by this factor first, so the page shows it at once. 0 or 1 disables it.
+  std::uint32_t preview_scale = 8;
+};
+
+/// Sends pixel buffers to canvases on the page.
+///
+/// The image is split into tiles, encoded on the task pool with a fast lossless codec
+/// (see `Core/ImageCodec.hpp`) and sent through a `BinaryChannel` as each tile is done,
+/// after a downscaled preview. This trades size for encoding time: the `BinaryChannel` over
+/// `WebView` always base64-encodes, and the messages come out about 2× larger than a
+/// base64-encoded PNG (1.6 MB against 0.75 MB for the 1024×1024 image of the `image/` benchmarks),
+/// but are encoded in about 10 ms instead of 90–300 ms. Only a `BinaryChannel` with a
+/// `SharedSink` avoids the base64 overhead.
+///
+/// ```cpp
+/// auto images = ImageSender(webview, task_pool());
+/// images.send("texture", pixels, width, height);
+/// ```
+///
+/// The page draws them with `js/ImageTransfer.js`:
+///
+/// ```js
+/// const images = new ImageReceiver();
+/// images.attach("texture", document.querySelector("canvas"));
+/// ```
+///
+/// Sending an image again with the same id cancels the tiles of the previous send that have
+/// not been encoded yet.
+/// @note Use from the UI thread. The tiles are sent from the continuations of the pool, which
+/// run when the UI loop drains their queue (see `App/UiQueueMessageLoop.hpp`).
+class ImageSender
+{
+public:
+  /// The prefix of the `BinaryChannel` tags, followed by the image id.
+  static constexpr std::string_view TAG_PREFIX = "image:";
+
+  /// Called on the UI thread after a tile is sent, with the number of full resolution tiles sent so far.
+  std::function<void(std::string_view id, std::uint32_t frame, std::uint32_t sent, std::uint32_t tiles)> on_progress;
+
+  /// Constructs a sender with its own `BinaryChannel` over `WebView::send_message`.
+  /// The tiles are encoded on `pool`, which must outlive the sender.
+  explicit ImageSender(WebView& webview, TaskPool& pool)
+    : _owned_channel(std::make_unique<BinaryChannel>(webview))
+    , _channel(_owned_channel.get())
+    , _pool(pool)
+  {
+  }
+
+  /// Constructs a sender over an existing channel, e.g. one with shared buffer support.
+  explicit ImageSender(BinaryChannel& channel, TaskPool& pool)
+    : _channel(&channel)
+    , _pool(pool)
+  {
+  }
+
+  ImageSender(ImageSender const&)                    = delete;
+  auto operator=(ImageSender const&) -> ImageSender& = delete;
+
+  /// Drops the tiles that have not been sent yet.
+  ~ImageSender()
+  {
+    for (auto& [id, send] : _sends) {
+      send.cancel.cancel();
+    }
+  }
+
+  /// Sends `width` x `height` pixels (row by row) to the canvas attached to `id`.
+  /// The pixels are copied, the buffer may be reused right away.
+  /// @return The frame number of this send, 0 if `pixels` holds less than `width * height` pixels.
+  auto send(
+    std::string_view id, std::span<Color4u const> pixels, std::uint32_t width, std::uint32_t height,
+    ImageSettings settings = {}
+  ) -> std::uint32_t
+  {
+    auto const count = std::size_t(width) * height;
+    if (pixels.size() < count || count == 0) {
+      return 0;
+    }
+    auto const tile_size = std::max<std::uint32_t>(settings.tile_size, 16);
+
+    auto& send = _sends[std::string(id)];
+    send.cancel.cancel();
+    send.cancel = CancellationSource();
+    send.frame  = ++_frame;
+    send.sent   = 0;
+
+    auto const image   = std::make_shared<std::vector<Color4u> const>(pixels.begin(), pixels.begin() + count);
+    auto const columns = (width + tile_size - 1) / tile_size;
+    auto const rows    = (height + tile_size - 1) / tile_size;
+
+    auto header         = ImageTileHeader();
+    header.frame        = send.frame;
+    header.image_width  = width;
+    header.image_height = height;
+    header.tiles        = columns * rows;
+    send.tiles          = header.tiles;
+
+    auto const token = send.cancel.token();
+    if (settings.preview_scale > 1 && header.tiles > 1) {
+      _pool.submit(
+        [image, header, scale = settings.preview_scale]() mutable
+        {
+          auto preview = std::vector<Color4u>();
+          downscale_image(*image, header.image_width, header.image_height, scale, preview);
+          header.flags  = ImageTilePreview;
+          header.scale  = static_cast<std::uint16_t>(scale);
+          header.width  = (header.image_width + scale - 1) / scale;
+          header.height = (header.image_height + scale - 1) / scale;
+
+          auto tile = std::vector<std::byte>();
+          encode_image_tile(preview, header.width, header, tile);
+          return tile;
+        },
+        sender(std::string(id), false),
+        TaskOptions{.priority = TaskPriority::High, .token = token}
+      );
+    }
+
+    // Row by row, so the image fills from the top like a regular progressive load.
+    for (std::uint32_t row = 0; row < rows; ++row) {
+      for (std::uint32_t column = 0; column < columns; ++column) {
+        header.x      = column * tile_size;
+        header.y      = row * tile_size;
+        header.width  = std::min(tile_size, width - header.x);
+        header.height = std::min(tile_size, height - header.y);
+        _pool.submit(
+          [image, header, width]
+          {
+            auto tile = std::vector<std::byte>();
+            encode_image_tile(*image, width, header, tile);
+            return tile;
+          },
+          sender(std::string(id), true),
+          TaskOptions{.token = token}
+        );
+      }
+    }
+    return send.frame;
+  }
+
+  /// Drops the tiles of `id` that have not been sent yet.
+  auto cancel(std::string_view id) -> void
+  {
+    if (auto it = _sends.find(std::string(id)); it != _sends.end()) {
+      it->second.cancel.cancel();
+    }
+  }
+
+private:
+  struct Send
+  {
+    CancellationSource cancel;
+    std::uint32_t      frame = 0;
+    std::uint32_t      sent  = 0;
+    std::uint32_t      tiles = 0;
+  };
+
+  /// Returns the UI thread continuation that sends an encoded tile.
+  /// Not run once the send is cancelled, which the destructor does too.
+  auto sender(std::string id, bool full_resolution) -> std::function<void(std::vector<std::byte>)>
+  {
+    return [this, id = std::move(id), full_resolution](std::vector<std::byte> tile)
+    {
+      _tag.assign(TAG_PREFIX);
+      _tag += id;
+      _channel->send(_tag, tile);
+      if (!full_resolution) {
+        return;
+      }
+
+      auto& send = _sends[id];
+      ++send.sent;
+      if (on_progress) {
+        on_progress(id, send.frame, send.sent, send.tiles);
+      }
+    };
+  }
+
+  std::unique_ptr<BinaryChannel> _owned_channel;
+  BinaryChannel*                 _channel;
+  TaskPool&                      _pool;
+
+  std::unordered_map<std::string, Send> _sends;
+  std::uint32_t                         _frame = 0;
+  std::string                           _tag;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/App/DeadlineTimer.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+struct MessageBatcherSettings
+{
+  /// The longest time a message may wait in the queue.
+  /// Checked on every `send()` and `poll()`, and by a timer armed when the queue stops being empty.
+  std::chrono::microseconds max_delay = std::chrono::milliseconds(16);
+
+  /// Flush once the queued messages take this many bytes.
+  std::size_t max_bytes = 64 * 1024;
+
+  /// Flush once this many messages are queued.
+  std::size_t max_messages = 256;
+};
+
+/// Queues JSON messages and sends them to the page as a single payload.
+///
+/// Many small `send_message` calls per frame each pay the cost of crossing the
+/// native/JS boundary. The batcher collects them and sends one message:
+///
+/// ```json
+/// {"__batch":[<message>,<message>,...]}
+/// ```
+///
+/// A single queued message is sent as is, unless it may contain the `__batch` key: it is
+/// then sent as a batch of one, so that the page does not unpack the message itself. Use
+/// `js/MessageBatcher.js` to unpack the batches on the page side.
+///
+/// Messages sent with `send_keyed()` follow the "latest value wins" rule: a newer
+/// message with the same key replaces the queued one, keeping its position.
+///
+/// The batcher flushes when the size or time budget is exceeded; call `flush()`
+/// at the end of each event loop tick to send the rest.
+/// @note Not thread-safe, use from the UI thread. When the queue stops being empty, a
+/// timer thread shared with `ResizeScheduler` posts a `UiQueue` task that flushes it after
+/// `max_delay`, so the UI loop must drain the queue (see `App/UiQueueMessageLoop.hpp`).
+/// The batcher flushes in its destructor: destroy it before the WebView it sends to
+/// (e.g. declare it after the WebView).
+class MessageBatcher
+{
+public:
+  static constexpr std::string_view BATCH_KEY = "__batch";
+
+  /// Receives the flushed payloads (null-terminated JSON).
+  using Sink = std::function<void(std::string_view)>;
+
+  struct Stats
+  {
+    /// Messages passed to `send()` / `send_keyed()`.
+    std::size_t queued = 0;
+    /// Keyed messages replaced by a newer one before being sent.
+    std::size_t coalesced = 0;
+    /// Payloads passed to the WebView.
+    std::size_t flushes = 0;
+  };
+
+  /// Constructs a batcher sending to a WebView, which must outlive it.
+  explicit MessageBatcher(WebView& webview, MessageBatcherSettings settings = {}, UiQueue& queue = ui_queue())
+    : MessageBatcher(
+        [&webview](std::string_view payload)
+        {
+          webview.send_message(payload);
+        },
+        settings,
+        queue
+      )
+  {
+  }
+
+  /// Constructs a batcher sending to a custom sink.
+  explicit MessageBatcher(Sink sink, MessageBatcherSettings settings = {}, UiQueue& queue = ui_queue())
+    : _sink(std::move(sink))
+    , _settings(settings)
+    , _alive(std::make_shared<MessageBatcher*>(this))
+    , _timer(
+        [&queue, alive = std::weak_ptr<MessageBatcher*>(_alive)]
+        {
+          queue.post(
+            [alive]
+            {
+              if (auto self = alive.lock()) {
+                (*self)->on_timer();
+              }
+            }
+          );
+        }
+      )
+  {
+  }
+
+  MessageBatcher(MessageBatcher const&)                    = delete;
+  auto operator=(MessageBatcher const&) -> MessageBatcher& = delete;
+
+  /// Flushes the remaining messages, to a sink (or WebView) that must still exist.
+  ~MessageBatcher()
+  {
+    flush();
+  }
+
+  /// Queues a JSON message.
+  /// @param message - UTF-8 string containing a valid JSON.
+  auto send(std::string_view message) -> void
+  {
+    push(message, std::string_view(), 0);
+  }
+
+  /// Queues a JSON message, replacing a queued message with the same key.
+  /// @param key - any string that identifies the value (e.g. "progress").
+  /// @param message - UTF-8 string containing a valid JSON.
+  auto send_keyed(std::string_view key, std::string_view message) -> void
+  {
+    auto const hash = hash_key(key);
+
+    if (auto* entry = find_keyed(key, hash)) {
+      entry->message_offset = _storage.size();
+      entry->message_size   = message.size();
+      _storage.append(message);
+
+      ++_stats.queued;
+      ++_stats.coalesced;
+      flush_if_over_budget();
+      return;
+    }
+
+    push(message, key, hash);
+  }
+
+  /// Flushes the queue if the time budget of the oldest message has been exceeded.
+  auto poll() -> void
+  {
+    if (!_entries.empty() && Clock::now() - _oldest >= _settings.max_delay) {
+      flush();
+    }
+  }
+
+  /// Sends all queued messages now.
+  auto flush() -> void
+  {
+    if (_entries.empty()) {
+      return;
+    }
+
+    _payload.clear();
+    // A message with the batch key would be unpacked by the page, send it in a batch.
+    if (_entries.size() == 1 && message_of(_entries.front()).find(BATCH_KEY) == std::string_view::npos) {
+      _payload.append(message_of(_entries.front()));
+    }
+    else {
+      _payload.append(std::string_view("{\""));
+      _payload.append(BATCH_KEY);
+      _payload.append(std::string_view("\":["));
+      for (std::size_t i = 0; i < _entries.size(); ++i) {
+        if (i > 0) {
+          _payload.append(',');
+        }
+        _payload.append(message_of(_entries[i]));
+      }
+      _payload.append(std::string_view("]}"));
+    }
+
+    _entries.clear();
+    _storage.clear();
+    std::fill(_keyed_slots.begin(), _keyed_slots.end(), 0u);
+    _keyed_count = 0;
+
+    ++_stats.flushes;
+    UBYTES_TRACE_SCOPE("MessageBatcher::flush");
+    UBYTES_TRACE_RECORD(TraceMetric::SendSize, _payload.size());
+    _sink(_payload.view());
+  }
+
+  /// Returns the number of queued messages.
+  auto size() const noexcept -> std::size_t
+  {
+    return _entries.size();
+  }
+
+  auto stats() const noexcept -> Stats const&
+  {
+    return _stats;
+  }
+
+  auto settings() const noexcept -> MessageBatcherSettings const&
+  {
+    return _settings;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry
+  {
+    std::size_t   message_offset;
+    std::size_t   message_size;
+    std::size_t   key_offset;
+    std::size_t   key_size;
+    std::uint64_t key_hash;
+  };
+
+  static auto hash_key(std::string_view key) noexcept -> std::uint64_t
+  {
+    // FNV-1a, 0 is reserved for unkeyed entries.
+    auto hash = std::uint64_t(14695981039346656037ull);
+    for (auto c : key) {
+      hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash | 1;
+  }
+
+  auto message_of(Entry const& entry) const noexcept -> std::string_view
+  {
+    return _storage.view().substr(entry.message_offset, entry.message_size);
+  }
+
+  auto key_of(Entry const& entry) const noexcept -> std::string_view
+  {
+    return _storage.view().substr(entry.key_offset, entry.key_size);
+  }
+
+  auto find_keyed(std::string_view key, std::uint64_t hash) noexcept -> Entry*
+  {
+    if (_keyed_slots.empty()) {
+      return nullptr;
+    }
+
+    auto const mask = _keyed_slots.size() - 1;
+    for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+      auto const index = _keyed_slots[slot];
+      if (index == 0) {
+        return nullptr;
+      }
+
+      auto& entry = _entries[index - 1];
+      if (entry.key_hash == hash && key_of(entry) == key) {
+        return &entry;
+      }
+    }
+  }
+
+  auto insert_keyed(std::uint64_t hash, std::uint32_t index) -> void
+  {
+    // Keep the open addressing table at most half full.
+    if ((_keyed_count + 1) * 2 > _keyed_slots.size()) {
+      _keyed_slots.assign(std::max<std::size_t>(16, _keyed_slots.size() * 2), 0u);
+      _keyed_count = 0;
+      for (std::uint32_t i = 0; i < _entries.size(); ++i) {
+        if (_entries[i].key_hash != 0 && i + 1 != index) {
+          place_keyed(_entries[i].key_hash, i + 1);
+        }
+      }
+    }
+    place_keyed(hash, index);
+  }
+
+  auto place_keyed(std::uint64_t hash, std::uint32_t index) noexcept -> void
+  {
+    auto const mask = _keyed_slots.size() - 1;
+    auto       slot = hash & mask;
+    while (_keyed_slots[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    _keyed_slots[slot] = index;
+    ++_keyed_count;
+  }
+
+  auto push(std::string_view message, std::string_view key, std::uint64_t hash) -> void
+  {
+    if (_entries.empty()) {
+      _oldest = Clock::now();
+      if (!_armed) {
+        _armed = true;
+        _timer.arm(_oldest + _settings.max_delay);
+      }
+    }
+
+    auto entry           = Entry();
+    entry.key_offset     = _storage.size();
+    entry.key_size       = key.size();
+    entry.key_hash       = hash;
+    _storage.append(key);
+    entry.message_offset = _storage.size();
+    entry.message_size   = message.size();
+    _storage.append(message);
+    _entries.push_back(entry);
+
+    if (hash != 0) {
+      insert_keyed(hash, static_cast<std::uint32_t>(_entries.size()));
+    }
+
+    ++_stats.queued;
+    flush_if_over_budget();
+  }
+
+  auto on_timer() -> void
+  {
+    _armed = false;
+    if (_entries.empty()) {
+      return;
+    }
+    // Flushed and queued again since the timer was armed: wait for the new oldest message.
+    auto const due = _oldest + _settings.max_delay;
+    if (Clock::now() < due) {
+      _armed = true;
+      _timer.arm(due);
+      return;
+    }
+    flush();
+  }
+
+  auto flush_if_over_budget() -> void
+  {
+    if (_storage.size() >= _settings.max_bytes || _entries.size() >= _settings.max_messages) {
+      flush();
+    }
+    else {
+      poll();
+    }
+  }
+
+  Sink                   _sink;
+  MessageBatcherSettings _settings;
+  Stats                  _stats;
+
+  // All queued keys and messages, reused between flushes.
+  JsonBuffer         _storage;
+  JsonBuffer         _payload;
+  std::vector<Entry> _entries;
+  Clock::time_point  _oldest;
+
+  // Open addressing table of keyed entries (index + 1, 0 means empty).
+  std::vector<std::uint32_t> _keyed_slots;
+  std::size_t                _keyed_count = 0;
+
+  /// True from arming the timer to its task, armed once per `max_delay` at most.
+  bool _armed = false;
+  /// Expires with the batcher, so that the timer tasks already queued do nothing.
+  std::shared_ptr<MessageBatcher*> _alive;
+  details::DeadlineTimer           _timer;
+};
+
+} // namespace app_platform
+} // namespace ubytes
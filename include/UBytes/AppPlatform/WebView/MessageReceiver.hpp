@@ -0,0 +1,122 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/MessageBuffer.hpp>
+#include <UBytes/AppPlatform/Core/Text.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// Receives the messages of a WebView in pooled, reference-counted buffers, which can be
+/// kept or handed to other threads without copying them again.
+///
+/// ```cpp
+/// auto receiver = MessageReceiver(
+///   [this](MessageBuffer const& message)
+///   {
+///     _pending.push_back(message); // Kept without a copy.
+///   }
+/// );
+/// receiver.attach(webview);
+/// ```
+///
+/// The heap allocations per message:
+/// - `WebView::on_message` alone: the library constructs a `std::string` for every message,
+///   one allocation unless it fits in the small string buffer (15 characters with the common
+///   standard libraries).
+/// - Attached with `attach()`: that same allocation, then a copy into a pooled buffer, which
+///   does not allocate once the pool is warmed up.
+/// - Through `receive()`, for a backend that hands out views of the messages: none once the
+///   pool is warmed up.
+///
+/// So with the current library, which only hands out strings, the receiver saves nothing on
+/// the way in. It pays off when the messages are kept or handed to other threads, which would
+/// copy the string anyway, and once a backend delivers views.
+/// @note The WebView keeps the receiver's pool and handler alive while attached.
+class MessageReceiver
+{
+public:
+  using Handler = std::function<void(MessageBuffer const& message)>;
+
+  /// @param max_pooled, max_capacity - how many idle buffers are kept and how large, see `MessageBufferPool`.
+  explicit MessageReceiver(
+    Handler     handler,
+    std::size_t max_pooled   = 16,
+    std::size_t max_capacity = MessageBufferPool::DEFAULT_MAX_CAPACITY
+  )
+    : _state(std::make_shared<State>(std::move(handler), max_pooled, max_capacity))
+  {
+  }
+
+  /// Sets `webview.on_message` to deliver the messages to this receiver.
+  /// @note A convenience with no performance benefit: every message is the `std::string` of
+  /// `on_message` plus a copy into a pooled buffer, slower than a plain `on_message` handler
+  /// (about 3x for a 100-byte message, 2x for 4 KiB).
+  auto attach(WebView& webview) -> void
+  {
+    webview.on_message = [state = _state](std::string message)
+    {
+      state->receive(message);
+    };
+  }
+
+  /// Delivers a UTF-8 message to the handler, from a pooled buffer.
+  /// @note Call on the UI thread, like the WebView handlers.
+  auto receive(std::string_view message) -> void
+  {
+    _state->receive(message);
+  }
+
+  /// Delivers a UTF-16 (UTF-32 on non-Windows) message, converted straight into a pooled buffer.
+  auto receive(std::wstring_view message) -> void
+  {
+    UBYTES_TRACE_SCOPE("MessageReceiver::receive");
+    UBYTES_TRACE_RECORD(TraceMetric::ReceiveSize, message.size() * sizeof(wchar_t));
+
+    auto buffer = _state->pool.acquire(utf8_capacity_for_utf16(message.size()));
+    auto result = details::wstring_to_utf8(message, std::span<char>(buffer.storage(), buffer.capacity()));
+    buffer.commit(result.written);
+    _state->handler(buffer);
+  }
+
+  auto pool() noexcept -> MessageBufferPool&
+  {
+    return _state->pool;
+  }
+
+private:
+  struct State
+  {
+    State(Handler handler, std::size_t max_pooled, std::size_t max_capacity)
+      : handler(std::move(handler))
+      , pool(max_pooled, max_capacity)
+    {
+    }
+
+    auto receive(std::string_view message) -> void
+    {
+      UBYTES_TRACE_SCOPE("MessageReceiver::receive");
+      UBYTES_TRACE_RECORD(TraceMetric::ReceiveSize, message.size());
+      handler(pool.acquire(message));
+    }
+
+    Handler           handler;
+    MessageBufferPool pool;
+  };
+
+  std::shared_ptr<State> _state;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/MessageBuffer.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// What a lane does with a message that does not fit.
+enum class LanePolicy
+{
+  /// The producer waits until the pump makes room.
+  Block,
+  /// The oldest queued message is dropped.
+  DropOldest,
+  /// A queued message with the same key is replaced in place (latest value wins);
+  /// messages without a match drop the oldest one when the lane is full.
+  MergeByKey,
+};
+
+/// How the messages of a lane are passed to the page.
+enum class LaneFormat
+{
+  /// `WebView::send_message`
+  Json,
+  /// `WebView::send_message_str`
+  String,
+};
+
+struct LaneSettings
+{
+  LanePolicy policy = LanePolicy::DropOldest;
+  LaneFormat format = LaneFormat::Json;
+
+  /// The maximum number of queued messages.
+  std::size_t max_messages = 1024;
+
+  /// The maximum number of queued bytes.
+  std::size_t max_bytes = 16 * 1024 * 1024;
+
+  /// How many bytes one `pump()` may send from this lane, 0 means no limit.
+  /// At least one message is sent per pump, so large messages still get through.
+  std::size_t bytes_per_pump = 0;
+};
+
+/// Per-lane counters, see `OutboundLanes::stats()`.
+struct LaneStats
+{
+  std::size_t depth     = 0;
+  std::size_t bytes     = 0;
+  std::size_t max_depth = 0;
+
+  std::size_t queued  = 0;
+  std::size_t sent    = 0;
+  std::size_t dropped = 0;
+  std::size_t merged  = 0;
+
+  /// Time spent in the queue by the sent messages.
+  std::chrono::microseconds last_latency  = {};
+  std::chrono::microseconds max_latency   = {};
+  std::chrono::microseconds total_latency = {};
+
+  auto average_latency() const noexcept -> std::chrono::microseconds
+  {
+    return sent ? total_latency / static_cast<std::chrono::microseconds::rep>(sent) : std::chrono::microseconds();
+  }
+};
+
+/// Prioritized, bounded queues of outbound messages.
+///
+/// Every lane has a priority (its index: lane 0 goes first), a bounded queue and
+/// a policy for when it is full. `pump()` sends the lanes in priority order and
+/// limits every lane to its `bytes_per_pump`, so with the pump running once per
+/// frame, a bulk lane adds at most one budget of latency to interactive lanes:
+///
+/// ```cpp
+/// auto lanes       = OutboundLanes(webview);
+/// auto interactive = lanes.add_lane({LanePolicy::MergeByKey});
+/// auto bulk        = lanes.add_lane({LanePolicy::Block, LaneFormat::String, 64, 64 << 20, 256 * 1024});
+///
+/// lanes.push(interactive, R"({"hover":12})", "hover");
+/// lanes.push(bulk, listing_chunk); // From a worker: waits while the lane is full.
+/// // Once per frame on the UI thread:
+/// lanes.pump();
+/// ```
+/// @note A single message is sent whole: split bulk transfers into chunks for the
+/// budget to take effect (see the streaming API). Pushing is thread-safe, pumping
+/// must be done from one thread (the UI thread). Merging scans the queued keys of
+/// the lane, keep merge lanes short.
+class OutboundLanes
+{
+public:
+  using Sink = std::function<void(std::string_view message, LaneFormat format)>;
+
+  enum class PushResult
+  {
+    Queued,
+    Merged,
+    /// Queued, but the oldest message of the lane was dropped to make room.
+    DroppedOldest,
+    /// Not queued: the lane does not exist, the message is larger than the lane (or `max_messages` is 0),
+    /// a full `Block` lane was pushed to from the pumping thread, or the lanes are closed.
+    Rejected,
+  };
+
+  /// Constructs lanes sending to a WebView.
+  explicit OutboundLanes(WebView& webview)
+    : OutboundLanes(
+        [&webview](std::string_view message, LaneFormat format)
+        {
+          if (format == LaneFormat::Json) {
+            webview.send_message(message);
+          }
+          else {
+            webview.send_message_str(message);
+          }
+        }
+      )
+  {
+  }
+
+  /// Constructs lanes sending to a custom sink.
+  /// @note Construct them on the pumping thread: until the first `pump()`, a full `Block` lane
+  /// pushed to from that thread is rejected instead of waiting for a pump that can't come.
+  explicit OutboundLanes(Sink sink)
+    : _sink(std::move(sink))
+    , _pump_thread(std::this_thread::get_id())
+  {
+  }
+
+  OutboundLanes(OutboundLanes const&)                    = delete;
+  auto operator=(OutboundLanes const&) -> OutboundLanes& = delete;
+
+  /// Wakes the blocked producers up, their messages are rejected, and waits for them to return.
+  ~OutboundLanes()
+  {
+    close();
+    auto lock = std::unique_lock(_mutex);
+    _idle.wait(
+      lock,
+      [this]
+      {
+        return _pushers == 0;
+      }
+    );
+  }
+
+  /// Adds a lane with a lower priority than the existing ones and returns its index.
+  /// @note Add the lanes before pushing.
+  auto add_lane(LaneSettings settings = {}) -> std::size_t
+  {
+    auto lock = std::lock_guard(_mutex);
+    _lanes.push_back(Lane{settings, {}, {}});
+    return _lanes.size() - 1;
+  }
+
+  /// Queues a message.
+  /// @param key - identifies the value for `LanePolicy::MergeByKey`.
+  auto push(std::size_t lane_index, std::string_view message, std::string_view key = {}) -> PushResult
+  {
+    auto lock   = std::unique_lock(_mutex);
+    auto pusher = Pusher(*this);
+    if (lane_index >= _lanes.size()) {
+      return PushResult::Rejected;
+    }
+    auto& lane     = _lanes[lane_index];
+    auto& settings = lane.settings;
+
+    if (_closed || message.size() > settings.max_bytes || settings.max_messages == 0) {
+      return PushResult::Rejected;
+    }
+
+    if (settings.policy == LanePolicy::MergeByKey && !key.empty()) {
+      for (std::size_t index = 0; index < lane.entries.size(); ++index) {
+        if (lane.entries[index].key != key) {
+          continue;
+        }
+        // The replacement may be larger: drop the oldest other messages until it fits.
+        // It is not larger than the lane, so it fits once alone.
+        while (lane.stats.bytes - lane.entries[index].message.size() + message.size() > settings.max_bytes) {
+          auto const oldest = index == 0 ? std::size_t(1) : std::size_t(0);
+          drop(lane, oldest);
+          index -= oldest < index ? 1 : 0;
+        }
+        auto& entry      = lane.entries[index];
+        lane.stats.bytes = lane.stats.bytes - entry.message.size() + message.size();
+        entry.message    = _pool.acquire(message);
+        ++lane.stats.queued;
+        ++lane.stats.merged;
+        return PushResult::Merged;
+      }
+    }
+
+    auto const fits = [&]
+    {
+      return lane.entries.size() < settings.max_messages && lane.stats.bytes + message.size() <= settings.max_bytes;
+    };
+
+    auto result = PushResult::Queued;
+    if (settings.policy == LanePolicy::Block) {
+      if (!fits() && std::this_thread::get_id() == _pump_thread) {
+        return PushResult::Rejected;
+      }
+      _space.wait(
+        lock,
+        [&]
+        {
+          return _closed || fits();
+        }
+      );
+      if (_closed) {
+        return PushResult::Rejected;
+      }
+    }
+    else {
+      // The lane holds at least one message of any size up to `max_bytes`, so this ends
+      // before the lane is empty.
+      while (!fits()) {
+        drop(lane, 0);
+        result = PushResult::DroppedOldest;
+      }
+    }
+
+    lane.entries.push_back(Entry{_pool.acquire(message), std::string(key), Clock::now()});
+    lane.stats.bytes += message.size();
+    lane.stats.max_depth = std::max(lane.stats.max_depth, lane.entries.size());
+    ++lane.stats.queued;
+    return result;
+  }
+
+  /// Sends the queued messages in priority order, within the per-lane budgets.
+  /// @return The number of messages sent.
+  auto pump() -> std::size_t
+  {
+    UBYTES_TRACE_SCOPE("OutboundLanes::pump");
+    _pump_thread = std::this_thread::get_id();
+
+    std::size_t sent = 0;
+    for (std::size_t index = 0; index < lane_count(); ++index) {
+      std::size_t budget_used = 0;
+      while (true) {
+        auto message = MessageBuffer();
+        auto format  = LaneFormat::Json;
+        {
+          auto  lock = std::lock_guard(_mutex);
+          auto& lane = _lanes[index];
+          if (lane.entries.empty()) {
+            break;
+          }
+
+          auto const& settings = lane.settings;
+          auto&       entry    = lane.entries.front();
+          if (settings.bytes_per_pump != 0 && budget_used != 0 &&
+              budget_used + entry.message.size() > settings.bytes_per_pump) {
+            break;
+          }
+
+          auto const latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - entry.queued);
+          lane.stats.last_latency = latency;
+          lane.stats.max_latency  = std::max(lane.stats.max_latency, latency);
+          lane.stats.total_latency += latency;
+          UBYTES_TRACE_RECORD(TraceMetric::MessageLatency, latency.count() * 1000);
+          lane.stats.bytes -= entry.message.size();
+          ++lane.stats.sent;
+
+          budget_used += entry.message.size();
+          message = std::move(entry.message);
+          format  = settings.format;
+          lane.entries.pop_front();
+        }
+
+        // Send outside of the lock, producers keep queueing meanwhile.
+        _space.notify_all();
+        UBYTES_TRACE_RECORD(TraceMetric::SendSize, message.size());
+        _sink(message.view(), format);
+        ++sent;
+      }
+    }
+    return sent;
+  }
+
+  /// Rejects further messages and wakes the blocked producers up.
+  auto close() -> void
+  {
+    {
+      auto lock = std::lock_guard(_mutex);
+      _closed   = true;
+    }
+    _space.notify_all();
+  }
+
+  auto lane_count() const -> std::size_t
+  {
+    auto lock = std::lock_guard(_mutex);
+    return _lanes.size();
+  }
+
+  /// Returns a snapshot of the counters of a lane.
+  auto stats(std::size_t lane_index) const -> LaneStats
+  {
+    auto lock  = std::lock_guard(_mutex);
+    auto stats = _lanes[lane_index].stats;
+    stats.depth = _lanes[lane_index].entries.size();
+    return stats;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry
+  {
+    MessageBuffer     message;
+    std::string       key;
+    Clock::time_point queued;
+  };
+
+  struct Lane
+  {
+    LaneSettings      settings;
+    std::deque<Entry> entries;
+    LaneStats         stats;
+  };
+
+  /// Counts a running `push()` for the destructor. Lives under the lock of the push.
+  class Pusher
+  {
+  public:
+    explicit Pusher(OutboundLanes& lanes) noexcept
+      : _lanes(lanes)
+    {
+      ++_lanes._pushers;
+    }
+
+    Pusher(Pusher const&)                    = delete;
+    auto operator=(Pusher const&) -> Pusher& = delete;
+
+    ~Pusher()
+    {
+      if (--_lanes._pushers == 0 && _lanes._closed) {
+        _lanes._idle.notify_all();
+      }
+    }
+
+  private:
+    OutboundLanes& _lanes;
+  };
+
+  /// Drops a queued message. Call under the lock.
+  static auto drop(Lane& lane, std::size_t index) -> void
+  {
+    lane.stats.bytes -= lane.entries[index].message.size();
+    lane.entries.erase(lane.entries.begin() + static_cast<std::ptrdiff_t>(index));
+    ++lane.stats.dropped;
+  }
+
+  Sink              _sink;
+  MessageBufferPool _pool;
+
+  mutable std::mutex      _mutex;
+  std::condition_variable _space;
+  std::vector<Lane>       _lanes;
+  bool                    _closed = false;
+
+  /// The running `push()` calls, waited for by the destructor on `_idle`.
+  std::size_t             _pushers = 0;
+  std::condition_variable _idle;
+
+  /// The thread of the last `pump()`, the constructing thread before.
+  std::atomic<std::thread::id> _pump_thread;
+};
+
+} // namespace app_platform
+} // namespace ubytes
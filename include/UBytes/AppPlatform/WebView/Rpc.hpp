@@ -0,0 +1,453 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/PerfectHash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+/// A method that can be called from the page, identified by its type:
+///
+/// ```cpp
+/// struct OpenArchive
+/// {
+///   static constexpr std::string_view name = "openArchive";
+/// };
+/// ```
+template <typename T>
+concept RpcMethod = requires {
+  { T::name } -> std::convertible_to<std::string_view>;
+};
+
+/// The outcome of a call made to the page.
+struct RpcResult
+{
+  /// False if the page handler failed (or the method does not exist).
+  bool ok = true;
+
+  /// The result (or the error) as a JSON value.
+  std::string_view value;
+};
+
+class RpcChannel;
+class RpcCallAwaitable;
+
+/// A call received from the page.
+/// @note The views are valid only during the handler call.
+struct RpcRequest
+{
+  RpcChannel*      channel = nullptr;
+  std::uint64_t    id      = 0;
+  std::string_view method;
+
+  /// The parameters as a JSON value (`null` if none were passed).
+  std::string_view params;
+
+  /// Sends the result (a JSON value) back to the caller.
+  auto reply(std::string_view result) const -> void;
+
+  /// Reports an error to the caller.
+  auto fail(std::string_view message) const -> void;
+};
+
+namespace details
+{
+
+/// A message of the RPC protocol, see `RpcChannel`.
+struct RpcMessage
+{
+  enum Kind
+  {
+    Request,
+    Reply,
+    Error,
+  };
+
+  Kind             kind = Request;
+  std::uint64_t    id   = 0;
+  std::string_view method;
+  std::string_view payload;
+};
+
+/// Parses a message of the RPC protocol, whatever the order of the keys and the spacing.
+/// @note The views point into `message`, or into `reader` for a method name with escape sequences.
+inline auto parse_rpc_message(JsonReader& reader, std::string_view message) -> std::optional<RpcMessage>
+{
+  // Skips the indexing of the application messages.
+  if (message.find("\"__rpc") == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  auto const root = reader.parse(message);
+  if (root.type() != JsonValue::Type::Object) {
+    return std::nullopt;
+  }
+
+  auto request = JsonValue();
+  auto reply   = JsonValue();
+  auto id      = JsonValue();
+  auto params  = JsonValue();
+  auto value   = JsonValue();
+  auto error   = JsonValue();
+  auto const well_formed = root.for_each_field(
+    [&](std::string_view key, JsonValue field)
+    {
+      if (key == "__rpc") {
+        request = field;
+      }
+      else if (key == "__rpc_reply") {
+        reply = field;
+      }
+      else if (key == "id") {
+        id = field;
+      }
+      else if (key == "params") {
+        params = field;
+      }
+      else if (key == "result") {
+        value = field;
+      }
+      else if (key == "error") {
+        error = field;
+      }
+      return true;
+    }
+  );
+  if (!well_formed) {
+    return std::nullopt;
+  }
+
+  auto result = RpcMessage();
+  if (request) {
+    auto const method = request.get_string();
+    auto const call   = id.get_uint64();
+    if (!method || !call) {
+      return std::nullopt;
+    }
+    result.kind    = RpcMessage::Request;
+    result.id      = *call;
+    result.method  = *method;
+    result.payload = params ? params.raw_json() : std::string_view("null");
+    return result;
+  }
+
+  if (reply) {
+    auto const call = reply.get_uint64();
+    if (!call) {
+      return std::nullopt;
+    }
+    result.id = *call;
+    if (error) {
+      result.kind    = RpcMessage::Error;
+      result.payload = error.raw_json();
+    }
+    else {
+      result.kind    = RpcMessage::Reply;
+      result.payload = value ? value.raw_json() : std::string_view("null");
+    }
+    return result;
+  }
+
+  return std::nullopt;
+}
+
+} // namespace details
+
+/// The transport of the RPC protocol: request/response correlation and calls to the page.
+///
+/// Messages in both directions (`js/Rpc.js` is the page side):
+///
+/// ```json
+/// {"__rpc":"<method>","id":<id>,"params":<json>}
+/// {"__rpc_reply":<id>,"result":<json>}
+/// {"__rpc_reply":<id>,"error":<json>}
+/// ```
+/// @note Not thread-safe, use from the UI thread.
+class RpcChannel
+{
+public:
+  using Sink = std::function<void(std::string_view)>;
+
+  /// Receives the outcome of a call made to the page.
+  using ReplyHandler = std::function<void(RpcResult const&)>;
+
+  /// Constructs a channel that sends through `WebView::send_message`.
+  explicit RpcChannel(WebView& webview)
+    : RpcChannel(
+        [&webview](std::string_view message)
+        {
+          webview.send_message(message);
+        }
+      )
+  {
+  }
+
+  /// Constructs a channel that sends through a custom sink.
+  explicit RpcChannel(Sink sink)
+    : _sink(std::move(sink))
+  {
+  }
+
+  RpcChannel(RpcChannel const&)                    = delete;
+  auto operator=(RpcChannel const&) -> RpcChannel& = delete;
+
+  /// Calls a method registered on the page.
+  /// @param params - a JSON value.
+  /// @param on_reply - called once the page replies.
+  /// @return The correlation id of the call.
+  auto call(std::string_view method, std::string_view params, ReplyHandler on_reply) -> std::uint64_t
+  {
+    auto const id = _next_id++;
+
+    _writer.reset();
+    _writer.begin_object();
+    _writer.field("__rpc", method);
+    _writer.field("id", id);
+    _writer.key("params").raw(params.empty() ? std::string_view("null") : params);
+    _writer.end_object();
+
+    if (id - _oldest_id >= _pending.size()) {
+      grow_pending();
+    }
+    _pending[id & (_pending.size() - 1)] = Pending{id, std::move(on_reply)};
+    ++_pending_count;
+
+    _sink(_writer.view());
+    return id;
+  }
+
+  /// Calls a method registered on the page and returns an awaitable completed with the reply:
+  ///
+  /// ```cpp
+  /// auto result = co_await rpc.call("pickColor", R"({"initial":"#fff"})");
+  /// ```
+  /// @note The coroutine is resumed inside `receive()`, the result view is valid until it suspends again.
+  auto call(std::string_view method, std::string_view params) -> RpcCallAwaitable;
+
+  /// Returns the number of calls to the page waiting for a reply.
+  auto pending_calls() const noexcept -> std::size_t
+  {
+    return _pending_count;
+  }
+
+  /// Sends the result of a call made by the page.
+  auto reply(std::uint64_t id, std::string_view result) -> void
+  {
+    _writer.reset();
+    _writer.begin_object();
+    _writer.field("__rpc_reply", id);
+    _writer.key("result").raw(result.empty() ? std::string_view("null") : result);
+    _writer.end_object();
+    _sink(_writer.view());
+  }
+
+  /// Reports an error of a call made by the page.
+  auto reply_error(std::uint64_t id, std::string_view message) -> void
+  {
+    _writer.reset();
+    _writer.begin_object();
+    _writer.field("__rpc_reply", id);
+    _writer.field("error", message);
+    _writer.end_object();
+    _sink(_writer.view());
+  }
+
+protected:
+  /// Completes a pending call. Returns false for unknown ids.
+  auto complete(std::uint64_t id, RpcResult const& result) -> bool
+  {
+    if (id < _oldest_id || id >= _next_id) {
+      return false;
+    }
+    auto const mask    = _pending.size() - 1;
+    auto&      pending = _pending[id & mask];
+    if (pending.id != id) {
+      return false;
+    }
+
+    auto handler = std::move(pending.on_reply);
+    pending.id   = 0;
+    --_pending_count;
+    while (_oldest_id < _next_id && _pending[_oldest_id & mask].id == 0) {
+      ++_oldest_id;
+    }
+    if (handler) {
+      handler(result);
+    }
+    return true;
+  }
+
+private:
+  struct Pending
+  {
+    std::uint64_t id = 0;
+    ReplyHandler  on_reply;
+  };
+
+  /// Doubles the table of the pending calls, which holds every id from `_oldest_id` on.
+  auto grow_pending() -> void
+  {
+    auto       grown = std::vector<Pending>(std::max<std::size_t>(16, _pending.size() * 2));
+    auto const mask  = grown.size() - 1;
+    for (auto& pending : _pending) {
+      if (pending.id != 0) {
+        grown[pending.id & mask] = std::move(pending);
+      }
+    }
+    _pending = std::move(grown);
+  }
+
+  Sink       _sink;
+  JsonWriter _writer;
+
+  /// The pending calls, at `id & (size - 1)`: the ids are consecutive, so the ones from
+  /// the oldest pending call on have distinct slots, and a reply is found without a scan.
+  std::uint64_t        _next_id   = 1;
+  std::uint64_t        _oldest_id = 1;
+  std::vector<Pending> _pending;
+  std::size_t          _pending_count = 0;
+};
+
+/// Awaiter returned by `RpcChannel::call(method, params)`.
+class RpcCallAwaitable
+{
+public:
+  RpcCallAwaitable(RpcChannel& channel, std::string_view method, std::string_view params) noexcept
+    : _channel(channel)
+    , _method(method)
+    , _params(params)
+  {
+  }
+
+  auto await_ready() const noexcept -> bool
+  {
+    return false;
+  }
+
+  auto await_suspend(std::coroutine_handle<> handle) -> void
+  {
+    _handle = handle;
+    _channel.call(
+      _method,
+      _params,
+      [this](RpcResult const& result)
+      {
+        _result = result;
+        _handle.resume();
+      }
+    );
+  }
+
+  auto await_resume() const noexcept -> RpcResult
+  {
+    return _result;
+  }
+
+private:
+  RpcChannel&             _channel;
+  std::string_view        _method;
+  std::string_view        _params;
+  std::coroutine_handle<> _handle;
+  RpcResult               _result;
+};
+
+inline auto RpcChannel::call(std::string_view method, std::string_view params) -> RpcCallAwaitable
+{
+  return RpcCallAwaitable(*this, method, params);
+}
+
+inline auto RpcRequest::reply(std::string_view result) const -> void
+{
+  channel->reply(id, result);
+}
+
+inline auto RpcRequest::fail(std::string_view message) const -> void
+{
+  channel->reply_error(id, message);
+}
+
+/// RPC endpoint with a fixed set of methods callable from the page.
+///
+/// The method names are known at compile time, so incoming calls are dispatched
+/// through a `PerfectHash` table: one hash lookup and one indirect call. The messages are
+/// indexed by a `JsonReader` kept by the endpoint, which stops allocating once warmed up.
+///
+/// ```cpp
+/// auto rpc = Rpc<OpenArchive, ListFiles>(webview);
+/// rpc.on<OpenArchive>([](RpcRequest const& request) {
+///   request.reply(R"({"files":12})");
+/// });
+/// webview.on_message = [&](std::string message) {
+///   rpc.receive(message);
+/// };
+/// ```
+template <RpcMethod... Methods>
+class Rpc : public RpcChannel
+{
+public:
+  using Handler = std::function<void(RpcRequest const&)>;
+
+  static constexpr auto METHODS = PerfectHash<sizeof...(Methods)>({std::string_view(Methods::name)...});
+
+  using RpcChannel::RpcChannel;
+
+  /// Sets the handler of a method.
+  template <RpcMethod M>
+  auto on(Handler handler) -> void
+  {
+    static_assert((std::is_same_v<M, Methods> || ...), "The method is not a part of this Rpc");
+    _handlers[index_of<M>()] = std::move(handler);
+  }
+
+  /// Handles a message received from the page.
+  /// @return false if it is not an RPC message.
+  auto receive(std::string_view message) -> bool
+  {
+    auto const parsed = details::parse_rpc_message(_reader, message);
+    if (!parsed) {
+      return false;
+    }
+
+    if (parsed->kind != details::RpcMessage::Request) {
+      complete(parsed->id, RpcResult{parsed->kind == details::RpcMessage::Reply, parsed->payload});
+      return true;
+    }
+
+    auto const index = METHODS.find(parsed->method);
+    if (index == METHODS.npos || !_handlers[index]) {
+      reply_error(parsed->id, "unknown method");
+      return true;
+    }
+
+    _handlers[index](RpcRequest{this, parsed->id, parsed->method, parsed->payload});
+    return true;
+  }
+
+private:
+  template <RpcMethod M>
+  static consteval auto index_of() -> std::size_t
+  {
+    return METHODS.find(M::name);
+  }
+
+  std::array<Handler, sizeof...(Methods)> _handlers;
+  JsonReader                              _reader;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,880 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cinttypes>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+class StateValue;
+
+namespace details
+{
+
+/// An immutable node of a state tree. Nodes are shared between revisions.
+struct StateNode
+{
+  using Ptr = std::shared_ptr<StateNode const>;
+
+  enum Kind
+  {
+    Null,
+    Bool,
+    Integer,
+    Number,
+    String,
+    Object,
+    Array,
+  };
+
+  Kind          kind    = Null;
+  bool          boolean = false;
+  std::int64_t  integer = 0;
+  double        number  = 0;
+  std::string   string;
+  std::uint64_t hash = 0;
+
+  /// Object fields, sorted by key.
+  std::vector<std::pair<std::string, Ptr>> fields;
+  std::vector<Ptr>                         items;
+
+  auto find(std::string_view key) const noexcept -> std::vector<std::pair<std::string, Ptr>>::const_iterator
+  {
+    auto it = std::lower_bound(
+      fields.begin(),
+      fields.end(),
+      key,
+      [](auto const& field, std::string_view k)
+      {
+        return std::string_view(field.first) < k;
+      }
+    );
+    return it != fields.end() && it->first == key ? it : fields.end();
+  }
+};
+
+inline auto state_hash_mix(std::uint64_t hash, std::uint64_t value) noexcept -> std::uint64_t
+{
+  // splitmix64 finalizer over the combined value.
+  auto x = hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+  x      = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x      = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+inline auto state_hash_bytes(std::string_view bytes) noexcept -> std::uint64_t
+{
+  auto hash = std::uint64_t(14695981039346656037ull);
+  for (auto c : bytes) {
+    hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/// Computes the hash of a node from its contents and the cached hashes of its children.
+inline auto state_rehash(StateNode& node) noexcept -> void
+{
+  auto hash = state_hash_mix(0, node.kind);
+  switch (node.kind) {
+  case StateNode::Null: break;
+  case StateNode::Bool: hash = state_hash_mix(hash, node.boolean); break;
+  case StateNode::Integer: hash = state_hash_mix(hash, static_cast<std::uint64_t>(node.integer)); break;
+  case StateNode::Number: hash = state_hash_mix(hash, std::bit_cast<std::uint64_t>(node.number)); break;
+  case StateNode::String: hash = state_hash_mix(hash, state_hash_bytes(node.string)); break;
+  case StateNode::Object:
+    for (auto const& [key, child] : node.fields) {
+      hash = state_hash_mix(state_hash_mix(hash, state_hash_bytes(key)), child->hash);
+    }
+    break;
+  case StateNode::Array:
+    for (auto const& item : node.items) {
+      hash = state_hash_mix(hash, item->hash);
+    }
+    break;
+  }
+  node.hash = hash;
+}
+
+/// Compares two nodes by contents. Shared subtrees are equal at once, different hashes
+/// tell different values apart, only the subtrees with equal hashes are compared.
+inline auto state_equal(StateNode const& a, StateNode const& b) noexcept -> bool
+{
+  if (&a == &b) {
+    return true;
+  }
+  if (a.hash != b.hash || a.kind != b.kind) {
+    return false;
+  }
+
+  switch (a.kind) {
+  case StateNode::Null: return true;
+  case StateNode::Bool: return a.boolean == b.boolean;
+  case StateNode::Integer: return a.integer == b.integer;
+  // Bitwise, like the hash: NaN equals NaN, 0.0 and -0.0 differ.
+  case StateNode::Number: return std::bit_cast<std::uint64_t>(a.number) == std::bit_cast<std::uint64_t>(b.number);
+  case StateNode::String: return a.string == b.string;
+  case StateNode::Object:
+    if (a.fields.size() != b.fields.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < a.fields.size(); ++i) {
+      if (a.fields[i].first != b.fields[i].first || !state_equal(*a.fields[i].second, *b.fields[i].second)) {
+        return false;
+      }
+    }
+    return true;
+  case StateNode::Array:
+    if (a.items.size() != b.items.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < a.items.size(); ++i) {
+      if (!state_equal(*a.items[i], *b.items[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+/// Appends a JSON pointer segment (RFC 6901 escaping).
+inline auto state_append_segment(std::string& path, std::string_view segment) -> void
+{
+  path.push_back('/');
+  for (auto c : segment) {
+    if (c == '~') {
+      path.append("~0");
+    }
+    else if (c == '/') {
+      path.append("~1");
+    }
+    else {
+      path.push_back(c);
+    }
+  }
+}
+
+/// Splits the first segment off a JSON pointer and unescapes it.
+inline auto state_next_segment(std::string_view& pointer, std::string& segment) -> bool
+{
+  if (pointer.empty() || pointer.front() != '/') {
+    return false;
+  }
+  pointer.remove_prefix(1);
+
+  auto const end = std::min(pointer.find('/'), pointer.size());
+  segment.clear();
+  for (std::size_t i = 0; i < end; ++i) {
+    if (pointer[i] == '~' && i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+      segment.push_back(pointer[++i] == '0' ? '~' : '/');
+    }
+    else {
+      segment.push_back(pointer[i]);
+    }
+  }
+  pointer.remove_prefix(end);
+  return true;
+}
+
+inline auto state_parse_index(std::string_view segment, std::size_t& index) noexcept -> bool
+{
+  auto const [end, error] = std::from_chars(segment.data(), segment.data() + segment.size(), index);
+  return error == std::errc() && end == segment.data() + segment.size() && !segment.empty();
+}
+
+} // namespace details
+
+/// An immutable JSON-like value of a `StateStore`.
+///
+/// Copies are cheap (one reference count) and subtrees are shared: changing a
+/// value in a store copies only the path from the root to the change.
+class StateValue
+{
+public:
+  /// Constructs `null`.
+  StateValue()
+  {
+    static auto const null = finish(create(details::StateNode::Null));
+    _node                  = null;
+  }
+
+  StateValue(std::nullptr_t)
+    : StateValue()
+  {
+  }
+
+  StateValue(bool value)
+  {
+    auto node     = create(details::StateNode::Bool);
+    node->boolean = value;
+    _node         = finish(std::move(node));
+  }
+
+  template <typename T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+  StateValue(T value)
+  {
+    auto node     = create(details::StateNode::Integer);
+    node->integer = static_cast<std::int64_t>(value);
+    _node         = finish(std::move(node));
+  }
+
+  StateValue(double value)
+  {
+    auto node    = create(details::StateNode::Number);
+    node->number = value;
+    _node        = finish(std::move(node));
+  }
+
+  StateValue(std::string_view value)
+  {
+    auto node    = create(details::StateNode::String);
+    node->string = value;
+    _node        = finish(std::move(node));
+  }
+
+  StateValue(char const* value)
+    : StateValue(std::string_view(value))
+  {
+  }
+
+  /// Constructs an object. Later duplicate keys win.
+  static auto object(std::initializer_list<std::pair<std::string_view, StateValue>> fields = {}) -> StateValue
+  {
+    auto node = create(details::StateNode::Object);
+    for (auto const& [key, value] : fields) {
+      insert_field(*node, key, value._node);
+    }
+    return StateValue(finish(std::move(node)));
+  }
+
+  /// Constructs an array.
+  static auto array(std::initializer_list<StateValue> items = {}) -> StateValue
+  {
+    return array_of(items);
+  }
+
+  /// Constructs an array from a range, converting every element to `StateValue`.
+  template <typename Range>
+  static auto array_of(Range const& range) -> StateValue
+  {
+    auto node = create(details::StateNode::Array);
+    for (auto const& item : range) {
+      node->items.push_back(StateValue(item)._node);
+    }
+    return StateValue(finish(std::move(node)));
+  }
+
+  auto is_null() const noexcept -> bool
+  {
+    return _node->kind == details::StateNode::Null;
+  }
+
+  auto is_object() const noexcept -> bool
+  {
+    return _node->kind == details::StateNode::Object;
+  }
+
+  auto is_array() const noexcept -> bool
+  {
+    return _node->kind == details::StateNode::Array;
+  }
+
+  /// Returns the number of fields or items (0 for scalars).
+  auto size() const noexcept -> std::size_t
+  {
+    return is_object() ? _node->fields.size() : _node->items.size();
+  }
+
+  /// Returns a field of an object, or `null`.
+  auto operator[](std::string_view key) const -> StateValue
+  {
+    if (is_object()) {
+      if (auto it = _node->find(key); it != _node->fields.end()) {
+        return StateValue(it->second);
+      }
+    }
+    return StateValue();
+  }
+
+  /// Returns an item of an array, or `null`.
+  auto at(std::size_t index) const -> StateValue
+  {
+    return is_array() && index < _node->items.size() ? StateValue(_node->items[index]) : StateValue();
+  }
+
+  /// Returns the content hash, equal for equal values.
+  auto hash() const noexcept -> std::uint64_t
+  {
+    return _node->hash;
+  }
+
+  /// Returns true if both values are the same shared node (no comparison of contents).
+  auto same(StateValue const& other) const noexcept -> bool
+  {
+    return _node == other._node;
+  }
+
+  auto write(JsonWriter& writer) const -> void
+  {
+    write(writer, *_node);
+  }
+
+private:
+  friend class StateStore;
+
+  using Ptr = details::StateNode::Ptr;
+
+  explicit StateValue(Ptr node) noexcept
+    : _node(std::move(node))
+  {
+  }
+
+  static auto create(details::StateNode::Kind kind) -> std::shared_ptr<details::StateNode>
+  {
+    auto node  = std::make_shared<details::StateNode>();
+    node->kind = kind;
+    return node;
+  }
+
+  static auto finish(std::shared_ptr<details::StateNode> node) noexcept -> Ptr
+  {
+    details::state_rehash(*node);
+    return node;
+  }
+
+  static auto insert_field(details::StateNode& node, std::string_view key, Ptr value) -> void
+  {
+    auto it = std::lower_bound(
+      node.fields.begin(),
+      node.fields.end(),
+      key,
+      [](auto const& field, std::string_view k)
+      {
+        return std::string_view(field.first) < k;
+      }
+    );
+    if (it != node.fields.end() && it->first == key) {
+      it->second = std::move(value);
+    }
+    else {
+      node.fields.emplace(it, std::string(key), std::move(value));
+    }
+  }
+
+  static auto write(JsonWriter& writer, details::StateNode const& node) -> void
+  {
+    switch (node.kind) {
+    case details::StateNode::Null: writer.null(); break;
+    case details::StateNode::Bool: writer.value(node.boolean); break;
+    case details::StateNode::Integer: writer.value(node.integer); break;
+    case details::StateNode::Number: writer.value(node.number); break;
+    case details::StateNode::String: writer.value(std::string_view(node.string)); break;
+    case details::StateNode::Object:
+      writer.begin_object();
+      for (auto const& [key, child] : node.fields) {
+        writer.key(key);
+        write(writer, *child);
+      }
+      writer.end_object();
+      break;
+    case details::StateNode::Array:
+      writer.begin_array();
+      for (auto const& item : node.items) {
+        write(writer, *item);
+      }
+      writer.end_array();
+      break;
+    }
+  }
+
+  Ptr _node;
+};
+
+struct StateStoreSettings
+{
+  /// Send a full snapshot instead of a patch every this many flushes, 0 means never.
+  std::size_t snapshot_interval = 0;
+};
+
+/// Mirrors a C++ state tree in the page, sending only what changed.
+///
+/// The store keeps the current tree and the tree the page last received. Both
+/// share their unchanged subtrees, so `flush()` skips them by pointer (and values
+/// that were rebuilt but are equal by hash, then contents) and sends only what changed.
+///
+/// The work is not that small: `set()` and `remove()` copy every object and array on the
+/// path to the change, with all their fields or items, and rehash them, and `flush()`
+/// compares the items of a changed array from both ends. Changing one row of a flat array
+/// of `n` rows costs O(n) on both sides (about 30 µs for 1000 rows, 300 µs for 10000),
+/// so keep large collections nested, e.g. in pages of a few hundred rows.
+///
+/// Arrays are aligned on their longest common subsequence of items, so inserting or
+/// removing an item sends one operation instead of rewriting the items after it.
+///
+/// Messages (the page side is `js/StateStore.js`):
+///
+/// ```json
+/// {"__state":"snapshot","rev":<n>,"value":<json>}
+/// {"__state":"patch","rev":<n>,"ops":[{"op":"replace","path":"/a/0","value":<json>},{"op":"remove","path":"/b"}]}
+/// ```
+///
+/// The page answers a patch it cannot apply (e.g. a missed revision) with
+/// `{"__state":"resync"}`, pass it to `receive()` to send a snapshot.
+///
+/// ```cpp
+/// store.set("/selection", StateValue::array({1, 4, 9}));
+/// store.set("/archives/3/name", "textures.pak");
+/// store.flush(); // Once per frame.
+/// ```
+/// @note Paths are JSON pointers and the nesting depth is limited by `JsonWriter::MAX_DEPTH`.
+/// Not thread-safe, use from the UI thread.
+class StateStore
+{
+public:
+  static constexpr std::string_view STATE_KEY = "__state";
+
+  using Sink = std::function<void(std::string_view)>;
+
+  struct Stats
+  {
+    std::size_t patches   = 0;
+    std::size_t snapshots = 0;
+    std::size_t ops       = 0;
+    /// Rebuilt subtrees skipped because they were equal (same hash, then same contents).
+    std::size_t hash_skips = 0;
+  };
+
+  /// Constructs a store sending to a WebView.
+  explicit StateStore(WebView& webview, StateStoreSettings settings = {})
+    : StateStore(
+        [&webview](std::string_view message)
+        {
+          webview.send_message(message);
+        },
+        settings
+      )
+  {
+  }
+
+  /// Constructs a store sending to a custom sink.
+  explicit StateStore(Sink sink, StateStoreSettings settings = {})
+    : _sink(std::move(sink))
+    , _settings(settings)
+    , _current(StateValue::object())
+  {
+  }
+
+  StateStore(StateStore const&)                    = delete;
+  auto operator=(StateStore const&) -> StateStore& = delete;
+
+  /// Returns the current state.
+  auto state() const noexcept -> StateValue const&
+  {
+    return _current;
+  }
+
+  /// Replaces the value at `pointer` (an empty pointer replaces the root).
+  /// The last segment may name a new object field, `-` appends to an array; the objects
+  /// and arrays above it must exist.
+  /// @return false if a parent does not exist or the path is invalid.
+  auto set(std::string_view pointer, StateValue value) -> bool
+  {
+    auto updated = update(_current._node, pointer, &value._node);
+    if (!updated) {
+      return false;
+    }
+    _current._node = std::move(updated);
+    return true;
+  }
+
+  /// Removes an object field or an array item.
+  auto remove(std::string_view pointer) -> bool
+  {
+    if (pointer.empty()) {
+      return false;
+    }
+    auto updated = update(_current._node, pointer, nullptr);
+    if (!updated) {
+      return false;
+    }
+    _current._node = std::move(updated);
+    return true;
+  }
+
+  /// Sends the changes since the last flush (as a patch or a periodic snapshot).
+  auto flush() -> void
+  {
+    if (!_sent) {
+      send_snapshot();
+      return;
+    }
+    if (details::state_equal(*_current._node, *_sent->_node)) {
+      return;
+    }
+    if (_settings.snapshot_interval != 0 && ++_since_snapshot >= _settings.snapshot_interval) {
+      send_snapshot();
+      return;
+    }
+
+    ++_revision;
+    _writer.reset();
+    _writer.begin_object();
+    _writer.field(STATE_KEY, "patch");
+    _writer.field("rev", _revision);
+    _writer.key("ops").begin_array();
+    _path.clear();
+    diff(*_sent->_node, *_current._node);
+    _writer.end_array();
+    _writer.end_object();
+
+    _sent = _current;
+    ++_stats.patches;
+    _sink(_writer.view());
+  }
+
+  /// Sends the whole state.
+  auto send_snapshot() -> void
+  {
+    ++_revision;
+    _since_snapshot = 0;
+    _writer.reset();
+    _writer.begin_object();
+    _writer.field(STATE_KEY, "snapshot");
+    _writer.field("rev", _revision);
+    _writer.key("value");
+    _current.write(_writer);
+    _writer.end_object();
+
+    _sent = _current;
+    ++_stats.snapshots;
+    _sink(_writer.view());
+  }
+
+  /// Handles a message from the page.
+  /// @return true if it was a resync request (answered with a snapshot).
+  auto receive(std::string_view message) -> bool
+  {
+    // Skips the indexing of the application messages.
+    if (message.find("\"__state\"") == std::string_view::npos) {
+      return false;
+    }
+    if (_reader.parse(message)[STATE_KEY].get_string() != "resync") {
+      return false;
+    }
+    send_snapshot();
+    return true;
+  }
+
+  auto revision() const noexcept -> std::uint64_t
+  {
+    return _revision;
+  }
+
+  auto stats() const noexcept -> Stats const&
+  {
+    return _stats;
+  }
+
+private:
+  using Node = details::StateNode;
+  using Ptr  = Node::Ptr;
+
+  /// The largest table of `align_items()`, e.g. 256 items before and after a change.
+  static constexpr std::size_t MAX_ALIGN_CELLS = 64 * 1024;
+
+  /// Returns a copy of `node` with the change applied (path copying), or null on failure.
+  /// @param value - null to remove.
+  static auto update(Ptr const& node, std::string_view pointer, Ptr const* value) -> Ptr
+  {
+    if (pointer.empty()) {
+      return value ? *value : nullptr;
+    }
+
+    auto segment = std::string();
+    if (!details::state_next_segment(pointer, segment)) {
+      return nullptr;
+    }
+    auto const leaf = pointer.empty();
+
+    if (node->kind == Node::Object) {
+      auto copy = std::make_shared<Node>(*node);
+      auto it   = std::lower_bound(
+        copy->fields.begin(),
+        copy->fields.end(),
+        segment,
+        [](auto const& field, std::string const& k)
+        {
+          return field.first < k;
+        }
+      );
+      auto const found = it != copy->fields.end() && it->first == segment;
+
+      if (leaf && !value) {
+        if (!found) {
+          return nullptr;
+        }
+        copy->fields.erase(it);
+      }
+      else if (leaf) {
+        if (found) {
+          it->second = *value;
+        }
+        else {
+          copy->fields.emplace(it, std::move(segment), *value);
+        }
+      }
+      else {
+        if (!found) {
+          return nullptr;
+        }
+        auto child = update(it->second, pointer, value);
+        if (!child) {
+          return nullptr;
+        }
+        it->second = std::move(child);
+      }
+      details::state_rehash(*copy);
+      return copy;
+    }
+
+    if (node->kind == Node::Array) {
+      auto copy  = std::make_shared<Node>(*node);
+      auto index = std::size_t(0);
+      if (leaf && value && segment == "-") {
+        copy->items.push_back(*value);
+      }
+      else if (!details::state_parse_index(segment, index) || index >= copy->items.size()) {
+        return nullptr;
+      }
+      else if (leaf && !value) {
+        copy->items.erase(copy->items.begin() + static_cast<std::ptrdiff_t>(index));
+      }
+      else if (leaf) {
+        copy->items[index] = *value;
+      }
+      else {
+        auto child = update(copy->items[index], pointer, value);
+        if (!child) {
+          return nullptr;
+        }
+        copy->items[index] = std::move(child);
+      }
+      details::state_rehash(*copy);
+      return copy;
+    }
+
+    return nullptr;
+  }
+
+  auto write_op(std::string_view op, Node const* value) -> void
+  {
+    _writer.begin_object();
+    _writer.field("op", op);
+    _writer.field("path", std::string_view(_path));
+    if (value) {
+      _writer.key("value");
+      StateValue::write(_writer, *value);
+    }
+    _writer.end_object();
+    ++_stats.ops;
+  }
+
+  /// Writes the operations turning `before` into `after`, skipping shared and equal subtrees.
+  auto diff(Node const& before, Node const& after) -> void
+  {
+    if (&before == &after) {
+      return;
+    }
+    if (details::state_equal(before, after)) {
+      ++_stats.hash_skips;
+      return;
+    }
+
+    auto const length = _path.size();
+
+    if (before.kind == Node::Object && after.kind == Node::Object) {
+      // Merge the sorted field lists.
+      auto b = before.fields.begin();
+      auto a = after.fields.begin();
+      while (b != before.fields.end() || a != after.fields.end()) {
+        if (a == after.fields.end() || (b != before.fields.end() && b->first < a->first)) {
+          details::state_append_segment(_path, b->first);
+          write_op("remove", nullptr);
+          ++b;
+        }
+        else if (b == before.fields.end() || a->first < b->first) {
+          details::state_append_segment(_path, a->first);
+          write_op("add", a->second.get());
+          ++a;
+        }
+        else {
+          details::state_append_segment(_path, a->first);
+          diff(*b->second, *a->second);
+          ++a;
+          ++b;
+        }
+        _path.resize(length);
+      }
+      return;
+    }
+
+    if (before.kind == Node::Array && after.kind == Node::Array) {
+      diff_items(before.items, after.items);
+      return;
+    }
+
+    write_op("replace", &after);
+  }
+
+  /// Writes the operations turning the items `before` into `after`.
+  ///
+  /// The items are aligned on their longest common subsequence (by hash), after the common
+  /// prefix and suffix are cut off. The aligned items are diffed, which checks the contents,
+  /// and so are the items of a gap between two aligned ones, by position; the rest of a gap
+  /// is added or removed. The operations apply in order, so the index of the current item
+  /// in the patched array is its index in `after`.
+  auto diff_items(std::vector<Ptr> const& before, std::vector<Ptr> const& after) -> void
+  {
+    auto const length = _path.size();
+    auto const alike  = [](Ptr const& b, Ptr const& a)
+    {
+      return b == a || b->hash == a->hash;
+    };
+
+    auto const common = std::min(before.size(), after.size());
+    auto       prefix = std::size_t(0);
+    while (prefix < common && alike(before[prefix], after[prefix])) {
+      ++prefix;
+    }
+    auto suffix = std::size_t(0);
+    while (suffix < common - prefix && alike(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+      ++suffix;
+    }
+    auto const before_end = before.size() - suffix;
+    auto const after_end  = after.size() - suffix;
+
+    // The aligned items of the middle part, then the start of the suffix.
+    auto aligned = align_items(before, after, prefix, before_end, after_end);
+    aligned.emplace_back(before_end, after_end);
+
+    auto b = std::size_t(0);
+    auto a = std::size_t(0);
+    for (auto const& [next_b, next_a] : aligned) {
+      while (b < next_b && a < next_a) {
+        append_index(a);
+        diff(*before[b++], *after[a++]);
+        _path.resize(length);
+      }
+      while (a < next_a) {
+        append_index(a);
+        write_op("add", after[a++].get());
+        _path.resize(length);
+      }
+      while (b < next_b) {
+        append_index(a);
+        write_op("remove", nullptr);
+        _path.resize(length);
+        ++b;
+      }
+    }
+    while (a < after.size()) {
+      append_index(a);
+      diff(*before[b++], *after[a++]);
+      _path.resize(length);
+    }
+  }
+
+  /// Returns the pairs of indices of the longest common subsequence of the items in
+  /// `[begin, before_end)` and `[begin, after_end)`, compared by hash.
+  /// Parts too large for the table are not aligned, their items are diffed by position.
+  auto align_items(
+    std::vector<Ptr> const& before,
+    std::vector<Ptr> const& after,
+    std::size_t             begin,
+    std::size_t             before_end,
+    std::size_t             after_end
+  ) -> std::vector<std::pair<std::size_t, std::size_t>>
+  {
+    auto       aligned = std::vector<std::pair<std::size_t, std::size_t>>();
+    auto const rows    = before_end - begin;
+    auto const columns = after_end - begin;
+    if (rows == 0 || columns == 0 || (rows + 1) * (columns + 1) > MAX_ALIGN_CELLS) {
+      return aligned;
+    }
+
+    // lengths[i][j]: the length of the common subsequence of the items from `i` and `j` on.
+    auto const stride = columns + 1;
+    _lengths.assign((rows + 1) * stride, 0);
+    for (auto i = rows; i-- > 0;) {
+      for (auto j = columns; j-- > 0;) {
+        auto const& b = before[begin + i];
+        auto const& a = after[begin + j];
+        _lengths[i * stride + j] = b == a || b->hash == a->hash
+          ? _lengths[(i + 1) * stride + j + 1] + 1
+          : std::max(_lengths[(i + 1) * stride + j], _lengths[i * stride + j + 1]);
+      }
+    }
+
+    auto i = std::size_t(0);
+    auto j = std::size_t(0);
+    while (i < rows && j < columns) {
+      auto const& b = before[begin + i];
+      auto const& a = after[begin + j];
+      if (b == a || b->hash == a->hash) {
+        aligned.emplace_back(begin + i++, begin + j++);
+      }
+      else if (_lengths[(i + 1) * stride + j] >= _lengths[i * stride + j + 1]) {
+        ++i;
+      }
+      else {
+        ++j;
+      }
+    }
+    return aligned;
+  }
+
+  auto append_index(std::size_t index) -> void
+  {
+    char digits[24];
+    auto [end, error] = std::to_chars(digits, digits + sizeof(digits), index);
+    _path.push_back('/');
+    _path.append(digits, end);
+  }
+
+  Sink               _sink;
+  StateStoreSettings _settings;
+  Stats              _stats;
+
+  StateValue                _current;
+  std::optional<StateValue> _sent;
+  std::uint64_t             _revision       = 0;
+  std::size_t               _since_snapshot = 0;
+
+  JsonReader  _reader;
+  JsonWriter  _writer;
+  std::string _path;
+
+  /// The table of `align_items()`, kept between flushes.
+  std::vector<std::uint32_t> _lengths;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Core/JsonReader.hpp>
+#include <UBytes/AppPlatform/Core/JsonWriter.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+struct StreamSettings
+{
+  /// The maximum size of a chunk of text.
+  std::size_t chunk_size = 64 * 1024;
+
+  /// The size of the first chunk, smaller so the page can start rendering early.
+  std::size_t first_chunk_size = 4 * 1024;
+
+  /// How many chunks may be sent before the page acknowledges them.
+  std::size_t window = 4;
+};
+
+/// The producing end of a stream, see `StreamSender`.
+class StreamWriter
+{
+public:
+  using Sink = std::function<void(std::string_view)>;
+
+  /// Produces the contents: write while `writable()`, then return; call `end()` when done.
+  using Generator = std::function<void(StreamWriter&)>;
+
+  StreamWriter(StreamWriter const&)                    = delete;
+  auto operator=(StreamWriter const&) -> StreamWriter& = delete;
+
+  auto id() const noexcept -> std::string_view
+  {
+    return _id;
+  }
+
+  /// Determines whether more text can be written without growing the buffer past a chunk.
+  /// Full chunks are sent while the window is open, so this turns false once the window
+  /// is closed and the next chunk is filled.
+  auto writable() const noexcept -> bool
+  {
+    return _state == State::Open && _pending.size() < chunk_limit();
+  }
+
+  /// Appends text (UTF-8) to the stream. Full chunks are sent as the window allows.
+  /// @note Text written past `writable()` is buffered: keep the writes smaller than a chunk.
+  auto write(std::string_view text) -> void
+  {
+    if (_state != State::Open) {
+      return;
+    }
+    _pending += text;
+    _bytes_written += text.size();
+    send_ready(false);
+  }
+
+  /// Sends the buffered text now, even if it is less than a chunk (if the window allows).
+  auto flush() -> void
+  {
+    send_ready(true);
+  }
+
+  /// Finishes the stream once the buffered text is sent.
+  auto end() -> void
+  {
+    if (_state == State::Open) {
+      _state = State::Ending;
+      send_ready(true);
+    }
+  }
+
+  auto finished() const noexcept -> bool
+  {
+    return _state == State::Finished || _state == State::Cancelled;
+  }
+
+  /// Determines whether the page or the sender cancelled the stream.
+  auto cancelled() const noexcept -> bool
+  {
+    return _state == State::Cancelled;
+  }
+
+  auto bytes_written() const noexcept -> std::uint64_t
+  {
+    return _bytes_written;
+  }
+
+  auto chunks_sent() const noexcept -> std::uint64_t
+  {
+    return _next_seq;
+  }
+
+  /// The number of bytes waiting for the window to open.
+  auto buffered() const noexcept -> std::size_t
+  {
+    return _pending.size();
+  }
+
+private:
+  friend class StreamSender;
+
+  enum class State
+  {
+    Open,
+    Ending,
+    Finished,
+    Cancelled,
+  };
+
+  StreamWriter(std::string_view id, Generator generator, StreamSettings settings, Sink const& sink, JsonWriter& writer)
+    : _id(id)
+    , _generator(std::move(generator))
+    , _settings(settings)
+    , _sink(&sink)
+    , _writer(&writer)
+  {
+    _settings.chunk_size       = std::max<std::size_t>(_settings.chunk_size, 4);
+    _settings.first_chunk_size = std::clamp<std::size_t>(_settings.first_chunk_size, 4, _settings.chunk_size);
+    _settings.window           = std::max<std::size_t>(_settings.window, 1);
+  }
+
+  auto chunk_limit() const noexcept -> std::size_t
+  {
+    return _next_seq == 0 ? _settings.first_chunk_size : _settings.chunk_size;
+  }
+
+  auto free_window() const noexcept -> std::size_t
+  {
+    return _settings.window - static_cast<std::size_t>(_next_seq - _acked);
+  }
+
+  /// Calls the generator while the stream can take more text.
+  auto generate() -> void
+  {
+    while (_generator && writable()) {
+      auto const before = _bytes_written;
+      _generator(*this);
+      if (_bytes_written == before && _state == State::Open) {
+        // No progress: wait for the next acknowledgement.
+        break;
+      }
+    }
+  }
+
+  auto acknowledge(std::uint64_t seq) -> void
+  {
+    if (seq < _next_seq) {
+      _acked = std::max(_acked, seq + 1);
+    }
+    send_ready(false);
+    generate();
+  }
+
+  auto cancel(bool notify) -> void
+  {
+    if (finished()) {
+      return;
+    }
+    if (notify) {
+      send_frame({}, true, true);
+    }
+    _state = State::Cancelled;
+    _pending.clear();
+    _pending.shrink_to_fit();
+  }
+
+  /// Sends the full chunks (and the partial one when `force`) while the window is open.
+  auto send_ready(bool force) -> void
+  {
+    auto const ending = _state == State::Ending;
+    while (free_window() > 0 && (_state == State::Open || _state == State::Ending)) {
+      auto const limit = chunk_limit();
+      if (_pending.size() >= limit || (!_pending.empty() && (force || ending))) {
+        auto const size = chunk_boundary(limit);
+        send_frame(std::string_view(_pending).substr(0, size), false, false);
+        _pending.erase(0, size);
+      }
+      else if (ending) {
+        send_frame({}, true, false);
+        _state = State::Finished;
+        _pending.shrink_to_fit();
+      }
+      else {
+        break;
+      }
+    }
+  }
+
+  /// Returns the size of the next chunk, not splitting UTF-8 sequences (every chunk is valid text).
+  auto chunk_boundary(std::size_t limit) const noexcept -> std::size_t
+  {
+    if (_pending.size() <= limit) {
+      return _pending.size();
+    }
+    auto size = limit;
+    while (size > 0 && (static_cast<unsigned char>(_pending[size]) & 0xC0) == 0x80) {
+      --size;
+    }
+    return size > 0 ? size : limit;
+  }
+
+  auto send_frame(std::string_view data, bool end, bool cancelled) -> void
+  {
+    _writer->reset();
+    _writer->begin_object();
+    _writer->field("__stream", std::string_view(_id));
+    _writer->field("seq", _next_seq);
+    if (end) {
+      _writer->field("end", true);
+      if (cancelled) {
+        _writer->field("cancelled", true);
+      }
+    }
+    else {
+      _writer->field("data", data);
+    }
+    _writer->end_object();
+    ++_next_seq;
+    UBYTES_TRACE_RECORD(TraceMetric::SendSize, _writer->view().size());
+    (*_sink)(_writer->view());
+  }
+
+  std::string    _id;
+  Generator      _generator;
+  StreamSettings _settings;
+  Sink const*    _sink;
+  JsonWriter*    _writer;
+
+  State         _state = State::Open;
+  std::string   _pending;
+  std::uint64_t _next_seq      = 0;
+  std::uint64_t _acked         = 0;
+  std::uint64_t _bytes_written = 0;
+};
+
+/// Sends large text payloads to the page in bounded, flow-controlled chunks.
+///
+/// The text is framed into chunks of at most `chunk_size` bytes:
+///
+/// ```json
+/// {"__stream":"<id>","seq":0,"data":"<text>"}
+/// {"__stream":"<id>","seq":7,"end":true}
+/// ```
+/// and at most `window` chunks are in flight: the page acknowledges every chunk
+/// once it has processed it (`{"__stream":"<id>","ack":<seq>}`), which lets the
+/// generator produce the next ones. The memory used is bounded by the window,
+/// not by the payload, and the page renders the first rows while the rest is
+/// still being produced:
+///
+/// ```cpp
+/// auto streams = StreamSender(webview);
+/// streams.begin_stream(
+///   "listing",
+///   [&archive, row = std::size_t(0)](StreamWriter& out) mutable
+///   {
+///     while (out.writable() && row < archive.size()) {
+///       out.write(archive.row_json(row++));
+///       out.write("\n");
+///     }
+///     if (row == archive.size()) {
+///       out.end();
+///     }
+///   }
+/// );
+/// // In the message handler:
+/// if (streams.receive(message)) { return; }
+/// ```
+/// See `js/Stream.js` for the page side.
+/// @note Not thread-safe, use from the UI thread.
+class StreamSender
+{
+public:
+  static constexpr std::string_view STREAM_KEY = "__stream";
+
+  using Sink      = StreamWriter::Sink;
+  using Generator = StreamWriter::Generator;
+
+  /// Constructs a sender sending to a WebView.
+  explicit StreamSender(WebView& webview)
+    : StreamSender(
+        [&webview](std::string_view message)
+        {
+          webview.send_message(message);
+        }
+      )
+  {
+  }
+
+  /// Constructs a sender sending to a custom sink.
+  explicit StreamSender(Sink sink)
+    : _sink(std::move(sink))
+  {
+  }
+
+  StreamSender(StreamSender const&)                    = delete;
+  auto operator=(StreamSender const&) -> StreamSender& = delete;
+
+  /// Starts a stream. Without a generator, write to the returned writer directly.
+  /// A running stream with the same id is cancelled.
+  /// @note The writer is valid until the stream finishes (see `active()`).
+  auto begin_stream(std::string_view id, Generator generator = {}, StreamSettings settings = {}) -> StreamWriter&
+  {
+    cancel(id);
+
+    auto stream = std::unique_ptr<StreamWriter>(new StreamWriter(id, std::move(generator), settings, _sink, _writer));
+    auto& writer = *stream;
+    _streams.push_back(std::move(stream));
+
+    writer.generate();
+    return writer;
+  }
+
+  /// Handles a message from the page.
+  /// @return true if it was a stream message.
+  auto receive(std::string_view message) -> bool
+  {
+    if (message.find(STREAM_KEY) == std::string_view::npos) {
+      return false;
+    }
+
+    auto const root = _reader.parse(message);
+    auto const id   = root[STREAM_KEY].get_string();
+    if (!id) {
+      return false;
+    }
+
+    if (auto* stream = find(*id)) {
+      if (root["cancel"].get_bool().value_or(false)) {
+        stream->cancel(false);
+      }
+      else if (auto const ack = root["ack"].get_uint64()) {
+        stream->acknowledge(*ack);
+      }
+    }
+    collect();
+    return true;
+  }
+
+  /// Cancels a stream, the page is notified.
+  auto cancel(std::string_view id) -> void
+  {
+    if (auto* stream = find(id)) {
+      stream->cancel(true);
+    }
+    collect();
+  }
+
+  /// Returns the number of streams that are not finished yet.
+  auto active() const noexcept -> std::size_t
+  {
+    return _streams.size();
+  }
+
+private:
+  auto find(std::string_view id) -> StreamWriter*
+  {
+    for (auto& stream : _streams) {
+      if (stream->id() == id && !stream->finished()) {
+        return stream.get();
+      }
+    }
+    return nullptr;
+  }
+
+  /// Removes the finished streams.
+  auto collect() -> void
+  {
+    std::erase_if(
+      _streams,
+      [](auto const& stream)
+      {
+        return stream->finished();
+      }
+    );
+  }
+
+  Sink       _sink;
+  JsonWriter _writer;
+  JsonReader _reader;
+
+  std::vector<std::unique_ptr<StreamWriter>> _streams;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <UBytes/AppPlatform/WebView.hpp>
+#include <UBytes/AppPlatform/Window.hpp>
+#include <UBytes/AppPlatform/App/TaskPool.hpp>
+#include <UBytes/AppPlatform/App/UiQueue.hpp>
+#include <UBytes/AppPlatform/Core/Trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ubytes
+{
+namespace app_platform
+{
+
+struct WebViewPoolSettings
+{
+  /// The number of WebViews kept set up and waiting.
+  std::size_t size = 1;
+
+  /// The memory the waiting WebViews may use, 0 for no limit. Lowers `size` if needed.
+  std::size_t memory_limit = 0;
+
+  /// An estimate of the memory a WebView uses with a blank page (the backends don't report
+  /// it): the renderer process and the browser-side objects.
+  std::size_t webview_memory = 64 * 1024 * 1024;
+
+  /// Sets up a replacement after each `acquire()`, once no window is waiting for a WebView.
+  /// Otherwise the pool is only filled by `fill()`.
+  bool refill = true;
+
+  /// The settings of the pooled WebViews.
+  WebViewSettings webview = {};
+};
+
+struct WebViewPoolStats
+{
+  /// The number of WebViews set up by the pool.
+  std::uint64_t created = 0;
+  /// The number of `acquire()` calls.
+  std::uint64_t acquired = 0;
+  /// The acquires served at once, by a WebView that was ready.
+  std::uint64_t ready_hits = 0;
+  /// The acquires that waited for a WebView whose setup had already started.
+  std::uint64_t warming_hits = 0;
+  /// The acquires that had to start a setup.
+  std::uint64_t misses = 0;
+  /// The waiting WebViews destroyed by `trim()`.
+  std::uint64_t trimmed = 0;
+
+  /// The time-to-ready: from `acquire()` to the handler call, summed and at most.
+  std::chrono::nanoseconds total_wait = {};
+  std::chrono::nanoseconds max_wait   = {};
+};
+
+/// Sets up WebViews ahead of time, in a hidden parking window, and hands them to new
+/// windows through `WebView::set_parent_window()`.
+///
+/// Between `begin_setup()` and `on_ready` a backend creates a browser environment and a
+/// renderer, which takes long enough to be seen when a window opens. With a WebView ready
+/// in the pool, opening a window costs a re-parenting instead:
+///
+/// ```cpp
+/// attach_ui_queue_to_message_loop(); // Once, the waiting acquires and the refills are `UiQueue` tasks.
+/// auto pool = WebViewPool(parking_window, WebViewPoolSettings{.size = 2});
+/// pool.fill();
+///
+/// // Later, to open a tool window:
+/// pool.acquire(
+///   tool_window,
+///   [&](std::unique_ptr<WebView> webview)
+///   {
+///     webview->on_message = ...;
+///     webview->set_bounds(tool_bounds);
+///     webview->navigate("https://app.local/tool.html");
+///   }
+/// );
+/// ```
+///
+/// The handler is called with a ready WebView: right away if one was waiting in the pool,
+/// otherwise from a `UiQueue` task once the next one is ready. The WebView is the caller's
+/// from then on, with no handlers set. An acquire can be cancelled until then, e.g. when
+/// the window is closed before its WebView is ready. The pool refills itself after an
+/// acquire, but not while windows are waiting for a WebView, so the replacements don't
+/// delay them.
+/// @note Use from the UI thread, whose loop drains the queue (see `App/UiQueueMessageLoop.hpp`):
+/// otherwise the acquires that wait are never served and the pool never refills. The
+/// parking window must outlive the pool, and should stay hidden (or the WebViews have empty
+/// bounds there).
+class WebViewPool
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Ready = std::function<void(std::unique_ptr<WebView> webview)>;
+
+  explicit WebViewPool(WindowHandle parking, WebViewPoolSettings settings = {}, UiQueue& queue = ui_queue())
+    : _parking(parking)
+    , _settings(std::move(settings))
+    , _queue(queue)
+    , _alive(std::make_shared<WebViewPool*>(this))
+  {
+  }
+
+  explicit WebViewPool(Window const& parking, WebViewPoolSettings settings = {}, UiQueue& queue = ui_queue())
+    : WebViewPool(parking.handle(), std::move(settings), queue)
+  {
+  }
+
+  WebViewPool(WebViewPool const&)                    = delete;
+  auto operator=(WebViewPool const&) -> WebViewPool& = delete;
+
+  /// Destroys the waiting WebViews. The handlers of pending acquires are not called.
+  ~WebViewPool() = default;
+
+  /// Returns the number of WebViews the pool keeps: `size`, lowered to fit `memory_limit`.
+  auto capacity() const noexcept -> std::size_t
+  {
+    if (_settings.memory_limit == 0 || _settings.webview_memory == 0) {
+      return _settings.size;
+    }
+    return std::min(_settings.size, _settings.memory_limit / _settings.webview_memory);
+  }
+
+  /// Starts setting up WebViews until the pool holds `capacity()` of them, e.g. at startup
+  /// once the main window is shown, or when the application is idle.
+  auto fill() -> void
+  {
+    while (unclaimed() < capacity()) {
+      start_setup();
+    }
+  }
+
+  /// Calls `ready` with a ready WebView, parented to `window`.
+  /// @return Cancels the acquire if `ready` has not been called yet: the WebView stays in the pool.
+  auto acquire(WindowHandle window, Ready ready) -> CancellationSource
+  {
+    UBYTES_TRACE_SCOPE("WebViewPool::acquire");
+    ++_stats.acquired;
+    auto cancel  = CancellationSource();
+    auto request = Request{window, std::move(ready), Clock::now(), cancel.token()};
+
+    drop_cancelled();
+    if (!_ready.empty() && _waiting.empty()) {
+      ++_stats.ready_hits;
+      auto webview = std::move(_ready.front());
+      _ready.pop_front();
+      schedule_refill();
+      hand_out(std::move(webview), std::move(request));
+      return cancel;
+    }
+
+    if (unclaimed() > 0) {
+      ++_stats.warming_hits;
+    }
+    else {
+      ++_stats.misses;
+      start_setup();
+    }
+    _waiting.push_back(std::move(request));
+    schedule_refill();
+    return cancel;
+  }
+
+  auto acquire(Window const& window, Ready ready) -> CancellationSource
+  {
+    return acquire(window.handle(), std::move(ready));
+  }
+
+  /// Destroys ready WebViews until at most `keep` are left, e.g. on low memory.
+  /// The WebViews being set up are kept, and so are the ready ones promised to waiting acquires.
+  auto trim(std::size_t keep = 0) -> void
+  {
+    auto const claimed = std::min(_ready.size(), waiting());
+    while (_ready.size() > claimed + keep) {
+      _ready.pop_back();
+      ++_stats.trimmed;
+    }
+  }
+
+  /// Returns the number of WebViews that are ready and waiting.
+  auto ready_count() const noexcept -> std::size_t
+  {
+    return _ready.size();
+  }
+
+  /// Returns the number of WebViews being set up, including the ones acquired already.
+  auto warming_count() const noexcept -> std::size_t
+  {
+    return _warming.size();
+  }
+
+  /// Returns the number of acquires waiting for a WebView.
+  auto waiting_count() const noexcept -> std::size_t
+  {
+    return waiting();
+  }
+
+  auto settings() const noexcept -> WebViewPoolSettings const&
+  {
+    return _settings;
+  }
+
+  /// Changes the settings. A smaller capacity takes effect with `trim(capacity())`.
+  auto set_settings(WebViewPoolSettings settings) -> void
+  {
+    _settings = std::move(settings);
+  }
+
+  auto stats() const noexcept -> WebViewPoolStats
+  {
+    return _stats;
+  }
+
+  auto reset_stats() noexcept -> void
+  {
+    _stats = WebViewPoolStats();
+  }
+
+private:
+  struct Request
+  {
+    WindowHandle      window;
+    Ready             ready;
+    Clock::time_point time;
+    CancellationToken cancelled;
+  };
+
+  /// Returns the number of acquires waiting and not cancelled.
+  auto waiting() const noexcept -> std::size_t
+  {
+    return static_cast<std::size_t>(std::count_if(
+      _waiting.begin(),
+      _waiting.end(),
+      [](Request const& request)
+      {
+        return !request.cancelled.is_cancelled();
+      }
+    ));
+  }
+
+  auto drop_cancelled() -> void
+  {
+    std::erase_if(
+      _waiting,
+      [](Request const& request)
+      {
+        return request.cancelled.is_cancelled();
+      }
+    );
+  }
+
+  /// Returns the number of WebViews in the pool not promised to a waiting acquire.
+  auto unclaimed() const noexcept -> std::size_t
+  {
+    // Clamped: wrapping around would make `fill()` set up WebViews forever.
+    auto const pooled  = _ready.size() + _warming.size();
+    auto const claimed = waiting();
+    return pooled > claimed ? pooled - claimed : 0;
+  }
+
+  auto start_setup() -> void
+  {
+    UBYTES_TRACE_SCOPE("WebViewPool::start_setup");
+    ++_stats.created;
+    auto  webview = std::make_unique<WebView>();
+    auto* raw     = webview.get();
+    // The WebView cannot move during the setup, it stays in its `unique_ptr`.
+    webview->on_ready = [alive = std::weak_ptr<WebViewPool*>(_alive), raw]
+    {
+      if (auto self = alive.lock()) {
+        (*self)->on_setup_finished(raw);
+      }
+    };
+    _warming.push_back(std::move(webview));
+    raw->begin_setup(_parking, _settings.webview);
+  }
+
+  /// Called from the `on_ready` handler of `webview`. The WebView goes to `_ready`, and is
+  /// handed out from a `UiQueue` task: the handler must not be replaced while it runs.
+  auto on_setup_finished(WebView* webview) -> void
+  {
+    auto const it = std::find_if(
+      _warming.begin(),
+      _warming.end(),
+      [webview](std::unique_ptr<WebView> const& warming)
+      {
+        return warming.get() == webview;
+      }
+    );
+    if (it == _warming.end()) {
+      return;
+    }
+    _ready.push_back(std::move(*it));
+    _warming.erase(it);
+    if (!_waiting.empty()) {
+      _queue.post(
+        [alive = std::weak_ptr<WebViewPool*>(_alive)]
+        {
+          if (auto self = alive.lock()) {
+            (*self)->serve_waiting();
+          }
+        }
+      );
+    }
+  }
+
+  /// Hands the ready WebViews to the waiting acquires, in order.
+  auto serve_waiting() -> void
+  {
+    drop_cancelled();
+    while (!_ready.empty() && !_waiting.empty()) {
+      auto webview = std::move(_ready.front());
+      _ready.pop_front();
+      auto request = std::move(_waiting.front());
+      _waiting.pop_front();
+      hand_out(std::move(webview), std::move(request));
+      drop_cancelled();
+    }
+    if (_waiting.empty() && _refill_delayed) {
+      _refill_delayed = false;
+      schedule_refill();
+    }
+  }
+
+  auto hand_out(std::unique_ptr<WebView> webview, Request request) -> void
+  {
+    webview->on_ready = nullptr;
+    if (request.window.handle != _parking.handle) {
+      webview->set_parent_window(request.window);
+    }
+
+    auto const wait = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - request.time);
+    _stats.total_wait += wait;
+    _stats.max_wait    = std::max(_stats.max_wait, wait);
+    request.ready(std::move(webview));
+  }
+
+  /// Refills from a `UiQueue` task, after the handlers of the current batch ran.
+  auto schedule_refill() -> void
+  {
+    if (!_settings.refill || _refill_posted) {
+      return;
+    }
+    _refill_posted = true;
+    _queue.post(
+      [alive = std::weak_ptr<WebViewPool*>(_alive)]
+      {
+        if (auto self = alive.lock()) {
+          (*self)->refill();
+        }
+      }
+    );
+  }
+
+  auto refill() -> void
+  {
+    _refill_posted = false;
+    // The setups of the waiting windows go first.
+    if (waiting() > 0) {
+      _refill_delayed = true;
+      return;
+    }
+    fill();
+  }
+
+  WindowHandle        _parking;
+  WebViewPoolSettings _settings;
+  UiQueue&            _queue;
+
+  std::deque<std::unique_ptr<WebView>>  _ready;
+  std::vector<std::unique_ptr<WebView>> _warming;
+  std::deque<Request>                   _waiting;
+  bool                                  _refill_posted  = false;
+  bool                                  _refill_delayed = false;
+  WebViewPoolStats                      _stats;
+
+  /// Expires with the pool, so that the setups and refills still queued do nothing.
+  std::shared_ptr<WebViewPool*> _alive;
+};
+
+} // namespace app_platform
+} // namespace ubytes
@@ -0,0 +1,69 @@
+// Page side of `ubytes::app_platform::BinaryChannel`.
+//
+// Usage:
+//
+//   import { listenForBinary, sendBinary } from "./BinaryChannel.js";
+//
+//   listenForBinary((tag, bytes) => {
+//     // `bytes` is a Uint8Array
+//   });
+//
+//   sendBinary("thumbnail", new Uint8Array([1, 2, 3]));
+
+export const BINARY_KEY = "__binary";
+
+function decodeBase64(text) {
+  if (Uint8Array.fromBase64) {
+    return Uint8Array.fromBase64(text);
+  }
+  const binary = atob(text);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; ++i) {
+    bytes[i] = binary.charCodeAt(i);
+  }
+  return bytes;
+}
+
+function encodeBase64(bytes) {
+  if (bytes.toBase64) {
+    return bytes.toBase64();
+  }
+  let binary = "";
+  const chunk = 0x8000;
+  for (let i = 0; i < bytes.length; i += chunk) {
+    binary += String.fromCharCode.apply(null, bytes.subarray(i, i + chunk));
+  }
+  return btoa(binary);
+}
+
+/// Returns true if `data` (a received message) is a base64 binary payload.
+export function isBinaryMessage(data) {
+  return data !== null && typeof data === "object" && typeof data[BINARY_KEY] === "string" && typeof data.data === "string";
+}
+
+/// Subscribes to binary payloads, both base64 messages and shared buffers.
+/// Returns a function that removes the listeners.
+export function listenForBinary(handler, target = window.chrome.webview) {
+  const onMessage = (event) => {
+    if (isBinaryMessage(event.data)) {
+      handler(event.data[BINARY_KEY], decodeBase64(event.data.data));
+    }
+  };
+  const onSharedBuffer = (event) => {
+    const meta = event.additionalData;
+    if (meta && typeof meta[BINARY_KEY] === "string") {
+      handler(meta[BINARY_KEY], new Uint8Array(event.getBuffer(), 0, meta.size));
+    }
+  };
+  target.addEventListener("message", onMessage);
+  target.addEventListener("sharedbufferreceived", onSharedBuffer);
+  return () => {
+    target.removeEventListener("message", onMessage);
+    target.removeEventListener("sharedbufferreceived", onSharedBuffer);
+  };
+}
+
+/// Sends a binary payload to the native side (`BinaryChannel::receive`).
+export function sendBinary(tag, bytes, target = window.chrome.webview) {
+  target.postMessage({ [BINARY_KEY]: tag, data: encodeBase64(bytes) });
+}
@@ -0,0 +1,200 @@
+// Page side of `ubytes::app_platform::ImageSender`.
+//
+// Usage:
+//
+//   import { ImageReceiver } from "./ImageTransfer.js";
+//
+//   const images = new ImageReceiver();
+//   images.attach("texture", document.querySelector("#texture"), {
+//     onProgress: (sent, tiles) => progressBar.value = sent / tiles,
+//     onComplete: () => spinner.hidden = true,
+//   });
+//
+// Tiles are drawn as they arrive. A downscaled preview of the whole image comes
+// first and is drawn stretched, unless full resolution tiles are already there.
+
+import { listenForBinary } from "./BinaryChannel.js";
+
+export const IMAGE_TAG_PREFIX = "image:";
+export const IMAGE_MAGIC = 0x4d494255; // "UBIM"
+export const IMAGE_HEADER_SIZE = 40;
+
+export const ImageCodec = Object.freeze({ Raw: 0, Qoi: 1 });
+export const IMAGE_TILE_PREVIEW = 1 << 0;
+
+/// Parses the header of a tile (`ImageTileHeader`). Returns null if it is not one.
+export function parseImageTileHeader(bytes) {
+  if (bytes.length < IMAGE_HEADER_SIZE) {
+    return null;
+  }
+  const view = new DataView(bytes.buffer, bytes.byteOffset, IMAGE_HEADER_SIZE);
+  if (view.getUint32(0, true) !== IMAGE_MAGIC) {
+    return null;
+  }
+  return {
+    codec: view.getUint8(4),
+    flags: view.getUint8(5),
+    scale: view.getUint16(6, true),
+    frame: view.getUint32(8, true),
+    imageWidth: view.getUint32(12, true),
+    imageHeight: view.getUint32(16, true),
+    x: view.getUint32(20, true),
+    y: view.getUint32(24, true),
+    width: view.getUint32(28, true),
+    height: view.getUint32(32, true),
+    tiles: view.getUint32(36, true),
+  };
+}
+
+/// Decodes QOI data (without the file header and end marker) into `out`, a
+/// Uint8ClampedArray or Uint8Array of RGBA bytes. Returns false if the data is malformed.
+export function decodeQoi(data, out) {
+  const index = new Uint8Array(64 * 4);
+  let r = 0, g = 0, b = 0, a = 255;
+  let p = 0;
+  let i = 0;
+  while (i < out.length) {
+    if (p >= data.length) {
+      return false;
+    }
+    const op = data[p++];
+    if (op === 0xfe) {
+      if (p + 3 > data.length) return false;
+      r = data[p]; g = data[p + 1]; b = data[p + 2];
+      p += 3;
+    } else if (op === 0xff) {
+      if (p + 4 > data.length) return false;
+      r = data[p]; g = data[p + 1]; b = data[p + 2]; a = data[p + 3];
+      p += 4;
+    } else {
+      switch (op >> 6) {
+        case 0: {
+          const at = op * 4;
+          r = index[at]; g = index[at + 1]; b = index[at + 2]; a = index[at + 3];
+          break;
+        }
+        case 1:
+          r = (r + ((op >> 4) & 3) - 2) & 0xff;
+          g = (g + ((op >> 2) & 3) - 2) & 0xff;
+          b = (b + (op & 3) - 2) & 0xff;
+          break;
+        case 2: {
+          if (p >= data.length) return false;
+          const second = data[p++];
+          const dg = (op & 0x3f) - 32;
+          r = (r + dg - 8 + (second >> 4)) & 0xff;
+          g = (g + dg) & 0xff;
+          b = (b + dg - 8 + (second & 0x0f)) & 0xff;
+          break;
+        }
+        default: {
+          const end = i + ((op & 0x3f) + 1) * 4;
+          if (end > out.length) return false;
+          for (; i < end; i += 4) {
+            out[i] = r; out[i + 1] = g; out[i + 2] = b; out[i + 3] = a;
+          }
+          continue;
+        }
+      }
+    }
+    const at = ((r * 3 + g * 5 + b * 7 + a * 11) % 64) * 4;
+    index[at] = r; index[at + 1] = g; index[at + 2] = b; index[at + 3] = a;
+    out[i] = r; out[i + 1] = g; out[i + 2] = b; out[i + 3] = a;
+    i += 4;
+  }
+  return true;
+}
+
+/// Decodes a tile into RGBA bytes. Returns `{ header, pixels }`, or null if the tile is malformed.
+export function decodeImageTile(bytes) {
+  const header = parseImageTileHeader(bytes);
+  if (!header) {
+    return null;
+  }
+  const data = bytes.subarray(IMAGE_HEADER_SIZE);
+  const pixels = new Uint8ClampedArray(header.width * header.height * 4);
+  if (header.codec === ImageCodec.Raw) {
+    if (data.length !== pixels.length) {
+      return null;
+    }
+    pixels.set(data);
+  } else if (header.codec !== ImageCodec.Qoi || !decodeQoi(data, pixels)) {
+    return null;
+  }
+  return { header, pixels };
+}
+
+export class ImageReceiver {
+  constructor(target = window.chrome.webview) {
+    this.images = new Map();
+    this.stop = listenForBinary((tag, bytes) => this.receive(tag, bytes), target);
+  }
+
+  /// Draws the image `id` into `canvas`, resizing it to the image size. Optional handlers:
+  /// - `onProgress(sent, tiles)` - called after every full resolution tile,
+  /// - `onComplete()` - called once all the tiles of a frame are drawn.
+  attach(id, canvas, handlers = {}) {
+    this.images.set(id, { canvas, context: canvas.getContext("2d"), handlers, frame: 0, drawn: 0 });
+  }
+
+  detach(id) {
+    this.images.delete(id);
+  }
+
+  /// Stops listening for tiles.
+  close() {
+    this.stop();
+    this.images.clear();
+  }
+
+  /// Handles a binary payload. Returns false if it is not an image tile.
+  receive(tag, bytes) {
+    if (!tag.startsWith(IMAGE_TAG_PREFIX)) {
+      return false;
+    }
+    const image = this.images.get(tag.slice(IMAGE_TAG_PREFIX.length));
+    if (!image) {
+      return true;
+    }
+    const tile = decodeImageTile(bytes);
+    if (!tile) {
+      return true;
+    }
+
+    const { header, pixels } = tile;
+    if (header.frame < image.frame) {
+      return true; // A tile of an older send, encoded before it was cancelled.
+    }
+    if (header.frame > image.frame) {
+      image.frame = header.frame;
+      image.drawn = 0;
+      if (image.canvas.width !== header.imageWidth || image.canvas.height !== header.imageHeight) {
+        image.canvas.width = header.imageWidth;
+        image.canvas.height = header.imageHeight;
+      }
+    }
+
+    const data = new ImageData(pixels, header.width, header.height);
+    if (header.flags & IMAGE_TILE_PREVIEW) {
+      if (image.drawn === 0) {
+        this.#drawPreview(image, header, data);
+      }
+      return true;
+    }
+
+    image.context.putImageData(data, header.x, header.y);
+    image.drawn += 1;
+    image.handlers.onProgress?.(image.drawn, header.tiles);
+    if (image.drawn === header.tiles) {
+      image.handlers.onComplete?.();
+    }
+    return true;
+  }
+
+  #drawPreview(image, header, data) {
+    const canvas = new OffscreenCanvas(header.width, header.height);
+    canvas.getContext("2d").putImageData(data, 0, 0);
+    image.context.imageSmoothingEnabled = true;
+    image.context.drawImage(canvas, 0, 0, header.width * header.scale, header.height * header.scale);
+  }
+}
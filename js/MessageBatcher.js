@@ -0,0 +1,32 @@
+// Unpacks the payloads sent by `ubytes::app_platform::MessageBatcher`.
+//
+// Usage:
+//
+//   import { listenForMessages } from "./MessageBatcher.js";
+//
+//   listenForMessages((message) => {
+//     // called once for every message, in the order they were sent
+//   });
+
+export const BATCH_KEY = "__batch";
+
+/// Calls `handler` for every message contained in `data`,
+/// which is either a batch or a single message. The native side wraps a message
+/// that has the batch key itself in a batch, so it is not unpacked here.
+export function unpackMessages(data, handler) {
+  if (data !== null && typeof data === "object" && Array.isArray(data[BATCH_KEY])) {
+    for (const message of data[BATCH_KEY]) {
+      handler(message);
+    }
+    return;
+  }
+  handler(data);
+}
+
+/// Subscribes to the messages sent by the native side (WebView2).
+/// Returns a function that removes the listener.
+export function listenForMessages(handler, target = window.chrome.webview) {
+  const listener = (event) => unpackMessages(event.data, handler);
+  target.addEventListener("message", listener);
+  return () => target.removeEventListener("message", listener);
+}
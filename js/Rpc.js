@@ -0,0 +1,78 @@
+// Page side of `ubytes::app_platform::Rpc`.
+//
+// Usage:
+//
+//   import { Rpc } from "./Rpc.js";
+//
+//   const rpc = new Rpc();
+//   const files = await rpc.call("listFiles", { path: "/" });
+//   rpc.handle("alert", (text) => window.alert(text));
+
+export class Rpc {
+  constructor(target = window.chrome.webview) {
+    this.target = target;
+    this.nextId = 1;
+    this.pending = new Map();
+    this.handlers = new Map();
+    this.listener = (event) => this.receive(event.data);
+    target.addEventListener("message", this.listener);
+  }
+
+  /// Calls a native method, returns a promise of its result.
+  call(method, params) {
+    const id = this.nextId++;
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { resolve, reject });
+      this.target.postMessage({ __rpc: method, id, params });
+    });
+  }
+
+  /// Registers a method callable from the native side.
+  /// The handler may return a value or a promise.
+  handle(method, handler) {
+    this.handlers.set(method, handler);
+  }
+
+  /// Handles a received message, returns false if it is not an RPC message.
+  /// Call it yourself when the messages are unpacked elsewhere (e.g. batches).
+  receive(data) {
+    if (data === null || typeof data !== "object") {
+      return false;
+    }
+
+    if ("__rpc_reply" in data) {
+      const call = this.pending.get(data.__rpc_reply);
+      if (call) {
+        this.pending.delete(data.__rpc_reply);
+        if ("error" in data) {
+          call.reject(data.error);
+        } else {
+          call.resolve(data.result);
+        }
+      }
+      return true;
+    }
+
+    if ("__rpc" in data) {
+      const handler = this.handlers.get(data.__rpc);
+      const reply = (payload) => this.target.postMessage({ __rpc_reply: data.id, ...payload });
+      if (!handler) {
+        reply({ error: "unknown method" });
+        return true;
+      }
+      Promise.resolve()
+        .then(() => handler(data.params))
+        .then(
+          (result) => reply({ result }),
+          (error) => reply({ error: String(error) })
+        );
+      return true;
+    }
+
+    return false;
+  }
+
+  dispose() {
+    this.target.removeEventListener("message", this.listener);
+  }
+}
@@ -0,0 +1,109 @@
+// Mirrors the state sent by `ubytes::app_platform::StateStore`.
+//
+// Usage:
+//
+//   import { StateMirror } from "./StateStore.js";
+//
+//   const mirror = new StateMirror((state) => render(state));
+//   window.chrome.webview.addEventListener("message", (event) => mirror.receive(event.data));
+
+export const STATE_KEY = "__state";
+
+function decodeSegment(segment) {
+  return segment.replace(/~1/g, "/").replace(/~0/g, "~");
+}
+
+/// Applies JSON Patch "add", "remove" and "replace" operations to `state`, in place.
+/// Returns the new root (a root "replace" swaps it), or `undefined` if an operation failed.
+export function applyPatch(state, ops) {
+  for (const op of ops) {
+    if (op.path === "") {
+      if (op.op === "remove") {
+        return undefined;
+      }
+      state = op.value;
+      continue;
+    }
+
+    const segments = op.path.slice(1).split("/").map(decodeSegment);
+    const last = segments.pop();
+
+    let parent = state;
+    for (const segment of segments) {
+      parent = parent?.[Array.isArray(parent) ? Number(segment) : segment];
+    }
+    if (parent === null || typeof parent !== "object") {
+      return undefined;
+    }
+
+    if (Array.isArray(parent)) {
+      const index = last === "-" ? parent.length : Number(last);
+      if (op.op === "add") {
+        parent.splice(index, 0, op.value);
+      } else if (op.op === "remove") {
+        parent.splice(index, 1);
+      } else {
+        parent[index] = op.value;
+      }
+    } else if (op.op === "remove") {
+      delete parent[last];
+    } else {
+      parent[last] = op.value;
+    }
+  }
+  return state;
+}
+
+/// Keeps a copy of the native state up to date and asks for a snapshot when
+/// a patch cannot be applied (e.g. a revision was missed).
+export class StateMirror {
+  constructor(onChange, target = window.chrome.webview) {
+    this.state = undefined;
+    this.revision = 0;
+    // True from a resync request to the snapshot that answers it.
+    this.resyncing = false;
+    this.onChange = onChange;
+    this.target = target;
+  }
+
+  /// Handles a message from the native side.
+  /// Returns false if it is not a state message.
+  receive(message) {
+    if (message === null || typeof message !== "object" || !(STATE_KEY in message)) {
+      return false;
+    }
+
+    if (message[STATE_KEY] === "snapshot") {
+      this.state = message.value;
+      this.revision = message.rev;
+      this.resyncing = false;
+      this.onChange?.(this.state);
+      return true;
+    }
+
+    if (this.state === undefined || message.rev !== this.revision + 1) {
+      this.resync();
+      return true;
+    }
+
+    const state = applyPatch(this.state, message.ops);
+    if (state === undefined) {
+      this.resync();
+      return true;
+    }
+    this.state = state;
+    this.revision = message.rev;
+    this.onChange?.(this.state);
+    return true;
+  }
+
+  /// Asks for a snapshot, once: the patches until it arrives are ignored.
+  resync() {
+    this.state = undefined;
+    if (this.resyncing) {
+      return;
+    }
+    this.resyncing = true;
+    this.target.postMessage({ [STATE_KEY]: "resync" });
+  }
+}
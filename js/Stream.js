@@ -0,0 +1,107 @@
+// Page side of `ubytes::app_platform::StreamSender`.
+//
+// Usage:
+//
+//   import { StreamReceiver } from "./Stream.js";
+//
+//   const streams = new StreamReceiver();
+//   streams.listen("listing", {
+//     onLine: (line) => appendRow(JSON.parse(line)),
+//     onEnd: (cancelled) => finishListing(cancelled),
+//   });
+//   window.chrome.webview.addEventListener("message", (event) => streams.receive(event.data));
+//
+// Every chunk is acknowledged once its handlers return (or the promise they
+// return settles), so the native side never runs more than a few chunks ahead.
+
+export const STREAM_KEY = "__stream";
+
+export class StreamReceiver {
+  constructor(target = window.chrome.webview) {
+    this.target = target;
+    this.streams = new Map();
+  }
+
+  /// Registers the handlers of a stream, before it is started:
+  /// - `onChunk(text)` - called with every chunk,
+  /// - `onLine(line)` - called with every complete line (for newline-delimited data),
+  /// - `onEnd(cancelled)` - called once the stream is finished.
+  /// A chunk handler that throws (or rejects) cancels the stream, `onEnd(true)` is called.
+  /// Returns a function that cancels the stream.
+  listen(id, handlers) {
+    this.streams.set(id, { handlers, carry: "", seq: 0, queue: Promise.resolve() });
+    return () => this.cancel(id);
+  }
+
+  /// Asks the native side to stop sending a stream.
+  cancel(id) {
+    if (this.streams.delete(id)) {
+      this.target.postMessage({ [STREAM_KEY]: id, cancel: true });
+    }
+  }
+
+  /// Handles a message from the native side.
+  /// Returns false if it is not a stream message.
+  receive(message) {
+    if (message === null || typeof message !== "object" || typeof message[STREAM_KEY] !== "string") {
+      return false;
+    }
+
+    const id = message[STREAM_KEY];
+    const stream = this.streams.get(id);
+    if (!stream) {
+      if (!message.end) {
+        this.target.postMessage({ [STREAM_KEY]: id, cancel: true });
+      }
+      return true;
+    }
+
+    // Chunks are handled one after another, even if a handler is asynchronous.
+    stream.queue = stream.queue.then(() => this.#handle(id, stream, message));
+    return true;
+  }
+
+  async #handle(id, stream, message) {
+    if (this.streams.get(id) !== stream || message.seq !== stream.seq) {
+      return;
+    }
+    ++stream.seq;
+
+    const { handlers } = stream;
+    if (message.end) {
+      this.streams.delete(id);
+      if (stream.carry !== "" && !message.cancelled) {
+        await handlers.onLine?.(stream.carry);
+      }
+      await handlers.onEnd?.(Boolean(message.cancelled));
+      return;
+    }
+
+    try {
+      await handlers.onChunk?.(message.data);
+      if (handlers.onLine) {
+        const lines = (stream.carry + message.data).split("\n");
+        stream.carry = lines.pop();
+        for (const line of lines) {
+          // Only wait for asynchronous handlers, a microtask per row adds up.
+          const result = handlers.onLine(line);
+          if (result instanceof Promise) {
+            await result;
+          }
+        }
+      }
+    } catch (error) {
+      // A failed chunk ends the stream on both sides, the native writer would wait for an ack.
+      if (this.streams.get(id) === stream) {
+        this.cancel(id);
+        await handlers.onEnd?.(true);
+      }
+      console.error(error);
+      return;
+    }
+
+    if (this.streams.get(id) === stream) {
+      this.target.postMessage({ [STREAM_KEY]: id, ack: message.seq });
+    }
+  }
+}
@@ -0,0 +1,75 @@
+// Page side of `ubytes::app_platform::Tracer`: records spans, instants and counters
+// as trace events and sends them to the native side, which merges them into its export.
+//
+// Usage:
+//
+//   import { PageTracer } from "./Trace.js";
+//
+//   const tracer = new PageTracer();
+//   tracer.span("render rows", () => renderRows(rows));
+//   tracer.counter("rows", rows.length);
+//   tracer.flush(); // e.g. every second or when the native side exports the trace
+//
+// Timestamps are in microseconds since the Unix epoch, like the native events.
+
+export const TRACE_KEY = "__trace";
+
+/// The process id of the page events, the native events use 1.
+const PAGE_PID = 2;
+
+function timestamp() {
+  return (performance.timeOrigin + performance.now()) * 1000;
+}
+
+export class PageTracer {
+  constructor(target = window.chrome.webview, maxEvents = 10000) {
+    this.target = target;
+    this.maxEvents = maxEvents;
+    this.events = [{ name: "process_name", ph: "M", pid: PAGE_PID, tid: 1, args: { name: "page" } }];
+    this.dropped = 0;
+  }
+
+  /// Runs `fn` and records its duration. Promises are traced until they settle.
+  span(name, fn) {
+    const start = timestamp();
+    const finish = () => this.#push({ name, ph: "X", ts: start, dur: timestamp() - start });
+    let result;
+    try {
+      result = fn();
+    } catch (error) {
+      finish();
+      throw error;
+    }
+    if (result instanceof Promise) {
+      return result.finally(finish);
+    }
+    finish();
+    return result;
+  }
+
+  instant(name) {
+    this.#push({ name, ph: "i", s: "t", ts: timestamp() });
+  }
+
+  counter(name, value) {
+    this.#push({ name, ph: "C", ts: timestamp(), args: { value } });
+  }
+
+  /// Sends the recorded events to the native side.
+  flush() {
+    if (this.events.length > 0) {
+      this.target.postMessage({ [TRACE_KEY]: this.events });
+      this.events = [];
+    }
+  }
+
+  #push(event) {
+    if (this.events.length >= this.maxEvents) {
+      ++this.dropped;
+      return;
+    }
+    event.pid = PAGE_PID;
+    event.tid = 1;
+    this.events.push(event);
+  }
+}